@@ -32,7 +32,6 @@
 
 #include <kdebug.h>
 #include <klocale.h>
-#include <qregexp.h>
 
 Expression::Expression( PIC14 *pic, Microbe *master, SourceLine sourceLine, bool suppressNumberTooBig )
 	: m_sourceLine(sourceLine)
@@ -40,6 +39,7 @@ Expression::Expression( PIC14 *pic, Microbe *master, SourceLine sourceLine, bool
 	m_pic = pic;
 	mb = master;
 	m_bSupressNumberTooBig = suppressNumberTooBig;
+	m_tokenPos = 0;
 }
 
 Expression::~Expression()
@@ -254,214 +254,309 @@ void Expression::doOp( Operation op, BTreeNode *left, BTreeNode *right )
 	}
 }
 
-void Expression::buildTree( const QString & unstrippedExpression, BTreeBase *tree, BTreeNode *node, int level )
+/**
+ * @return whether the character can be part of a variable name, number or pin,
+ * in which case it can't be next to a word operator such as AND.
+ */
+static bool isWordChar( const QChar & c )
 {
-	int firstEnd = 0;
-	int secondStart = 0;
-	bool unary = false;
-	Operation op = noop;
-	QString expression = stripBrackets( unstrippedExpression );
-	switch(level)
+	return c.isLetterOrNumber() || c == '_' || c == '.';
+}
+
+
+/**
+ * @return the word operator (AND, OR, XOR or NOT) starting at pos, or noop.
+ */
+static Expression::Operation wordOperator( const QString & expr, int pos, int * length )
+{
+	static const struct { const char * word; Expression::Operation op; } words[] = {
+		{ "AND", Expression::bwand },
+		{ "OR", Expression::bwor },
+		{ "XOR", Expression::bwxor },
+		{ "NOT", Expression::bwnot }
+	};
+	
+	if ( pos > 0 && isWordChar( expr[pos-1] ) )
+		return Expression::noop;
+	
+	for ( unsigned i = 0; i < sizeof(words)/sizeof(words[0]); ++i )
 	{
-		// ==, !=
-		case 0:
-		{
-		int equpos = findSkipBrackets(expression, "==");
-		int neqpos = findSkipBrackets(expression, "!=");
-		if( equpos != -1 )
-		{
-			op = equals;
-			firstEnd = equpos;
-			secondStart = equpos + 2;
-		}
-		else if( neqpos != -1 )
-		{
-			op = notequals;
-			firstEnd = neqpos;
-			secondStart = neqpos + 2;
-		}
-		else op = noop;
-		break;
-		}
+		const int wordLength = qstrlen( words[i].word );
+		const int end = pos + wordLength;
+		if ( expr.midRef( pos, wordLength ) != QLatin1String( words[i].word ) )
+			continue;
+		if ( end < expr.length() && isWordChar( expr[end] ) )
+			continue;
+		
+		*length = wordLength;
+		return words[i].op;
+	}
+	return Expression::noop;
+}
 
-		// <, <=, >=, >
-		case 1:
-		{
-		int ltpos = findSkipBrackets(expression, "<");
-		int lepos = findSkipBrackets(expression, "<=");
-		int gepos = findSkipBrackets(expression, ">=");
-		int gtpos = findSkipBrackets(expression, ">");
-		// Note: if (for example) "<=" is present, "<" will also be present. This
-		// means that we have to check for "<=" before "<", etc.
-		if( lepos != -1 )
-		{
-			op = le;
-			firstEnd = lepos;
-			secondStart = lepos + 2;
-		}
-		else if( gepos != -1 )
-		{
-			op = ge;
-			firstEnd = gepos;
-			secondStart = gepos + 2;
-		}
-		else if( ltpos != -1 )
-		{
-			op = lt;
-			firstEnd = ltpos;
-			secondStart = ltpos + 1;
-		}
-		else if( gtpos != -1 )
-		{
-			op = gt;
-			firstEnd = gtpos;
-			secondStart = gtpos + 1;
-		}
-		else op = noop;
-		break;
-		}
 
-		// +,-
-		case 2:
-		{
-		int addpos = findSkipBrackets(expression, '+');
-		int subpos = findSkipBrackets(expression, '-');
-		if( subpos != -1 )
-		{
-			op = subtraction;
-			firstEnd = subpos;
-			secondStart = subpos + 1;
-		}
-		else if( addpos != -1 )
-		{
-			op = addition;
-			firstEnd = addpos;
-			secondStart = addpos + 1;
-		}
-		else op = noop;
-		break;
-		}
+/**
+ * @return how tightly the binary operator binds (higher binds more tightly),
+ * or -1 if op is not a binary operator.
+ */
+static int binaryPrecedence( Expression::Operation op )
+{
+	switch ( op )
+	{
+		case Expression::equals:
+		case Expression::notequals:
+			return 1;
+			
+		case Expression::lt:
+		case Expression::gt:
+		case Expression::le:
+		case Expression::ge:
+			return 2;
+			
+		case Expression::addition:
+		case Expression::subtraction:
+			return 3;
+			
+		case Expression::multiplication:
+		case Expression::division:
+			return 4;
+			
+		case Expression::exponent:
+			return 5;
+			
+		case Expression::bwand:
+		case Expression::bwor:
+		case Expression::bwxor:
+			return 6;
+			
+		default:
+			return -1;
+	}
+}
+
+
+BTreeNode * Expression::buildTree( const QString & expression, BTreeBase *tree )
+{
+	m_expression = expression;
+	tokenize( expression );
+	
+	BTreeNode *root = parseExpression( tree, 1 );
+	
+	if ( m_tokenPos < m_tokens.size() )
+	{
+		if ( m_tokens[m_tokenPos].type == Token::CloseBracket )
+			mistake( Microbe::MismatchedBrackets, expression );
+		else
+			mistake( Microbe::MissingOperator );
+	}
+	
+	tree->setRoot( root );
+	return root;
+}
+
+
+void Expression::tokenize( const QString & expression )
+{
+	m_tokens.clear();
+	m_tokenPos = 0;
+	
+	// Everything that isn't an operator or bracket is collected in here, so
+	// that e.g. "portb.3 is high" ends up as a single operand
+	QString operand;
+	
+	const int length = expression.length();
+	int i = 0;
+	while ( i < length )
+	{
+		const char ch = expression[i].toLatin1();
+		const char next = (i + 1 < length) ? expression[i+1].toLatin1() : 0;
 		
-		// *,/
-		case 3:
-		{
-		int mulpos = findSkipBrackets(expression, '*');
-		int divpos = findSkipBrackets(expression, '/');
-		if( divpos != -1 )
+		// Quoted characters, such as '(', are operands
+		if ( ch == '\'' && i + 2 < length && expression[i+2] == '\'' )
 		{
-			op = division;
-			firstEnd = divpos;
-			secondStart = divpos + 1;
-		}
-		else if( mulpos != -1 )
-		{
-			op = multiplication;
-			firstEnd = mulpos;
-			secondStart = mulpos + 1;
-		}
-		else op = noop;
-		break;
+			operand += expression.mid( i, 3 );
+			i += 3;
+			continue;
 		}
 		
-		// ^
-		case 4:
-		{
-		int exppos = findSkipBrackets(expression, '^');
-		if( exppos != -1 )
-		{
-			op = exponent;
-			firstEnd = exppos;
-			secondStart = exppos + 1;
-		}
-		else op = noop;
-		break;
-		}
+		Token token;
+		token.type = Token::Operator;
+		int tokenLength = 1;
 		
-		// AND, OR, XOR
-		case 5:
-		{
-		int bwAndPos = findSkipBrackets(expression, " AND ");
-		int bwOrPos = findSkipBrackets(expression, " OR ");
-		int bwXorPos = findSkipBrackets(expression, " XOR ");
-		if( bwAndPos != -1 )
-		{
-			op = bwand;
-			firstEnd = bwAndPos;
-			secondStart = bwAndPos + 5;
-		}
-		else if( bwOrPos != -1 )
-		{
-			op = bwor;
-			firstEnd = bwOrPos;
-			secondStart = bwOrPos + 4;
+		switch ( ch )
+		{
+			case '(': token.type = Token::OpenBracket; break;
+			case ')': token.type = Token::CloseBracket; break;
+			case '+': token.op = addition; break;
+			case '-': token.op = subtraction; break;
+			case '*': token.op = multiplication; break;
+			case '/': token.op = division; break;
+			case '^': token.op = exponent; break;
+			
+			case '=':
+			case '!':
+				// A single '=' or '!' is left in the operand for expressionValue to complain about
+				if ( next == '=' )
+				{
+					token.op = (ch == '=') ? equals : notequals;
+					tokenLength = 2;
+				}
+				break;
+				
+			case '<':
+			case '>':
+				if ( next == '=' )
+				{
+					token.op = (ch == '<') ? le : ge;
+					tokenLength = 2;
+				}
+				else
+					token.op = (ch == '<') ? lt : gt;
+				break;
+				
+			case 'A':
+			case 'O':
+			case 'X':
+			case 'N':
+				token.op = wordOperator( expression, i, & tokenLength );
+				break;
 		}
-		else if( bwXorPos != -1 )
+		
+		if ( token.type == Token::Operator && token.op == noop )
 		{
-			op = bwxor;
-			firstEnd = bwXorPos;
-			secondStart = bwXorPos + 5;
-		}
-		else op = noop;
-		break;
+			operand += expression[i];
+			i++;
+			continue;
 		}
 		
-		// NOT
-		case 6:
-		{
-		int bwNotPos = findSkipBrackets(expression, " NOT ");
-		if( bwNotPos != -1 )
+		operand = operand.trimmed();
+		if ( !operand.isEmpty() )
 		{
-			op = bwnot;
-			unary = true;
-			firstEnd = bwNotPos; // this line is not needed for unary things/
-			secondStart = bwNotPos + 5;
-		}
-		else op = noop;
-		break;
+			Token operandToken;
+			operandToken.text = operand;
+			m_tokens << operandToken;
+			operand.clear();
 		}
+		
+		m_tokens << token;
+		i += tokenLength;
 	}
 	
-	node->setChildOp(op);
+	operand = operand.trimmed();
+	if ( !operand.isEmpty() )
+	{
+		Token operandToken;
+		operandToken.text = operand;
+		m_tokens << operandToken;
+	}
+}
+
+
+BTreeNode * Expression::parseExpression( BTreeBase *tree, int minPrecedence )
+{
+	BTreeNode *node = parseOperand( tree );
 	
-	QString tokens[2];
-	tokens[0] = expression.left(firstEnd).trimmed();
-	tokens[1] = expression.mid(secondStart).trimmed();
+	while ( m_tokenPos < m_tokens.size() )
+	{
+		const Operation op = m_tokens[m_tokenPos].op;
+		const int precedence = (m_tokens[m_tokenPos].type == Token::Operator) ? binaryPrecedence( op ) : -1;
+		if ( precedence < minPrecedence )
+			break;
+		
+		m_tokenPos++;
+		
+		// Operators are left associative, so the right hand side may only
+		// contain operators that bind more tightly
+		BTreeNode *right = parseExpression( tree, precedence + 1 );
+		node = createOpNode( tree, op, node, right );
+	}
 	
-	if( op != noop )
-	{	
-		for( int j = 0; j < 2; j++ )
+	return node;
+}
+
+
+BTreeNode * Expression::parseOperand( BTreeBase *tree )
+{
+	if ( m_tokenPos < m_tokens.size() )
+	{
+		const Token & token = m_tokens[m_tokenPos];
+		
+		if ( token.type == Token::Operand )
 		{
+			m_tokenPos++;
+			BTreeNode *node = new BTreeNode();
+			node->setChildOp( noop );
+			expressionValue( token.text, node );
+			return node;
+		}
+		
+		if ( token.type == Token::OpenBracket )
+		{
+			m_tokenPos++;
+			BTreeNode *node = parseExpression( tree, 1 );
+			if ( m_tokenPos < m_tokens.size() && m_tokens[m_tokenPos].type == Token::CloseBracket )
+				m_tokenPos++;
+			else
+				mistake( Microbe::MismatchedBrackets, m_expression );
+			return node;
+		}
+		
+		if ( token.type == Token::Operator && token.op == bwnot )
+		{
+			m_tokenPos++;
 			
-			BTreeNode *newNode = new BTreeNode();
-			tree->addNode( node, newNode, (j == 0) );
-			// we need to strip any brackets from the sub-expression
-			
-			// try each token again at the same level, if they 
-			// don't have any of this level's operators, then the function
-			// will go to the next level as below.
-			
-			// For unary opertaions, e.g NOT, we have no special 
+			// For unary operations, e.g NOT, we have no special 
 			// code for nodes with only one child, so we leave the left
 			// hand child blank and put the rest in the right hand node.
-			if( unary && j == 0 )
-			{
-				newNode->setValue("");
-				newNode->setType(number);
-			}
-			else buildTree(tokens[j], tree, newNode, 0 );
+			BTreeNode *blank = new BTreeNode();
+			blank->setChildOp( noop );
+			blank->setType( number );
+			return createOpNode( tree, bwnot, blank, parseOperand( tree ) );
 		}
 	}
-	else
+	
+	// Nothing between two operators (or at the start or end); expressionValue
+	// will report this
+	BTreeNode *node = new BTreeNode();
+	node->setChildOp( noop );
+	expressionValue( QString(), node );
+	return node;
+}
+
+
+BTreeNode * Expression::createOpNode( BTreeBase *tree, Operation op, BTreeNode *left, BTreeNode *right )
+{
+	BTreeNode *node = new BTreeNode();
+	node->setChildOp( op );
+	tree->addNode( node, left, true );
+	tree->addNode( node, right, false );
+	
+	// Fold constants as the tree is built
+	if ( left->type() != number || right->type() != number )
+		return node;
+	
+	bool ok;
+	int rvalue = Parser::literalToInt( right->value(), & ok );
+	if ( !ok )
+		return node;
+	
+	int lvalue = 0;
+	if ( op != bwnot )
 	{
-		// if there was no relevant operation i.e. " 3*4 / 6" as opposed to " 3*4 + 6"
-		// then just pass the node onto the next parsing level.
-		// unless we are at the lowest level, in which case we have reached a final value.
-		if( level == 6 ) expressionValue(expression,tree,node);
-		else 
-		{
-			buildTree(expression,tree,node,level + 1);
-		}
+		lvalue = Parser::literalToInt( left->value(), & ok );
+		if ( !ok )
+			return node;
 	}
+	
+	// Leave division by zero for pruneTree to mark as such
+	if ( op == division && rvalue == 0 )
+		return node;
+	
+	node->deleteChildren();
+	node->setChildOp( noop );
+	node->setType( number );
+	node->setValue( QString::number( Parser::doArithmetic( lvalue, rvalue, op ) ) );
+	return node;
 }
 
 void Expression::doUnaryOp(Operation op, BTreeNode *node)
@@ -481,12 +576,10 @@ void Expression::compileExpression( const QString & expression )
 {
 	// Make a tree to put the expression in.
 	BTreeBase *tree = new BTreeBase();
-	BTreeNode *root = new BTreeNode();
 
 	// parse the expression into the tree
-	buildTree(expression,tree,root,0);
+	buildTree(expression,tree);
 	// compile the tree into assembly code
-	tree->setRoot(root);
 	tree->pruneTree(tree->root());
 	traverseTree(tree->root());
 	
@@ -498,22 +591,36 @@ void Expression::compileExpression( const QString & expression )
 
 void Expression::compileConditional( const QString & expression, Code * ifCode, Code * elseCode )
 {
-	if( expression.contains(QRegExp("=>|=<|=!")) )
+	// Look for "=>", "=<" and "=!", and for a single '=' between two other characters
+	bool invalidComparison = false;
+	bool invalidEquals = false;
+	const int length = expression.length();
+	for ( int i = 0; i < length; ++i )
+	{
+		if ( expression[i] != '=' )
+			continue;
+		
+		const QChar next = (i + 1 < length) ? expression[i+1] : QChar();
+		if ( next == '>' || next == '<' || next == '!' )
+			invalidComparison = true;
+		else if ( i > 0 && i + 1 < length && next != '=' && !QString("=><!").contains( expression[i-1] ) )
+			invalidEquals = true;
+	}
+	if ( invalidComparison )
 	{
 		mistake( Microbe::InvalidComparison, expression );
 		return;
 	}
-	if( expression.contains(QRegExp("[^=><!][=][^=]")))
+	if ( invalidEquals )
 	{
 		mistake( Microbe::InvalidEquals );
 		return;
 	}
 	// Make a tree to put the expression in.
 	BTreeBase *tree = new BTreeBase();
-	BTreeNode *root = new BTreeNode();
 
 	// parse the expression into the tree
-	buildTree(expression,tree,root,0);
+	BTreeNode *root = buildTree(expression,tree);
 	
 	// Modify the tree so it is always at the top level of the form (kwoerpkwoep) == (qwopekqpowekp)
 	if ( root->childOp() != equals &&
@@ -544,6 +651,8 @@ void Expression::compileConditional( const QString & expression, Code * ifCode,
 	// compile the tree into assembly code
 	tree->setRoot(root);
 	tree->pruneTree(tree->root(),true);
+	// (pruning may have replaced the root)
+	root = tree->root();
 	
 	// We might have just a constant expression, in which case we can just always do if or else depending
 	// on whether it is true or false.
@@ -578,114 +687,7 @@ void Expression::mistake( Microbe::MistakeType type, const QString & context )
 	mb->compileError( type, context, m_sourceLine );
 }
 
-int Expression::findSkipBrackets( const QString & expr, char ch, int startPos)
-{
-	bool found = false;
-	int i = startPos;
-	int bracketLevel = 0;
-	while(!found)
-	{
-		if(expr[i].toLatin1() == '\'')
-		{
-			if( i + 2 < int(expr.length()) )
-			{
-				if( expr[i+2].toLatin1() == '\'' )
-				{
-				 i = i + 2;
-				 found = true;
-				}
-			}
-		}
-		
-		if(expr[i].toLatin1() == '(') bracketLevel++;
-		else if(expr[i].toLatin1() == ')') bracketLevel--;
-		
-		if( bracketLevel == 0 )
-		{
-			if(expr[i].toLatin1() == ch) found = true;
-			else i++;
-		}
-		else i++;
-		
-		if( i >= int(expr.length()) )
-		{
-			found = true;
-			i = -1;
-		}
-	}
-	return i;
-}
-
-int Expression::findSkipBrackets( const QString & expr, QString phrase, int startPos)
-{
-	bool found = false;
-	int i = startPos;
-	int bracketLevel = 0;
-	while(!found)
-	{	
-		if(expr[i].toLatin1() == '\'')
-		{
-			if( i + 2 < int(expr.length()) )
-			{
-				if( expr[i+2].toLatin1() == '\'' )
-				{
-				 i = i + 2;
-				 found = true;
-				}
-			}
-		}
-		
-		if(expr[i].toLatin1() == '(') bracketLevel++;
-		else if(expr[i].toLatin1() == ')') bracketLevel--;
-		
-		if( bracketLevel == 0 )
-		{
-			if(expr.mid(i,phrase.length()) == phrase) found = true;
-			else i++;
-		}
-		else i++;
-		
-		if( i >= int(expr.length()) )
-		{
-			found = true;
-			i = -1;
-		}
-	}
-	return i;
-}
-
-QString Expression::stripBrackets( QString expression )
-{
-	bool stripping = true;
-	int bracketLevel = 0;
-	int i = 0;
-	expression = expression.trimmed();
-	while(stripping)
-	{
-		if( expression.at(i) == '(' ) bracketLevel++;
-		else if( expression.at(i) == ')' )
-		{
-			if( i == int(expression.length() - 1) && bracketLevel == 1)
-			{
-				expression = expression.mid(1,expression.length() - 2).trimmed();
-			}
-			bracketLevel--;	
-		}
-		if( i == int(expression.length() - 1) && bracketLevel > 0 )
-		{
-			mistake( Microbe::MismatchedBrackets, expression );
-			// Stray brackets might cause the expressionession parser some problems,
-			// so we just avoid parsing anything altogether
-			expression = "";
-			stripping = false;
-		}
-		i++;
-		if( bracketLevel == 0 ) stripping = false;
-	}
-	return expression;
-}
-
-void Expression::expressionValue( QString expr, BTreeBase */*tree*/, BTreeNode *node)
+void Expression::expressionValue( QString expr, BTreeNode *node)
 {
 	/* The "end of the line" for the expression parsing, the
 	expression has been broken down into the fundamental elements of expr.value()=="to"||
@@ -731,8 +733,17 @@ void Expression::expressionValue( QString expr, BTreeBase */*tree*/, BTreeNode *
 	// both indicating a Mistake.
 	if(expr.isEmpty())
 		mistake( Microbe::ConsecutiveOperators );
-	else if(expr.contains(QRegExp("\\s")) && t!= extpin)
-		mistake( Microbe::MissingOperator );
+	else if ( t != extpin )
+	{
+		for ( int i = 0; i < expr.length(); ++i )
+		{
+			if ( expr[i].isSpace() )
+			{
+				mistake( Microbe::MissingOperator );
+				break;
+			}
+		}
+	}
 
 //***************modified isValidRegister is included ***********************//	
 
@@ -824,18 +835,16 @@ QString Expression::processConstant( const QString & expr, bool * isConstant )
 	
 	// Make a tree to put the expression in.
 	BTreeBase *tree = new BTreeBase();
-	BTreeNode *root = new BTreeNode();
 
 	// parse the expression into the tree
-	buildTree(expr,tree,root,0);
+	buildTree(expr,tree);
 	// compile the tree into assembly code
-	tree->setRoot(root);
 	tree->pruneTree(tree->root());
 	//code = traverseTree(tree->root());
 	// Look to see if it is a number
-	if( root->type() == number )
+	if( tree->root()->type() == number )
 	{
-		code = root->value();
+		code = tree->root()->value();
 		*isConstant = true;
 	}
 	else
@@ -29,6 +29,7 @@
 #include "microbe.h"
 
 #include <qstring.h>
+#include <qvector.h>
 
 class PIC14;
 class BTreeNode;
@@ -91,21 +92,60 @@ class Expression
 	
 		bool isUnaryOp(Operation op);
 	
-		void expressionValue( QString expression, BTreeBase *tree, BTreeNode *node );
+		void expressionValue( QString expression, BTreeNode *node );
 		void doOp( Operation op, BTreeNode *left, BTreeNode *right );
 		void doUnaryOp( Operation op, BTreeNode *node );
 		/**
-		 * Parses an expression, and generates a tree structure from it.
+		 * Parses an expression, and generates a tree structure from it. The
+		 * root of the tree is set to the returned node.
 		 */
-		void buildTree( const QString & expression, BTreeBase *tree, BTreeNode *node, int level );
-
-		static int findSkipBrackets( const QString & expr, char ch, int startPos = 0);
-		static int findSkipBrackets( const QString & expr, QString phrase, int startPos = 0);
-	
-		QString stripBrackets( QString expression );
+		BTreeNode * buildTree( const QString & expression, BTreeBase *tree );
+		/**
+		 * Splits the expression into m_tokens in a single pass.
+		 */
+		void tokenize( const QString & expression );
+		/**
+		 * Parses the tokens from m_tokenPos by precedence climbing, consuming
+		 * binary operators of at least the given precedence.
+		 */
+		BTreeNode * parseExpression( BTreeBase *tree, int minPrecedence );
+		/**
+		 * Parses a single operand, bracketed expression or NOT.
+		 */
+		BTreeNode * parseOperand( BTreeBase *tree );
+		/**
+		 * Creates a node combining left and right with the given operation.
+		 * If both are numbers, the node is evaluated straight away.
+		 */
+		BTreeNode * createOpNode( BTreeBase *tree, Operation op, BTreeNode *left, BTreeNode *right );
 	
 		void mistake( Microbe::MistakeType type, const QString & context = 0 );
 	
+		/**
+		 * An operand, operator or bracket of the expression being parsed.
+		 */
+		class Token
+		{
+			public:
+				enum Type
+				{
+					Operand,
+					Operator,
+					OpenBracket,
+					CloseBracket
+				};
+				
+				Token() : type(Operand), op(noop) {}
+				
+				Type type;
+				Operation op;
+				QString text; // for operands
+		};
+		
+		QString m_expression;
+		QVector<Token> m_tokens;
+		int m_tokenPos;
+		
 		SourceLine m_sourceLine;
 	
 		Code * m_ifCode;
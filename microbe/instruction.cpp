@@ -27,6 +27,7 @@
 #include "optimizer.h"
 #include "pic14.h"
 #include <kdebug.h>
+#include <qhash.h>
 #include <qstringlist.h>
 #include <cassert>
 #include <iostream>
@@ -34,6 +35,44 @@ using namespace std;
 //modified new varable pic_type is added
 extern QString pic_type;
 //BEGIN class Register
+/**
+ * Names of the GPRs that have been given an index, in order of index.
+ */
+static QStringList & gprNames()
+{
+	static QStringList names;
+	return names;
+}
+
+
+/**
+ * @return the index of the GPR with the given name, allocating a new index if
+ * the name has not been seen before.
+ */
+static int gprIndex( const QString & name )
+{
+	static QHash< QString, int > indices;
+	
+	QHash< QString, int >::const_iterator it = indices.constFind( name );
+	if ( it != indices.constEnd() )
+		return it.value();
+	
+	int index = Register::none + 1 + gprNames().size();
+	indices.insert( name, index );
+	gprNames() << name;
+	return index;
+}
+
+
+QString Register::nameForIndex( int index )
+{
+	if ( index <= none )
+		return Register( Type(index) ).name();
+	
+	return gprNames().value( index - none - 1 );
+}
+
+
 Register::Register( Type type )
 {
 	m_type = type;
@@ -222,6 +261,8 @@ Register::Register( Type type )
 		case none:
 			break;
 	}
+	
+	m_index = (m_type == GPR) ? gprIndex( m_name ) : m_type;
 }
 
 
@@ -348,6 +389,8 @@ Register::Register( const QString & name )//--to find a name varable or register
 //---------------------------------------------NoBank----------------//
 	else
 		m_type = GPR;
+	
+	m_index = (m_type == GPR) ? gprIndex( m_name ) : m_type;
 }
 
 
@@ -1857,8 +1900,8 @@ void ProcessorState::reset()
 	working.reset();
 	status.reset();
 	
-	RegisterMap::iterator end = m_registers.end();
-	for ( RegisterMap::iterator it = m_registers.begin(); it != end; ++it )
+	RegisterVector::iterator end = m_registers.end();
+	for ( RegisterVector::iterator it = m_registers.begin(); it != end; ++it )
 		(*it).reset();
 }
 
@@ -1868,56 +1911,17 @@ void ProcessorState::merge( const ProcessorState & state )
 	working.merge( state.working );
 	status.merge( state.status );
 	
-	RegisterMap::iterator this_it = m_registers.begin();
-	RegisterMap::const_iterator other_it = state.m_registers.begin();
+	const int otherSize = state.m_registers.size();
+	if ( m_registers.size() < otherSize )
+		m_registers.resize( otherSize );
 	
-	RegisterMap::iterator this_end = m_registers.end();
-	RegisterMap::const_iterator other_end = state.m_registers.end();
+	const int size = m_registers.size();
+	RegisterState * registers = m_registers.data();
+	const RegisterState * other = state.m_registers.constData();
 	
-	while ( true )
-	{
-		if ( this_it == this_end )
-		{
-			// So remaining registers of this are default
-			while ( other_it != other_end )
-			{
-				m_registers[ other_it.key() ].merge( *other_it );
-				++other_it;
-			}
-			return;
-		}
-		
-		if ( other_it == other_end )
-		{
-			// So remaining registers of other are default
-			while ( this_it != this_end )
-			{
-				(*this_it).merge( RegisterState() );
-				++this_it;
-			}
-			return;
-		}
-		
-		//RegisterState thisReg = *this_it;
-		//RegisterState otherReg = *other_it;
-		
-		if ( this_it.key() == other_it.key() )	
-		{
-			(*this_it).merge( *other_it );
-			++this_it;
-			++other_it;
-		}
-		else if ( this_it.key() < other_it.key() )
-		{
-			(*this_it).merge( RegisterState() );
-			++this_it;
-		}
-		else // other_it.key() < this_it.key()
-		{
-			m_registers[ other_it.key() ].merge( *other_it );
-			++other_it;
-		}
-	}
+	// Registers missing from the other state are default (unknown)
+	for ( int i = 0; i < size; ++i )
+		registers[i].merge( (i < otherSize) ? other[i] : RegisterState() );
 }
 
 
@@ -1929,7 +1933,11 @@ RegisterState & ProcessorState::reg( const Register & reg )
 	if ( reg.type() == Register::STATUS )
 		return status;
 	
-	return m_registers[ reg ];
+	const int index = reg.index();
+	if ( index >= m_registers.size() )
+		m_registers.resize( index + 1 );
+	
+	return m_registers[ index ];
 }
 
 
@@ -1941,7 +1949,11 @@ RegisterState ProcessorState::reg( const Register & reg ) const
 	if ( reg.type() == Register::STATUS )
 		return status;
 	
-	return m_registers[ reg ];
+	const int index = reg.index();
+	if ( index >= m_registers.size() )
+		return RegisterState();
+	
+	return m_registers.at( index );
 }
 
 
@@ -1953,61 +1965,23 @@ bool ProcessorState::operator == ( const ProcessorState & state ) const
 	if ( status != state.status )
 		return false;
 	
-	RegisterMap::const_iterator this_it = m_registers.begin();
-	RegisterMap::const_iterator other_it = state.m_registers.begin();
+	const int thisSize = m_registers.size();
+	const int otherSize = state.m_registers.size();
+	const int size = qMax( thisSize, otherSize );
 	
-	RegisterMap::const_iterator this_end = m_registers.end();
-	RegisterMap::const_iterator other_end = state.m_registers.end();
+	const RegisterState * registers = m_registers.constData();
+	const RegisterState * other = state.m_registers.constData();
 	
-	while ( true )
+	// Registers missing from either state are default
+	for ( int i = 0; i < size; ++i )
 	{
-		if ( this_it == this_end )
-		{
-			// So remaining registers of this are default
-			while ( other_it != other_end )
-			{
-				if ( *other_it != RegisterState() )
-					return false;
-				++other_it;
-			}
-			return true;
-		}
-		
-		if ( other_it == other_end )
-		{
-			// So remaining registers of other are default
-			while ( this_it != this_end )
-			{
-				if ( *this_it != RegisterState() )
-					return false;
-				++this_it;
-			}
-			return true;
-		}
-		
-		//RegisterState thisReg = *this_it;
-		//RegisterState otherReg = *other_it;
-		
-		if ( this_it.key() == other_it.key() )	
-		{
-			if ( *this_it != *other_it )
-				return false;
-			++this_it;
-			++other_it;
-		}
-		else if ( this_it.key() < other_it.key() )
-		{
-			if ( *this_it != RegisterState() )
-				return false;
-			++this_it;
-		}
-		else // other_it.key() < this_it.key()
-		{
-			if ( *other_it != RegisterState() )
-				return false;
-			++other_it;
-		}
+		RegisterState a = (i < thisSize) ? registers[i] : RegisterState();
+		RegisterState b = (i < otherSize) ? other[i] : RegisterState();
+		if ( a != b )
+			return false;
 	}
+	
+	return true;
 }
 
 
@@ -2017,12 +1991,14 @@ void ProcessorState::print()
 	working.print();
 	cout << " STATUS:\n";
 	working.print();
-	RegisterMap::iterator end = m_registers.end();
-	for ( RegisterMap::iterator it = m_registers.begin(); it != end; ++it )
+	const int size = m_registers.size();
+	for ( int i = 0; i < size; ++i )
 	{
-		cout << " " << it.key().name().toStdString() << ":\n";
-        it.value().print();
-// 		it.value().print();
+		if ( m_registers[i] == RegisterState() )
+			continue;
+		
+		cout << " " << Register::nameForIndex( i ).toStdString() << ":\n";
+		m_registers[i].print();
 	}
 }
 //END class ProcessorState
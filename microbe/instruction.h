@@ -30,6 +30,7 @@
 #include <qstring.h>
 #include <qstringlist.h>
 #include <qlist.h>
+#include <qvector.h>
 
 class Code;
 class CodeIterator;
@@ -180,10 +181,24 @@ class Register
 		 * and TRIS registers, false for everything else.
 		 */
 		bool affectsExternal() const;
+		/**
+		 * @return a small integer that uniquely identifies the register (as
+		 * per operator==), suitable for indexing into arrays. Registers
+		 * other than GPRs are identified by their type; GPRs are given
+		 * indices after those of the types in the order that their names are
+		 * first seen.
+		 */
+		int index() const { return m_index; }
+		/**
+		 * @return the name of the register with the given index.
+		 * @see index
+		 */
+		static QString nameForIndex( int index );
 		
 	protected:
 		QString m_name;
 		Type m_type;
+		int m_index;
 };
 
 
@@ -431,12 +446,15 @@ class ProcessorState
 		RegisterState status;
 		
 	protected:
-		typedef QMap< Register, RegisterState > RegisterMap;
+		typedef QVector<RegisterState> RegisterVector;
 		/**
-		 * All registers other than working and status. Entries are created on
-		 * calls to reg with a new Register.
+		 * All registers other than working and status, indexed by
+		 * Register::index. The vector is grown on calls to reg with a register
+		 * beyond its end; missing entries are in the default (unknown) state.
+		 * Being implicitly shared, copying a ProcessorState from one
+		 * instruction to the next is cheap.
 		 */
-		RegisterMap m_registers;
+		RegisterVector m_registers;
 };
 
 
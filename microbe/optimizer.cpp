@@ -83,46 +83,142 @@ void Optimizer::propagateLinksAndStates()
 	{
 		count++;
 		m_pCode->generateLinksAndStates();
+		buildBasicBlocks();
 	}
-	while ( giveInputStates() );
+	while ( solveStates() );
 	
 // 	cout << "count="<<count<<endl;
 }
 
 
-bool Optimizer::giveInputStates()
+void Optimizer::buildBasicBlocks()
 {
-	bool changed = false;
+	m_blocks.clear();
+	m_blockIndex.clear();
+	
+	Instruction * previous = 0l;
 	
 	Code::iterator end = m_pCode->end();
 	for ( Code::iterator it = m_pCode->begin(); it != end; ++it )
 	{
-		// Now, build up the most specific known processor state from the instructins
-		// that could be executed immediately before this instruction.
-		// This is done by taking the output state of the first input link, and
-		// then reducing it to the greatest common denominator of all the input states.
+		Instruction * ins = *it;
 		
-		const InstructionList list = (*it)->inputLinks();
-		if ( list.isEmpty() )
-			continue;
+		bool startsBlock = !previous ||
+				(previous->outputLinks().size() != 1) ||
+				(previous->outputLinks().first() != ins) ||
+				(ins->inputLinks().size() != 1);
 		
-		InstructionList::const_iterator inputIt = list.begin();
-		InstructionList::const_iterator inputsEnd = list.end();
+		if ( startsBlock )
+			m_blocks << BasicBlock();
 		
-		ProcessorState input = (*(inputIt++))->outputState();
+		m_blocks.last().instructions << it;
+		m_blockIndex[ins] = m_blocks.size() - 1;
+		previous = ins;
+	}
+	
+	const int blockCount = m_blocks.size();
+	for ( int i = 0; i < blockCount; ++i )
+	{
+		BasicBlock & block = m_blocks[i];
 		
-		while ( inputIt != inputsEnd )
-			input.merge( (*inputIt++)->outputState() );
+		const InstructionList outputs = (*block.instructions.last())->outputLinks();
+		InstructionList::const_iterator outputsEnd = outputs.end();
+		for ( InstructionList::const_iterator outputIt = outputs.begin(); outputIt != outputsEnd; ++outputIt )
+		{
+			int successor = m_blockIndex.value( *outputIt, -1 );
+			if ( successor != -1 && !block.successors.contains( successor ) )
+				block.successors << successor;
+		}
+	}
+}
+
+
+bool Optimizer::solveStates()
+{
+	bool changed = false;
+	
+	// Every instruction's output state was generated from its current input
+	// state by Code::generateLinksAndStates, so a block only needs to be
+	// looked at again once the output of one of its predecessors changes.
+	QList<int> worklist;
+	const int blockCount = m_blocks.size();
+	for ( int i = 0; i < blockCount; ++i )
+	{
+		worklist << i;
+		m_blocks[i].onWorklist = true;
+	}
+	
+	while ( !worklist.isEmpty() )
+	{
+		BasicBlock & block = m_blocks[ worklist.takeFirst() ];
+		block.onWorklist = false;
+		
+		bool outputChanged = false;
 		
-		if ( !changed )
+		const int size = block.instructions.size();
+		for ( int i = 0; i < size; ++i )
 		{
-			ProcessorState before = (*it)->inputState();
-			bool stateChanged = ( before != input );
-			changed |= stateChanged;
+			Code::iterator it = block.instructions[i];
+			Instruction * ins = *it;
+			
+			// Build up the most specific known processor state from the
+			// instructions that could be executed immediately before this one.
+			ProcessorState input;
+			
+			if ( i > 0 )
+				input = (*block.instructions[i-1])->outputState();
+			
+			else
+			{
+				const InstructionList list = ins->inputLinks();
+				if ( list.isEmpty() )
+					continue;
+				
+				InstructionList::const_iterator inputIt = list.begin();
+				InstructionList::const_iterator inputsEnd = list.end();
+				
+				input = (*(inputIt++))->outputState();
+				
+				while ( inputIt != inputsEnd )
+					input.merge( (*inputIt++)->outputState() );
+			}
+			
+			if ( input == ins->inputState() )
+			{
+				outputChanged = false;
+				continue;
+			}
+			
+			changed = true;
+			
+			const int linkCount = ins->outputLinks().size();
+			const ProcessorState before = ins->outputState();
+			
+			ins->setInputState( input );
+			ins->generateLinksAndStates( it );
+			
+			// Branches may depend on the processor state, in which case the
+			// blocks are no longer valid.
+			if ( ins->outputLinks().size() != linkCount )
+				return true;
+			
+			outputChanged = (ins->outputState() != before);
 		}
 		
-		(*it)->setInputState( input );
+		if ( !outputChanged )
+			continue;
+		
+		QList<int>::const_iterator end = block.successors.end();
+		for ( QList<int>::const_iterator it = block.successors.begin(); it != end; ++it )
+		{
+			if ( m_blocks[*it].onWorklist )
+				continue;
+			
+			m_blocks[*it].onWorklist = true;
+			worklist << *it;
+		}
 	}
+	
 	return changed;
 }
 
@@ -13,11 +13,34 @@
 
 #include "instruction.h"
 
+#include <qhash.h>
+
 
 /// Used for debugging; returns the uchar as a binary string (e.g. 01101010).
 QString binary( uchar val );
 
 
+/**
+A straight-line run of instructions: only the first can be reached from
+anywhere other than the instruction before it, and only the last can lead
+anywhere other than the instruction after it.
+
+@author David Saxton
+*/
+class BasicBlock
+{
+	public:
+		BasicBlock() { onWorklist = false; }
+		
+		/// The instructions in the block, in order of execution
+		QList<Code::iterator> instructions;
+		/// Indices of the blocks that may be executed after this block
+		QList<int> successors;
+		/// Whether the block is waiting to be revisited by the state solver
+		bool onWorklist;
+};
+
+
 /**
 @author David Saxton
 */
@@ -37,12 +60,19 @@ class Optimizer
 		 */
 		void propagateLinksAndStates();
 		/**
-		 * Tell the instructions about their input states.
-		 * @return whether any input states changed from the previous value
-		 * stored in the instruction (if checkChanged is true - else returns
-		 * true).
+		 * Splits the code into basic blocks, using the links generated by the
+		 * last call to Code::generateLinksAndStates.
+		 */
+		void buildBasicBlocks();
+		/**
+		 * Propagates the processor states through the basic blocks, starting
+		 * with every block on the worklist and only revisiting the successors
+		 * of blocks whose output state changed.
+		 * @return whether the input state of any instruction changed (after
+		 * which the links need to be regenerated, as they may depend on the
+		 * states).
 		 */
-		bool giveInputStates();
+		bool solveStates();
 		/**
 		 * Remove instructions without any input links (and the ones that are
 		 * only linked to from a removed instruction).
@@ -82,6 +112,8 @@ class Optimizer
 		bool canRemove( Instruction * ins, const Register & reg, uchar bitMask = 0xff );
 		
 		Code * m_pCode;
+		QList<BasicBlock> m_blocks;
+		QHash< Instruction*, int > m_blockIndex; ///< Block containing each instruction
 };
 
 #endif
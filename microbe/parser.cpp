@@ -29,7 +29,6 @@
 #include <kdebug.h>
 #include <klocale.h>
 #include <qfile.h>
-#include <qregexp.h>
 #include <qstring.h>
 
 #include <iostream>
@@ -42,100 +41,134 @@ Parser::Parser( Microbe * _mb )
 	m_code = 0;
 	m_pPic = 0;
 	mb = _mb;
+}
+
+
+const DefinitionMap & Parser::definitionMap()
+{
+	static const DefinitionMap definitions = createDefinitionMap();
+	return definitions;
+}
+
+
+DefinitionMap Parser::createDefinitionMap()
+{
+	DefinitionMap definitions;
+	
 	// Set up statement definitions.
 	StatementDefinition definition;
 	
+	definition.keyword = StatementDefinition::Goto;
 	definition.append( Field(Field::Label, "label") );
-	m_definitionMap["goto"] = definition;
+	definitions["goto"] = definition;
 	definition.clear();
 	
+	definition.keyword = StatementDefinition::Call;
 	definition.append( Field(Field::Label, "label") );
-	m_definitionMap["call"] = definition;
+	definitions["call"] = definition;
 	definition.clear();
 	
+	definition.keyword = StatementDefinition::While;
 	definition.append( Field(Field::Expression, "expression") );
 	definition.append( Field(Field::Code, "code") );
-	m_definitionMap["while"] = definition;
+	definitions["while"] = definition;
 	definition.clear();
 	
-	m_definitionMap["end"] = definition;
+	definition.keyword = StatementDefinition::End;
+	definitions["end"] = definition;
 	definition.clear();
 	
+	definition.keyword = StatementDefinition::Subroutine;
 	definition.append( Field(Field::Label, "label") );
 	definition.append( Field(Field::Code, "code") );
 	// For backwards compataibility
-	m_definitionMap["sub"] = definition;
-	m_definitionMap["subroutine"] = definition;
+	definitions["sub"] = definition;
+	definitions["subroutine"] = definition;
 	definition.clear();
 	
+	definition.keyword = StatementDefinition::Interrupt;
 	definition.append( Field(Field::Label, "label") );
 	definition.append( Field(Field::Code, "code") );
-	m_definitionMap["interrupt"] = definition;
+	definitions["interrupt"] = definition;
 	definition.clear();
 
+	definition.keyword = StatementDefinition::Alias;
 	definition.append( Field(Field::Label, "alias") );
 	definition.append( Field(Field::Label, "dest") );
-	m_definitionMap["alias"] = definition;
+	definitions["alias"] = definition;
 	definition.clear();
 	
+	definition.keyword = StatementDefinition::If;
 	definition.append( Field(Field::Expression, "expression") );
 	definition.append( Field(Field::FixedString, 0, "then", true) );
 	definition.append( Field(Field::Code, "ifCode") );
 	definition.append( Field(Field::Newline) );
 	definition.append( Field(Field::FixedString, 0, "else", false) );
 	definition.append( Field(Field::Code, "elseCode") );
-	m_definitionMap["if"] = definition;
+	definitions["if"] = definition;
 	definition.clear();
 	
+	definition.keyword = StatementDefinition::For;
 	definition.append( Field(Field::Expression, "initExpression") );
 	definition.append( Field(Field::FixedString, 0, "to", true) );
 	definition.append( Field(Field::Expression, "toExpression") );
 	definition.append( Field(Field::FixedString, 0, "step", false) );
 	definition.append( Field(Field::Expression, "stepExpression") );
 	definition.append( Field(Field::Code, "code") );
-	m_definitionMap["for"] = definition;
+	definitions["for"] = definition;
 	definition.clear();
 	
+	definition.keyword = StatementDefinition::Decrement;
 	definition.append( Field(Field::Variable, "variable") );
-	m_definitionMap["decrement"] = definition;
+	definitions["decrement"] = definition;
 	definition.clear();
 	
+	definition.keyword = StatementDefinition::Increment;
 	definition.append( Field(Field::Variable, "variable") );
-	m_definitionMap["increment"] = definition;
+	definitions["increment"] = definition;
 	definition.clear();
 	
+	definition.keyword = StatementDefinition::RotateLeft;
 	definition.append( Field(Field::Variable, "variable") );
-	m_definitionMap["rotateleft"] = definition;
+	definitions["rotateleft"] = definition;
 	definition.clear();
 	
+	definition.keyword = StatementDefinition::RotateRight;
 	definition.append( Field(Field::Variable, "variable") );
-	m_definitionMap["rotateright"] = definition;
+	definitions["rotateright"] = definition;
 	definition.clear();
 	
+	definition.keyword = StatementDefinition::Asm;
 	definition.append( Field(Field::Code, "code") );
-	m_definitionMap["asm"] = definition;
+	definitions["asm"] = definition;
 	definition.clear();
 	
+	definition.keyword = StatementDefinition::Delay;
 	definition.append( Field(Field::Expression, "expression") );
-	m_definitionMap["delay"] = definition;
+	definitions["delay"] = definition;
 	definition.clear();
 	
+	definition.keyword = StatementDefinition::Repeat;
 	definition.append( Field(Field::Code, "code") );
 	definition.append( Field(Field::Newline) );
 	definition.append( Field(Field::FixedString, 0, "until", true) );
 	definition.append( Field(Field::Expression, "expression") );
-	m_definitionMap["repeat"] = definition;
+	definitions["repeat"] = definition;
 	definition.clear();
 	
+	definition.keyword = StatementDefinition::SevenSeg;
 	definition.append( Field(Field::Name, "name") );
 	definition.append( Field(Field::PinList, "pinlist") );
-	m_definitionMap["sevenseg"] = definition;
+	definitions["sevenseg"] = definition;
 	definition.clear();
 	
+	definition.keyword = StatementDefinition::Keypad;
 	definition.append( Field(Field::Name, "name") );
 	definition.append( Field(Field::PinList, "pinlist") );
-	m_definitionMap["keypad"] = definition;
+	definitions["keypad"] = definition;
 	definition.clear();
+	
+	return definitions;
 }
 
 Parser::~Parser()
@@ -218,8 +251,9 @@ Code * Parser::parse( const SourceLineList & lines )
 			m_code->append(new Instr_sourceCode("{"));
 
 		// Use the first token in the line to look up the statement type
-		DefinitionMap::Iterator dmit = m_definitionMap.find(command);
-		if(dmit == m_definitionMap.end())
+		const DefinitionMap & definitions = definitionMap();
+		DefinitionMap::const_iterator dmit = definitions.find(command);
+		if(dmit == definitions.end())
 		{
 			if( !processAssignment( (*sit).text() ) )
 			{
@@ -236,7 +270,7 @@ Code * Parser::parse( const SourceLineList & lines )
 			
 			continue; // Give up on the current statement
 		}
-		StatementDefinition definition = dmit.value();
+		const StatementDefinition & definition = dmit.value();
 		
 		// Start at the first white space character following the statement name
 		int newPosition = 0;
@@ -249,7 +283,7 @@ Code * Parser::parse( const SourceLineList & lines )
 		bool errorInLine = false;
 		bool finishLine = false;
 
-		for( StatementDefinition::Iterator sdit = definition.begin(); sdit != definition.end(); ++sdit )
+		for( StatementDefinition::const_iterator sdit = definition.begin(); sdit != definition.end(); ++sdit )
 		{
 			// If there is an error, or we have finished the statement,
 			// the stop. If we are at the end of a line in a multiline, then
@@ -297,13 +331,13 @@ Code * Parser::parse( const SourceLineList & lines )
 					// This is slightly different, as there is nothing
 					// in particular that delimits an expression, we just have to
 					// look at what comes next and hope we can use that.
-					StatementDefinition::Iterator it(sdit);
+					StatementDefinition::const_iterator it(sdit);
 					++it;
 					if( it != definition.end() )
 					{
 						nextField = (*it);
 						if(nextField.type() == Field::FixedString) 
-							newPosition = line.indexOf(QRegExp("\\b" + nextField.string() + "\\b"));
+							newPosition = nextField.indexIn(line);
 						// Although code is not neccessarily braced, after an expression it is the only
 						// sensilbe way to have it.
 						else if(nextField.type() == Field::Code)
@@ -367,7 +401,7 @@ Code * Parser::parse( const SourceLineList & lines )
 				case (Field::FixedString):
 				{
 					// Is the string found, and is it starting in the right place?
-					int stringPosition  = line.indexOf(QRegExp("\\b"+field.string()+"\\b"));
+					int stringPosition  = field.indexIn(line);
 					if( stringPosition != position || stringPosition == -1 )
 					{
 						if( !field.compulsory() )
@@ -398,11 +432,11 @@ Code * Parser::parse( const SourceLineList & lines )
 					// string.
 					
 					// Assume there is a next field, it would be silly if there weren't.
-					nextField = *(++StatementDefinition::Iterator(sdit));
+					nextField = *(++StatementDefinition::const_iterator(sdit));
 					if( nextField.type() == Field::FixedString )
 					{
 						nextStatement = *(++StatementList::Iterator(sit));
-						newPosition = nextStatement.text().indexOf(QRegExp("\\b" + nextField.string() + "\\b"));
+						newPosition = nextField.indexIn(nextStatement.text());
 						if(newPosition != 0)
 						{
 							// If the next field is optional just carry on as nothing happened,
@@ -448,7 +482,7 @@ Code * Parser::parse( const SourceLineList & lines )
 		if( errorInLine ) continue;
 			
 		// Everything has been parsed up, so send it off for processing.
-		processStatement( command, fieldMap );
+		processStatement( definition.keyword, fieldMap );
 
 		if( showBracesInSource )
 			m_code->append(new Instr_sourceCode("}"));
@@ -588,236 +622,231 @@ SourceLineList Parser::getBracedCode( SourceLineList::const_iterator * it, Sourc
 }
 
 
-void Parser::processStatement( const QString & name, const OutputFieldMap & fieldMap )
+void Parser::processStatement( StatementDefinition::Keyword keyword, const OutputFieldMap & fieldMap )
 {
-	// Name is guaranteed to be something known, the calling
-	// code has taken care of that. Also fieldMap is guaranteed to contain
-	// all required fields.
+	// The calling code has looked up the keyword from the statement
+	// definitions. Also fieldMap is guaranteed to contain all required fields.
 
-	if ( name == "goto" )
-		m_pPic->Sgoto(fieldMap["label"].string());
+	switch ( keyword )
+	{
+		case StatementDefinition::Goto:
+			m_pPic->Sgoto(fieldMap["label"].string());
+			break;
 	
-	else if ( name == "call" )
-		m_pPic->Scall(fieldMap["label"].string());
+		case StatementDefinition::Call:
+			m_pPic->Scall(fieldMap["label"].string());
+			break;
 	
-	else if ( name == "while" )
-		m_pPic->Swhile( parseWithChild(fieldMap["code"].bracedCode() ), fieldMap["expression"].string() );
+		case StatementDefinition::While:
+			m_pPic->Swhile( parseWithChild(fieldMap["code"].bracedCode() ), fieldMap["expression"].string() );
+			break;
 	
-	else if ( name == "repeat" )
-		m_pPic->Srepeat( parseWithChild(fieldMap["code"].bracedCode() ), fieldMap["expression"].string() );
+		case StatementDefinition::Repeat:
+			m_pPic->Srepeat( parseWithChild(fieldMap["code"].bracedCode() ), fieldMap["expression"].string() );
+			break;
 	
-	else if ( name == "if" )
-		m_pPic->Sif(
-				parseWithChild(fieldMap["ifCode"].bracedCode() ),
-				parseWithChild(fieldMap["elseCode"].bracedCode() ),
-				fieldMap["expression"].string() );
+		case StatementDefinition::If:
+			m_pPic->Sif(
+					parseWithChild(fieldMap["ifCode"].bracedCode() ),
+					parseWithChild(fieldMap["elseCode"].bracedCode() ),
+					fieldMap["expression"].string() );
+			break;
 	
-	else if ( name == "sub" || name == "subroutine" )
-	{	
-		if(!m_bPassedEnd)
-		{
-			mistake( Microbe::InterruptBeforeEnd );
-		}
-		else
-		{
-			m_pPic->Ssubroutine( fieldMap["label"].string(), parseWithChild( fieldMap["code"].bracedCode() ) );
-		}
-	}
-	else if( name == "interrupt" )
-	{	
-		QString interrupt = fieldMap["label"].string();
-		
-		if(!m_bPassedEnd)
-		{
-			mistake( Microbe::InterruptBeforeEnd );
-		}
-		else if( !m_pPic->isValidInterrupt( interrupt ) )
-		{
-			mistake( Microbe::InvalidInterrupt );
-		}
-		else if ( mb->isInterruptUsed( interrupt ) )
-		{
-			mistake( Microbe::InterruptRedefined );
-		}
-		else
+		case StatementDefinition::Subroutine:
+			if(!m_bPassedEnd)
+			{
+				mistake( Microbe::InterruptBeforeEnd );
+			}
+			else
+			{
+				m_pPic->Ssubroutine( fieldMap["label"].string(), parseWithChild( fieldMap["code"].bracedCode() ) );
+			}
+			break;
+			
+		case StatementDefinition::Interrupt:
 		{
-			mb->setInterruptUsed( interrupt );
-			m_pPic->Sinterrupt( interrupt, parseWithChild( fieldMap["code"].bracedCode() ) );
-		}
-	}
-	else if( name == "end" )
-	{
-		///TODO handle end if we are not in the top level
-		m_bPassedEnd = true;
-		m_pPic->Send();
-	}
-	else if( name == "for" )
-	{
-		QString step = fieldMap["stepExpression"].string();
-		bool stepPositive;
+			QString interrupt = fieldMap["label"].string();
 		
-		if( fieldMap["stepExpression"].found() )
-		{
-			if(step.left(1) == "+")
+			if(!m_bPassedEnd)
 			{
-				stepPositive = true;
-				step = step.mid(1).trimmed();
+				mistake( Microbe::InterruptBeforeEnd );
 			}
-			else if(step.left(1) == "-")
+			else if( !m_pPic->isValidInterrupt( interrupt ) )
 			{
-				stepPositive = false;
-				step = step.mid(1).trimmed();
+				mistake( Microbe::InvalidInterrupt );
 			}
-			else stepPositive = true;
-		}
-		else
-		{
-			step = "1";
-			stepPositive = true;
+			else if ( mb->isInterruptUsed( interrupt ) )
+			{
+				mistake( Microbe::InterruptRedefined );
+			}
+			else
+			{
+				mb->setInterruptUsed( interrupt );
+				m_pPic->Sinterrupt( interrupt, parseWithChild( fieldMap["code"].bracedCode() ) );
+			}
+			break;
 		}
 		
-		QString variable = fieldMap["initExpression"].string().mid(0,fieldMap["initExpression"].string().indexOf("=")).trimmed();
-		QString endExpr = variable+ " <= " + fieldMap["toExpression"].string().trimmed();
+		case StatementDefinition::End:
+			///TODO handle end if we are not in the top level
+			m_bPassedEnd = true;
+			m_pPic->Send();
+			break;
+			
+		case StatementDefinition::For:
+		{
+			QString step = fieldMap["stepExpression"].string();
+			bool stepPositive;
 		
-		if( fieldMap["stepExpression"].found() )
-		{	
-			bool isConstant;
-			step = processConstant(step,&isConstant);
-			if( !isConstant )
-				mistake( Microbe::NonConstantStep );
-		}
+			if( fieldMap["stepExpression"].found() )
+			{
+				if(step.left(1) == "+")
+				{
+					stepPositive = true;
+					step = step.mid(1).trimmed();
+				}
+				else if(step.left(1) == "-")
+				{
+					stepPositive = false;
+					step = step.mid(1).trimmed();
+				}
+				else stepPositive = true;
+			}
+			else
+			{
+				step = "1";
+				stepPositive = true;
+			}
 		
-		SourceLineList tempList;
-		tempList << SourceLine( fieldMap["initExpression"].string(), 0, -1 );
+			QString variable = fieldMap["initExpression"].string().mid(0,fieldMap["initExpression"].string().indexOf("=")).trimmed();
+			QString endExpr = variable+ " <= " + fieldMap["toExpression"].string().trimmed();
 		
-		m_pPic->Sfor( parseWithChild( fieldMap["code"].bracedCode() ), parseWithChild( tempList ), endExpr, variable, step, stepPositive );
-	}
-	else if( name == "alias" )
-	{
-		// It is important to get this the right way round!
-		// The alias should be the key since two aliases could
-		// point to the same name.
-	
-		QString alias = fieldMap["alias"].string().trimmed();
-		QString dest = fieldMap["dest"].string().trimmed();
+			if( fieldMap["stepExpression"].found() )
+			{	
+				bool isConstant;
+				step = processConstant(step,&isConstant);
+				if( !isConstant )
+					mistake( Microbe::NonConstantStep );
+			}
 		
-		// Check to see whether or not we've already aliased it...
-// 		if ( mb->alias(alias) != alias )
-// 			mistake( Microbe::AliasRedefined );
-// 		else
-			mb->addAlias( alias, dest );
-	}
-	else if( name == "increment" )
-	{
-		QString variableName = fieldMap["variable"].string();
+			SourceLineList tempList;
+			tempList << SourceLine( fieldMap["initExpression"].string(), 0, -1 );
 		
-		if ( !mb->isVariableKnown( variableName ) )
-			mistake( Microbe::UnknownVariable );
-		else if ( !mb->variable( variableName ).isWritable() )
-			mistake( Microbe::ReadOnlyVariable, variableName );
-		else
-			m_pPic->SincVar( variableName );
-	}
-	else if( name == "decrement" )
-	{
-		QString variableName = fieldMap["variable"].string();
+			m_pPic->Sfor( parseWithChild( fieldMap["code"].bracedCode() ), parseWithChild( tempList ), endExpr, variable, step, stepPositive );
+			break;
+		}
 		
-		if ( !mb->isVariableKnown( variableName ) )
-			mistake( Microbe::UnknownVariable );
-		else if ( !mb->variable( variableName ).isWritable() )
-			mistake( Microbe::ReadOnlyVariable, variableName );
-		else
-			m_pPic->SdecVar( variableName );
-	}
-	else if( name == "rotateleft" )
-	{
-		QString variableName = fieldMap["variable"].string();
+		case StatementDefinition::Alias:
+		{
+			// It is important to get this the right way round!
+			// The alias should be the key since two aliases could
+			// point to the same name.
+	
+			QString alias = fieldMap["alias"].string().trimmed();
+			QString dest = fieldMap["dest"].string().trimmed();
 		
-		if ( !mb->isVariableKnown( variableName ) )
-			mistake( Microbe::UnknownVariable );
-		else if ( !mb->variable( variableName ).isWritable() )
-			mistake( Microbe::ReadOnlyVariable, variableName );
-		else
-			m_pPic->SrotlVar( variableName );
-	}
-	else if( name == "rotateright" )
-	{
-		QString variableName = fieldMap["variable"].string();
+			// Check to see whether or not we've already aliased it...
+// 			if ( mb->alias(alias) != alias )
+// 				mistake( Microbe::AliasRedefined );
+// 			else
+				mb->addAlias( alias, dest );
+			break;
+		}
 		
-		if ( !mb->isVariableKnown( variableName ) )
-			mistake( Microbe::UnknownVariable );
-		else if ( !mb->variable( variableName ).isWritable() )
-			mistake( Microbe::ReadOnlyVariable, variableName );
-		else
-			m_pPic->SrotrVar( variableName );
-	}
-	else if( name == "asm" )
-	{	
-		m_pPic->Sasm( SourceLine::toStringList( fieldMap["code"].bracedCode() ).join("\n") );
-	}
-	else if( name == "delay" )
-	{
-		// This is one of the rare occasions that the number will be bigger than a byte,
-		// so suppressNumberTooBig must be used
-		bool isConstant;
-		QString delay = processConstant(fieldMap["expression"].string(),&isConstant,true);
-		if (!isConstant)
-			mistake( Microbe::NonConstantDelay );
-// 		else m_pPic->Sdelay( fieldMap["expression"].string(), "");
-		else
+		case StatementDefinition::Increment:
+		case StatementDefinition::Decrement:
+		case StatementDefinition::RotateLeft:
+		case StatementDefinition::RotateRight:
 		{
-			// TODO We should use the "delay" string returned by processConstant - not the expression (as, e.g. 2*3 won't be ok)
-			int length_ms = literalToInt( fieldMap["expression"].string() );
-			if ( length_ms >= 0 )
-				m_pPic->Sdelay( length_ms * 1000 ); // Pause the delay length in microseconds
+			QString variableName = fieldMap["variable"].string();
+		
+			if ( !mb->isVariableKnown( variableName ) )
+				mistake( Microbe::UnknownVariable );
+			else if ( !mb->variable( variableName ).isWritable() )
+				mistake( Microbe::ReadOnlyVariable, variableName );
+			else if ( keyword == StatementDefinition::Increment )
+				m_pPic->SincVar( variableName );
+			else if ( keyword == StatementDefinition::Decrement )
+				m_pPic->SdecVar( variableName );
+			else if ( keyword == StatementDefinition::RotateLeft )
+				m_pPic->SrotlVar( variableName );
 			else
-				mistake( Microbe::NonConstantDelay );
+				m_pPic->SrotrVar( variableName );
+			break;
 		}
-	}
-	else if ( name == "keypad" || name == "sevenseg" )
-	{
-		//QStringList pins = QStringList::split( ' ', fieldMap["pinlist"].string() );
-        QStringList pins = fieldMap["pinlist"].string().split(' ', QString::SkipEmptyParts);
-		QString variableName = fieldMap["name"].string();
 		
-		if ( mb->isVariableKnown( variableName ) )
+		case StatementDefinition::Asm:
+			m_pPic->Sasm( SourceLine::toStringList( fieldMap["code"].bracedCode() ).join("\n") );
+			break;
+			
+		case StatementDefinition::Delay:
 		{
-			mistake( Microbe::VariableRedefined, variableName );
-			return;
+			// This is one of the rare occasions that the number will be bigger than a byte,
+			// so suppressNumberTooBig must be used
+			bool isConstant;
+			QString delay = processConstant(fieldMap["expression"].string(),&isConstant,true);
+			if (!isConstant)
+				mistake( Microbe::NonConstantDelay );
+// 			else m_pPic->Sdelay( fieldMap["expression"].string(), "");
+			else
+			{
+				// TODO We should use the "delay" string returned by processConstant - not the expression (as, e.g. 2*3 won't be ok)
+				int length_ms = literalToInt( fieldMap["expression"].string() );
+				if ( length_ms >= 0 )
+					m_pPic->Sdelay( length_ms * 1000 ); // Pause the delay length in microseconds
+				else
+					mistake( Microbe::NonConstantDelay );
+			}
+			break;
 		}
 		
-		PortPinList pinList;
-		
-		QStringList::iterator end = pins.end();
-		for ( QStringList::iterator it = pins.begin(); it != end; ++it )
+		case StatementDefinition::Keypad:
+		case StatementDefinition::SevenSeg:
 		{
-			PortPin portPin = m_pPic->toPortPin(*it);
-			if ( portPin.pin() == -1 )
+			//QStringList pins = QStringList::split( ' ', fieldMap["pinlist"].string() );
+			QStringList pins = fieldMap["pinlist"].string().split(' ', QString::SkipEmptyParts);
+			QString variableName = fieldMap["name"].string();
+		
+			if ( mb->isVariableKnown( variableName ) )
 			{
-				// Invalid port/pin
-				//TODO mistake
+				mistake( Microbe::VariableRedefined, variableName );
 				return;
 			}
-			pinList << portPin;
-		}
 		
-		if ( name == "keypad" )
-		{
-			Variable v( Variable::keypadType, variableName );
-			v.setPortPinList( pinList );
-			mb->addVariable( v );
-		}
+			PortPinList pinList;
 		
-		else // name == "sevenseg"
-		{
-			if ( pinList.size() != 7 )
-				mistake( Microbe::InvalidPinMapSize );
-			else
+			QStringList::iterator end = pins.end();
+			for ( QStringList::iterator it = pins.begin(); it != end; ++it )
 			{
-				Variable v( Variable::sevenSegmentType, variableName );
+				PortPin portPin = m_pPic->toPortPin(*it);
+				if ( portPin.pin() == -1 )
+				{
+					// Invalid port/pin
+					//TODO mistake
+					return;
+				}
+				pinList << portPin;
+			}
+		
+			if ( keyword == StatementDefinition::Keypad )
+			{
+				Variable v( Variable::keypadType, variableName );
 				v.setPortPinList( pinList );
 				mb->addVariable( v );
 			}
+		
+			else // keyword == StatementDefinition::SevenSeg
+			{
+				if ( pinList.size() != 7 )
+					mistake( Microbe::InvalidPinMapSize );
+				else
+				{
+					Variable v( Variable::sevenSegmentType, variableName );
+					v.setPortPinList( pinList );
+					mb->addVariable( v );
+				}
+			}
+			break;
 		}
 	}
 }
@@ -995,6 +1024,30 @@ Field::Field( Type type, const QString & key, const QString & string, bool compu
 	m_key = key;
 	m_string = string;
 }
+
+
+static bool isWordChar( const QChar & c )
+{
+	return c.isLetterOrNumber() || c == '_';
+}
+
+
+int Field::indexIn( const QString & line ) const
+{
+	const int length = m_string.length();
+	
+	for ( int pos = line.indexOf( m_string ); pos != -1; pos = line.indexOf( m_string, pos + 1 ) )
+	{
+		const int end = pos + length;
+		if ( pos > 0 && isWordChar( line[pos-1] ) )
+			continue;
+		if ( end < line.length() && isWordChar( line[end] ) )
+			continue;
+		return pos;
+	}
+	
+	return -1;
+}
 //END class Field
 
 
@@ -25,6 +25,7 @@
 #include "instruction.h"
 #include "microbe.h"
 
+#include <qhash.h>
 #include <qmap.h>
 #include <qlist.h>
 
@@ -144,6 +145,11 @@ class Field
 		 * is marked compulsory or not.)
 		 */
 		bool compulsory() const { return m_compulsory; }
+		/**
+		 * @return the position of the first occurrence of string() as a whole
+		 * word in line, or -1 if it does not occur.
+		 */
+		int indexIn( const QString & line ) const;
 	
 	private:
 		Type m_type;
@@ -182,8 +188,40 @@ class OutputField
 		bool m_found;
 };
 
-typedef QList<Field> StatementDefinition;
-typedef QMap<QString,StatementDefinition> DefinitionMap;
+/**
+The fields that follow a statement keyword, and which statement it is.
+*/
+class StatementDefinition : public QList<Field>
+{
+	public:
+		enum Keyword
+		{
+			Goto,
+			Call,
+			While,
+			End,
+			Subroutine,
+			Interrupt,
+			Alias,
+			If,
+			For,
+			Decrement,
+			Increment,
+			RotateLeft,
+			RotateRight,
+			Asm,
+			Delay,
+			Repeat,
+			SevenSeg,
+			Keypad
+		};
+		
+		StatementDefinition() : keyword(Goto) {}
+		
+		Keyword keyword;
+};
+
+typedef QHash<QString,StatementDefinition> DefinitionMap;
 typedef QMap<QString,OutputField> OutputFieldMap;
 
 
@@ -273,12 +311,17 @@ class Parser
 		/**
 		 * This is called when the bulk of the actual parsing has been carried
 		 * out and is ready to be turned into assembly code.
-		 * @param name Name of the statement to be processed
+		 * @param keyword The statement to be processed
 		 * @param fieldMap A map of named fields as appropriate to the statement
 		 */
-		void processStatement( const QString & name, const OutputFieldMap & fieldMap );
+		void processStatement( StatementDefinition::Keyword keyword, const OutputFieldMap & fieldMap );
+		/**
+		 * The statement definitions, keyed by the statement name. These are
+		 * created once and shared by all parsers.
+		 */
+		static const DefinitionMap & definitionMap();
+		static DefinitionMap createDefinitionMap();
 
-		DefinitionMap m_definitionMap;
 		PIC14 * m_pPic;
 		bool m_bPassedEnd;
 		Microbe * mb;
@@ -25,6 +25,10 @@
 #include <qdesktopwidget.h>
 
 
+#include <qset.h>
+#include <qvector.h>
+
+#include <limits>
 #include <stdlib.h>
 
 using namespace std;
@@ -305,6 +309,7 @@ KtlQCanvas::~KtlQCanvas()
 	KtlQCanvasItemList all = allItems();
 	for (KtlQCanvasItemList::Iterator it=all.begin(); it!=all.end(); ++it)
 		delete *it;
+	invalidateStaticLayer();
 	delete [] chunks;
 	delete [] grid;
 }
@@ -362,6 +367,7 @@ void KtlQCanvas::resize( const QRect & newSize )
 		}
 	}
 
+	invalidateStaticLayer();
 	initChunkSize( newSize );
 	KtlQCanvasChunk* newchunks = new KtlQCanvasChunk[m_chunkSize.width()*m_chunkSize.height()];
 	m_size = newSize;
@@ -401,6 +407,7 @@ void KtlQCanvas::retune(int chunksze, int mxclusters)
 
 		chunksize=chunksze;
 
+		invalidateStaticLayer();
 		initChunkSize( m_size );
 		KtlQCanvasChunk* newchunks = new KtlQCanvasChunk[m_chunkSize.width()*m_chunkSize.height()];
 		delete [] chunks;
@@ -547,7 +554,13 @@ void KtlQCanvas::drawViewArea( KtlQCanvasView* view, QPainter* p, const QRect& v
 		p->setWorldMatrix( wm*twm );
 	
 		p->setBrushOrigin(tl.x(), tl.y());
-		drawCanvasArea(ivr,p,false);
+
+		// The static layer is only kept at the canvas' own scale
+		if ( wm.m11() == 1.0 && wm.m22() == 1.0 && wm.m12() == 0.0 && wm.m21() == 0.0
+			&& wm.dx() == qRound(wm.dx()) && wm.dy() == qRound(wm.dy()) )
+			drawCachedArea(ivr,*p);
+		else
+			drawCanvasArea(ivr,p,false);
 	}
 }
 
@@ -585,8 +598,11 @@ void KtlQCanvas::update()
 				QRect r = changeBounds(view->inverseWorldMatrix().mapRect(area));
 				if ( !r.isEmpty() )
 				{
-                    // as of my testing, drawing below always fails, so just post for an update event to the widget
-                    view->viewport()->update();
+                    // as of my testing, drawing below always fails, so just post for an update event to the widget,
+                    // limited to the changed area (mapped to viewport co-ordinates, with a pixel of slack for rounding)
+                    QRect damaged = wm.mapRect(r).adjusted(-1, -1, 1, 1);
+                    damaged.translate(view->contentsToViewport(QPoint(0,0)));
+                    view->viewport()->update(damaged);
 
 #if 0
                     //view->viewport()->setAttribute(Qt::WA_PaintOutsidePaintEvent, true); // note: remove this when possible
@@ -633,6 +649,30 @@ void KtlQCanvas::setAllChanged()
 	views that are showing it when update() is called next.
  */
 void KtlQCanvas::setChanged(const QRect& area)
+{
+	setDynamicChanged(area);
+
+	// We don't know what changed, so assume it was something in the static layer
+	QRect thearea = area.intersect( m_size );
+	if ( thearea.isEmpty() || m_staticLayer.isEmpty() )
+		return;
+
+	const int blockSize = staticBlockChunks() * chunksize;
+	const int bx1 = roundDown( thearea.left(), blockSize );
+	const int bx2 = roundDown( thearea.right(), blockSize );
+	const int by1 = roundDown( thearea.top(), blockSize );
+	const int by2 = roundDown( thearea.bottom(), blockSize );
+	for ( int bx = bx1; bx <= bx2; ++bx ) {
+		for ( int by = by1; by <= by2; ++by )
+			delete m_staticLayer.take( qMakePair( bx, by ) );
+	}
+}
+
+/*!
+	Marks \a area as changed, like setChanged(), but keeps the static layer.
+	Only use this when the change is to dynamic items.
+ */
+void KtlQCanvas::setDynamicChanged(const QRect& area)
 {
 	QRect thearea = area.intersect( m_size );
 
@@ -885,8 +925,9 @@ void KtlQCanvas::drawCanvasArea(const QRect& inarea, QPainter* p, bool double_bu
 		if ( !view->worldMatrix().isIdentity() )
 			continue; // Cannot paint those here (see callers).
 
-        // as of my testing, drawing below always fails, so just post for an update event to the widget
-        view->viewport()->update();
+        // as of my testing, drawing below always fails, so just post for an update event to the widget,
+        // for just the changed chunks (rgn is relative to area.topLeft())
+        view->viewport()->update( rgn.translated( view->contentsToViewport( area.topLeft() ) ) );
 
 #if 0
         //view->viewport()->setAttribute(Qt::WA_PaintOutsidePaintEvent, true); // note: remove this when possible
@@ -952,6 +993,155 @@ void KtlQCanvas::drawChangedItems( QPainter & painter )
 	}
 }
 
+
+void KtlQCanvas::drawCachedArea( const QRect & inarea, QPainter & painter )
+{
+	QRect area = inarea.intersect( m_size );
+	if ( area.isEmpty() )
+		return;
+
+	int lx = toChunkScaling(area.x());
+	int ly = toChunkScaling(area.y());
+	int mx = toChunkScaling(area.right());
+	int my = toChunkScaling(area.bottom());
+	if (mx>=m_chunkSize.right())
+		mx=m_chunkSize.right()-1;
+	if (my>=m_chunkSize.bottom())
+		my=m_chunkSize.bottom()-1;
+
+	for (int x=lx; x<=mx; x++) {
+		for (int y=ly; y<=my; y++)
+			setNeedRedraw( chunk(x,y).listPtr() );
+	}
+
+	// The items to draw, in order of depth
+	QVector<KtlQCanvasItem*> changed;
+	SortedCanvasItems::iterator end = m_canvasItems.end();
+	for ( SortedCanvasItems::iterator it = m_canvasItems.begin(); it != end; ++it ) {
+		KtlQCanvasItem * i = it->second;
+		if ( i->needRedraw() ) {
+			changed << i;
+			i->setNeedRedraw( false );
+		}
+	}
+
+	const int blockChunks = staticBlockChunks();
+	const int blockSize = blockChunks * chunksize;
+
+	// Each block caches a different set of static items, so an item spanning
+	// several blocks may be in the pixmap of one but not of the next. Drawing
+	// over each block only what it lacks, clipped to the block, paints every
+	// item exactly once.
+	for ( int bx = roundDown( lx, blockChunks ); bx <= roundDown( mx, blockChunks ); ++bx ) {
+		for ( int by = roundDown( ly, blockChunks ); by <= roundDown( my, blockChunks ); ++by ) {
+			KtlQCanvasStaticBlock * block = staticBlock( bx, by );
+			const QRect blockRect( bx*blockSize, by*blockSize, blockSize, blockSize );
+			const QRect target = blockRect & area;
+			painter.drawPixmap( target.topLeft(), block->pixmap, target.translated( -blockRect.topLeft() ) );
+
+			painter.save();
+			painter.setClipRect( target, Qt::IntersectClip );
+			QVector<KtlQCanvasItem*>::const_iterator changedEnd = changed.constEnd();
+			for ( QVector<KtlQCanvasItem*>::const_iterator it = changed.constBegin(); it != changedEnd; ++it ) {
+				if ( (*it)->isDynamic() || (*it)->z() >= block->dynamicZ )
+					(*it)->draw( painter );
+			}
+			painter.restore();
+		}
+	}
+
+	drawForeground( painter, area );
+}
+
+
+int KtlQCanvas::staticBlockChunks() const
+{
+	return qMax( 1, (KtlQCanvasStaticBlock::size + chunksize/2) / chunksize );
+}
+
+
+KtlQCanvasStaticBlock * KtlQCanvas::staticBlock( int bx, int by )
+{
+	const QPair<int,int> key( bx, by );
+	if ( KtlQCanvasStaticBlock * block = m_staticLayer.value( key ) )
+		return block;
+
+	const int blockChunks = staticBlockChunks();
+	const int blockSize = blockChunks * chunksize;
+
+	// Beyond the memory limit, start again
+	const int maxBlocks = qMax( 1, KtlQCanvasStaticBlock::maxBytes / (blockSize * blockSize * 4) );
+	if ( m_staticLayer.size() >= maxBlocks )
+		invalidateStaticLayer();
+
+	KtlQCanvasStaticBlock * block = new KtlQCanvasStaticBlock;
+	m_staticLayer.insert( key, block );
+
+	const QRect blockRect( bx*blockSize, by*blockSize, blockSize, blockSize );
+
+	// Static items stacked above a dynamic item have to be drawn after it, so
+	// only those below the lowest dynamic item in the block are cached.
+	SortedCanvasItems staticItems;
+	QSet<KtlQCanvasItem*> seen;
+	block->dynamicZ = numeric_limits<double>::max();
+
+	for ( int x = bx*blockChunks; x < (bx+1)*blockChunks; ++x ) {
+		for ( int y = by*blockChunks; y < (by+1)*blockChunks; ++y ) {
+			if ( !validChunk( x, y ) )
+				continue;
+
+			const KtlQCanvasItemList * list = chunk( x, y ).listPtr();
+			KtlQCanvasItemList::const_iterator end = list->end();
+			for ( KtlQCanvasItemList::const_iterator it = list->begin(); it != end; ++it ) {
+				KtlQCanvasItem * item = *it;
+				if ( seen.contains( item ) )
+					continue;
+				seen.insert( item );
+
+				if ( item->isDynamic() )
+					block->dynamicZ = qMin( block->dynamicZ, item->z() );
+				else
+					staticItems.insert( make_pair( item->z(), item ) );
+			}
+		}
+	}
+
+	block->pixmap = QPixmap( blockSize, blockSize );
+
+	QPainter painter;
+	if ( !painter.begin( &block->pixmap ) ) {
+		qWarning() << Q_FUNC_INFO << " painter not active";
+		return block;
+	}
+	painter.translate( -blockRect.x(), -blockRect.y() );
+
+	drawBackground( painter, blockRect );
+
+	SortedCanvasItems::iterator end = staticItems.end();
+	for ( SortedCanvasItems::iterator it = staticItems.begin(); it != end && it->first < block->dynamicZ; ++it )
+		it->second->draw( painter );
+
+	painter.end();
+	return block;
+}
+
+
+void KtlQCanvas::invalidateStaticChunk( int i, int j )
+{
+	if ( m_staticLayer.isEmpty() )
+		return;
+
+	const int blockChunks = staticBlockChunks();
+	delete m_staticLayer.take( qMakePair( roundDown( i, blockChunks ), roundDown( j, blockChunks ) ) );
+}
+
+
+void KtlQCanvas::invalidateStaticLayer()
+{
+	qDeleteAll( m_staticLayer );
+	m_staticLayer.clear();
+}
+
 /*!
 	\internal
 	This method to informs the KtlQCanvas that a given chunk is
@@ -999,6 +1189,7 @@ void KtlQCanvas::addItemToChunk(KtlQCanvasItem* g, int x, int y)
 {
 	if (validChunk(x, y) ) {
 		chunk(x,y).add(g);
+		invalidateStaticChunk(x, y);
 	}
 }
 
@@ -1013,6 +1204,7 @@ void KtlQCanvas::removeItemFromChunk(KtlQCanvasItem* g, int x, int y)
 {
 	if (validChunk(x,y)) {
 		chunk(x,y).remove(g);
+		invalidateStaticChunk(x, y);
 	}
 }
 
@@ -1027,6 +1219,7 @@ void KtlQCanvas::addItemToChunkContaining(KtlQCanvasItem* g, int x, int y)
 {
 	if ( onCanvas( x, y ) ) {
 		chunkContaining(x,y).add(g);
+		invalidateStaticChunk( toChunkScaling(x), toChunkScaling(y) );
 	}
 }
 
@@ -1041,6 +1234,7 @@ void KtlQCanvas::removeItemFromChunkContaining(KtlQCanvasItem* g, int x, int y)
 {
 	if ( onCanvas( x, y ) ) {
 		chunkContaining(x,y).remove(g);
+		invalidateStaticChunk( toChunkScaling(x), toChunkScaling(y) );
 	}
 }
 
@@ -1211,8 +1405,10 @@ void KtlQCanvas::setTile( int x, int y, int tilenum )
 	ushort& t = grid[x+y*htiles];
 	if ( t != tilenum ) {
 		t = tilenum;
-		if ( tilew == tileh && tilew == chunksize )
+		if ( tilew == tileh && tilew == chunksize ) {
 			setChangedChunk( x, y );	    // common case
+			invalidateStaticChunk( x, y );
+		}
 		else	setChanged( QRect(x*tilew,y*tileh,tilew,tileh) );
 	}
 }
@@ -18,12 +18,15 @@
 #include "qbrush.h"
 #include "qpen.h"
 #include "qlist.h"
+#include "qhash.h"
+#include "qpair.h"
 // #include "q3pointarray.h" // 2018.08.14
 
 #include "canvasitemlist.h"
 
 class KtlQCanvasView;
 class KtlQCanvasChunk;
+class KtlQCanvasStaticBlock;
 
 class KtlQCanvas : public QObject
 {
@@ -69,12 +72,27 @@ class KtlQCanvas : public QObject
 		virtual void setAllChanged();
 		virtual void setChanged(const QRect& area);
 		virtual void setUnchanged(const QRect& area);
+		/**
+		 * Like setChanged, but for changes that only affect the appearance of
+		 * dynamic items (see KtlQCanvasItem::setDynamic). The static layer
+		 * is kept, so the area is redrawn from the cached blocks plus the
+		 * dynamic items in it.
+		 */
+		virtual void setDynamicChanged(const QRect& area);
+		/**
+		 * Discards all of the cached static layer.
+		 */
+		void invalidateStaticLayer();
 
 		// These call setChangedChunk.
 		void addItemToChunk(KtlQCanvasItem*, int i, int j);
 		void removeItemFromChunk(KtlQCanvasItem*, int i, int j);
 		void addItemToChunkContaining(KtlQCanvasItem*, int x, int y);
 		void removeItemFromChunkContaining(KtlQCanvasItem*, int x, int y);
+		/**
+		 * Discards the cached static layer block containing chunk (i, j).
+		 */
+		void invalidateStaticChunk(int i, int j);
 
 		KtlQCanvasItemList allItems();
 		KtlQCanvasItemList collisions( const QPoint&) /* const */ ;
@@ -120,6 +138,22 @@ class KtlQCanvas : public QObject
 		void drawChanges(const QRect& inarea);
 		void drawChangedItems( QPainter & painter );
 		void setNeedRedraw( const KtlQCanvasItemList * list );
+		/**
+		 * Draws the area (in canvas coordinates) from the cached static layer,
+		 * and then over each block the dynamic items and those static items
+		 * that are stacked above a dynamic item in that block. Only used for
+		 * painters that are not scaled.
+		 */
+		void drawCachedArea( const QRect & inarea, QPainter & painter );
+		/**
+		 * @return the static layer block (bx, by), rendering it if needed.
+		 */
+		KtlQCanvasStaticBlock * staticBlock( int bx, int by );
+		/**
+		 * @return the number of chunks along each side of a static layer
+		 * block.
+		 */
+		int staticBlockChunks() const;
 
 		QPixmap offscr;
 		int chunksize;
@@ -131,6 +165,9 @@ class KtlQCanvas : public QObject
 		SortedCanvasItems m_canvasItems;
 		QList<KtlQCanvasView*> m_viewList;
 
+		/// Retained background and static items, in blocks of whole chunks
+		QHash< QPair<int,int>, KtlQCanvasStaticBlock* > m_staticLayer;
+
 		void initTiles(QPixmap p, int h, int v, int tilewidth, int tileheight);
 		ushort *grid;
 		ushort htiles;
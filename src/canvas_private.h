@@ -15,6 +15,7 @@
 
 #include "qbitmap.h"
 #include "qimage.h"
+#include "qpixmap.h"
 #include "ktlq3polygonscanner.h"
 #include "canvasitems.h"
 
@@ -219,6 +220,32 @@ private:
 
 
 
+/**
+A block of the retained static layer of a canvas: the background plus the
+static items below every dynamic item in the block, rendered once and reused
+for repaints until something static in the block changes.
+
+Blocks are whole chunks, as near to size pixels along each side as the chunk
+size of the canvas allows, so that changing a static item only re-renders a
+small area. The canvas keeps at most maxBytes worth of blocks.
+*/
+class KtlQCanvasStaticBlock
+{
+public:
+	/// Preferred length of a side of a block, in pixels
+	static const int size = 256;
+	/// Memory the blocks of a canvas may use, assuming 32 bits per pixel
+	static const int maxBytes = 64 * 1024 * 1024;
+
+	KtlQCanvasStaticBlock() : dynamicZ(0) { }
+
+	QPixmap pixmap;
+	/// Items at or above this depth are not in the pixmap
+	double dynamicZ;
+};
+
+
+
 class KtlQCanvasPolygonScanner : public KtlQ3PolygonScanner
 {
 	KtlQPolygonalProcessor& processor;
@@ -25,7 +25,7 @@ static bool isCanvasDebugEnabled() {
 
 KtlQCanvasItem::KtlQCanvasItem(KtlQCanvas* canvas)
     : val(false), myx(0), myy(0), myz(0), cnv(canvas),
-     ext(0), m_bNeedRedraw(true), vis(false), sel(false)
+     ext(0), m_bNeedRedraw(true), m_bDynamic(false), vis(false), sel(false)
 {
     if (isCanvasDebugEnabled()) {
         qDebug() << Q_FUNC_INFO << " this=" << this;
@@ -126,6 +126,17 @@ void KtlQCanvasItem::setVisible(bool yes)
 }
 
 
+void KtlQCanvasItem::setDynamic(bool yes)
+{
+    if (m_bDynamic != yes) {
+        // Re-adding to the chunks discards the cached static layer underneath
+        removeFromChunks();
+        m_bDynamic = yes;
+        addToChunks();
+    }
+}
+
+
 void KtlQCanvasItem::setSelected(const bool yes)
 {
     if ((bool)sel!=yes) {
@@ -263,8 +274,11 @@ void KtlQCanvasItem::changeChunks()
         if (!val)
             addToChunks();
         QPolygon pa = chunks();
-        for (int i=0; i<(int)pa.count(); i++)
+        for (int i=0; i<(int)pa.count(); i++) {
             canvas()->setChangedChunk(pa[i].x(),pa[i].y());
+            if (!m_bDynamic)
+                canvas()->invalidateStaticChunk(pa[i].x(),pa[i].y());
+        }
     }
 }
 
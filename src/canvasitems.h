@@ -76,6 +76,14 @@ class KtlQCanvasItem : public QObject
         bool needRedraw() const { return m_bNeedRedraw; }
         void setNeedRedraw( const bool needRedraw ) { m_bNeedRedraw = needRedraw; }
 
+        /**
+         * Dynamic items are those whose appearance changes while simulating
+         * (e.g. voltage colors). They are always drawn on top of the canvas'
+         * cached static layer, instead of being part of it.
+         */
+        virtual void setDynamic(bool yes);
+        bool isDynamic() const { return m_bDynamic; }
+
     protected:
         void update() { changeChunks(); }
 
@@ -93,6 +101,7 @@ class KtlQCanvasItem : public QObject
         KtlQCanvasItemExtra *ext;
         KtlQCanvasItemExtra& extra();
         bool m_bNeedRedraw;
+        bool m_bDynamic;
         bool vis;
         bool sel;
 
@@ -21,6 +21,7 @@
 
 #include <kdebug.h>
 #include <qpainter.h>
+#include <qvector.h>
 
 #include <cstdlib>
 #include <cmath>
@@ -43,6 +44,8 @@ Connector::Connector(Node * /*startNode*/, Node * /*endNode*/, ICNDocument *icnD
     qDebug() << Q_FUNC_INFO << " this=" << this;
 
 	m_currentAnimationOffset = 0.0;
+	m_drawnAnimationPhase = 0;
+	m_bCurrentVisible = false;
 	p_parentContainer = 0;
 	p_nodeGroup    = 0;
 	b_semiHidden   = false;
@@ -472,6 +475,14 @@ Wire *Connector::wire(unsigned num) const {
     return (num < m_wires.size()) ? m_wires[num] : 0;
 }
 
+void Connector::setDynamic(bool yes) {
+	KtlQCanvasPolygon::setDynamic(yes);
+
+	const ConnectorLineList::iterator end = m_connectorLineList.end();
+	for (ConnectorLineList::iterator it = m_connectorLineList.begin(); it != end; ++it)
+		(*it)->setDynamic(yes);
+}
+
 void Connector::setSelected(bool yes) {
 	if (!canvas() || isSelected() == yes) return;
 
@@ -482,7 +493,7 @@ void Connector::setSelected(bool yes) {
 }
 
 
-void Connector::updateConnectorLines(bool forceRedraw) {
+void Connector::updateConnectorLines(bool redrawAnimation) {
 	QColor color;
 
 	if (b_semiHidden) color = Qt::gray;
@@ -494,12 +505,21 @@ void Connector::updateConnectorLines(bool forceRedraw) {
 
 	QPen pen(color, (numWires() > 1) ? 2 : 1);
 
-	bool animateWires = KTLConfig::animateWires();
+	// Connectors with too little current to see are drawn as plain lines
+	const bool animateCurrent = KTLConfig::animateWires() && m_bCurrentVisible;
+
+	// The dashes are drawn at whole pixels, so they only move when the floor
+	// of the offset does
+	const int animationPhase = int(std::floor(m_currentAnimationOffset));
+	const bool forceRedraw = redrawAnimation && animateCurrent && (animationPhase != m_drawnAnimationPhase);
+	if (redrawAnimation)
+		m_drawnAnimationPhase = animationPhase;
 
 	ConnectorLineList::iterator end = m_connectorLineList.end();
 
 	for (ConnectorLineList::iterator it = m_connectorLineList.begin(); it != end; ++it) {
-		(*it)->setAnimateCurrent(animateWires);
+		const bool animationChanged = ((*it)->animateCurrent() != animateCurrent);
+		(*it)->setAnimateCurrent(animateCurrent);
 
 		KtlQCanvasPolygonalItem *item = static_cast<KtlQCanvasPolygonalItem*>(*it);
 
@@ -508,8 +528,11 @@ void Connector::updateConnectorLines(bool forceRedraw) {
 			    || (item->isVisible() != isVisible());
 
 		if (!changed) {
-			if (forceRedraw)
-				canvas()->setChanged(item->boundingRect());
+			if (forceRedraw || animationChanged) {
+				if (item->isDynamic())
+					canvas()->setDynamicChanged(item->boundingRect());
+				else	canvas()->setChanged(item->boundingRect());
+			}
 			continue;
 		}
 
@@ -539,13 +562,20 @@ void Connector::incrementCurrentAnimation(double deltaTime) {
 	double I_min = 1e-4;
 	double sf    = 3.0; // scaling factor
 
+	m_bCurrentVisible = false;
+
 	for (unsigned i = 0; i < m_wires.size(); ++i) {
 		if (!m_wires[i]) continue;
 
 		double I = m_wires[i]->current();
 		double sign  = (I > 0) ? 1 : -1;
 		double I_abs = I * sign;
-		double prop  = (I_abs > I_min) ? std::log(I_abs / I_min) : 0.0;
+
+		// Currents below I_min would not move the dashes anyway
+		if (I_abs <= I_min) continue;
+
+		m_bCurrentVisible = true;
+		double prop = std::log(I_abs / I_min);
 
 		m_currentAnimationOffset += deltaTime * sf * std::pow(prop, 1.3) * sign;
 	}
@@ -560,24 +590,8 @@ ConnectorLine::ConnectorLine(Connector * connector, int pixelOffset)
     qDebug() << Q_FUNC_INFO << " this=" << this;
 	m_pConnector = connector;
 	m_pixelOffset = pixelOffset;
-}
-
-
-/**
- * @returns x, possibly moving it to the closest bound if it is out of bounds.
- */
-int boundify(int x, int bound1, int bound2) {
-	if (bound2 < bound1) {
-		// swap bounds
-		int temp = bound2;
-		bound2   = bound1;
-		bound1   = temp;
-	}
-
-	// now, have bound1 <= bound2
-	if (x < bound1)	     return bound1;
-	else if (x > bound2) return bound2;
-	else	return x;
+	m_bAnimateCurrent = false;
+	setDynamic(connector->isDynamic());
 }
 
 
@@ -590,61 +604,22 @@ void ConnectorLine::drawShape(QPainter & p) {
 	int ss = 3; // segment spacing
 	int sl = 13; // segment length (includes segment spacing)
 
-	int offset = int(m_pConnector->currentAnimationOffset() - m_pixelOffset);
+	int offset = int(std::floor(m_pConnector->currentAnimationOffset())) - m_pixelOffset;
 	offset = ((offset % sl) - sl) % sl;
 
-	int x1 = startPoint().x();
-	int y1 = startPoint().y();
-	int x2 = endPoint().x();
-	int y2 = endPoint().y();
-
+	// The segments are drawn as a single dashed line. The dash pattern and
+	// offset of a pen are in units of its width.
 	QPen pen = p.pen();
-// 	pen.setStyle( Qt::DashDotLine );
-	p.setPen(pen);
+	const qreal width = (pen.widthF() > 0) ? pen.widthF() : 1.0;
 
-	if (x1 == x2) {
-		int _x = int(x() + x1);
-		int y_end = int(y() + y2);
-
-		if (y1 > y2) {
-			// up connector line
-			for (int _y = int(y() + y1 - offset); _y >= y_end; _y -= sl) {
-				int y_1 = boundify(_y, int(y() + y1), y_end);
-				int y_2 = boundify(_y - (sl - ss), int(y() + y1), y_end);
-				p.drawLine(_x, y_1, _x, y_2);
-			}
-		} else {
-			// down connector line
-			for (int _y = int(y() + y1 + offset); _y <= y_end; _y += sl) {
-				int y_1 = boundify(_y, int(y() + y1), y_end);
-				int y_2 = boundify(_y + (sl - ss), int(y() + y1), y_end);
-				p.drawLine(_x, y_1, _x, y_2);
-			}
-		}
-	} else {
-		// y1 == y2
-
-		int _y    = int(y() + y1);
-		int x_end = int(x() + x2);
-
-		if (x1 > x2) {
-			// left connector line
-			int x_start = int(x() + x1 - offset);
+	QVector<qreal> dashes;
+	dashes << (sl - ss) / width << ss / width;
+	pen.setDashPattern(dashes);
+	pen.setDashOffset(-offset / width);
+	pen.setCapStyle(Qt::FlatCap);
+	p.setPen(pen);
 
-			for (int _x = x_start; _x >= x_end; _x -= sl) {
-				int x_1 = boundify(_x, int(x() + x1), x_end);
-				int x_2 = boundify(_x - (sl - ss), int(x() + x1), x_end);
-				p.drawLine(x_1, _y, x_2, _y);
-			}
-		} else {
-			// right connector line
-			for (int _x = int(x() + x1 + offset); _x <= x_end; _x += sl) {
-				int x_1 = boundify(_x, int(x() + x1), x_end);
-				int x_2 = boundify(_x + (sl - ss), int(x() + x1), x_end);
-				p.drawLine(x_1, _y, x_2, _y);
-			}
-		}
-	}
+	KtlQCanvasLine::drawShape(p);
 }
 //END class ConnectorLine
 
@@ -167,6 +167,10 @@ public:
 	 */
 	void translateRoute(int dx, int dy);
 	virtual void setVisible(bool yes);
+	/**
+	 * Also sets the connector lines to be dynamic or not.
+	 */
+	virtual void setDynamic(bool yes);
 
 	/**
 	Methods relating to wire lists
@@ -177,7 +181,18 @@ public:
 		return (num < m_wires.size()) ? m_wires[num] : 0;
 	} */
 
-	void updateConnectorLines(bool forceRedraw = false);
+	/**
+	 * Updates the pen, z and visibility of the connector lines.
+	 * @param redrawAnimation if true, the lines are also redrawn when the
+	 * current animation has moved by at least one pixel since they were last
+	 * drawn.
+	 */
+	void updateConnectorLines(bool redrawAnimation = false);
+
+	/**
+	 * @return the bounding rect of the drawn connector lines.
+	 */
+	QRect linesBoundingRect() const { return m_oldBoundRect; }
 
 	/**
 	 * Modular offset of moving dots in connector, indicating current (in
@@ -187,7 +202,8 @@ public:
 
 	/**
 	 * Increases the currentAnimationOffset according to the current flowing in
-	 * the connector and deltaTime.
+	 * the connector and deltaTime. Also updates whether the current is large
+	 * enough to be animated at all.
 	 */
 	void incrementCurrentAnimation(double deltaTime);
 
@@ -213,6 +229,10 @@ private:
 	bool b_pointsAdded;
 
 	double m_currentAnimationOffset;
+	/// floor of m_currentAnimationOffset when the lines were last redrawn
+	int m_drawnAnimationPhase;
+	/// whether the current in any of the wires is large enough to animate
+	bool m_bCurrentVisible;
 
 	NodeGroup   *p_nodeGroup;
 	CNItem      *p_parentContainer;
@@ -241,6 +261,7 @@ public:
 	Connector *parent() const { return m_pConnector; }
 
 	void setAnimateCurrent(bool animateCurrent) { m_bAnimateCurrent = animateCurrent; }
+	bool animateCurrent() const { return m_bAnimateCurrent; }
 
 protected:
 	virtual void drawShape(QPainter &p);
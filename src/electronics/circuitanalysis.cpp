@@ -0,0 +1,710 @@
+/***************************************************************************
+ *   Copyright (C) 2026 by the KTechLab developers                         *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ ***************************************************************************/
+
+#include "circuit.h"
+#include "circuitanalysis.h"
+#include "circuitdocument.h"
+#include "component.h"
+#include "elementset.h"
+#include "pin.h"
+#include "probe.h"
+#include "simulator.h"
+#include "voltagesource.h"
+
+#include <klocalizedstring.h>
+
+#include <qfile.h>
+#include <qhash.h>
+#include <qrunnable.h>
+#include <qset.h>
+#include <qtextstream.h>
+#include <qthreadpool.h>
+
+#include <cmath>
+
+
+/**
+Does one run of a CircuitAnalysis on a pool thread.
+*/
+class AnalysisTask : public QRunnable
+{
+	public:
+		AnalysisTask( const CircuitAnalysis * analysis, int run, AnalysisRun * result )
+			: m_pAnalysis(analysis), m_run(run), m_pResult(result) {}
+
+		virtual void run() { m_pAnalysis->doRun( m_run, m_pResult ); }
+
+	protected:
+		const CircuitAnalysis * m_pAnalysis;
+		int m_run;
+		AnalysisRun * m_pResult;
+};
+
+
+/**
+SplitMix64; small, fast and good enough for picking component values. Each
+(run, variation) pair gets its own sequence, so the values do not depend on
+the order in which the pool threads get to the runs.
+*/
+static quint64 nextRandom( quint64 * state )
+{
+	quint64 z = (*state += Q_UINT64_C(0x9E3779B97F4A7C15));
+	z = (z ^ (z >> 30)) * Q_UINT64_C(0xBF58476D1CE4E5B9);
+	z = (z ^ (z >> 27)) * Q_UINT64_C(0x94D049BB133111EB);
+	return z ^ (z >> 31);
+}
+
+
+/**
+@return a uniformly distributed value in [0, 1)
+*/
+static double nextUniform( quint64 * state )
+{
+	return (nextRandom(state) >> 11) * (1.0 / 9007199254740992.0);
+}
+
+
+static QString csvField( const QString & field )
+{
+	if ( !field.contains(',') && !field.contains('"') )
+		return field;
+
+	QString quoted = field;
+	quoted.replace( "\"", "\"\"" );
+	return "\"" + quoted + "\"";
+}
+
+
+//BEGIN class ParameterVariation
+ParameterVariation::ParameterVariation()
+{
+	distribution = Uniform;
+	from = 0.0;
+	to = 0.0;
+	steps = 1;
+	tolerance = 0.05;
+}
+//END class ParameterVariation
+
+
+
+//BEGIN class ProbeMeasurement
+ProbeMeasurement::ProbeMeasurement()
+{
+	minimum = 0.0;
+	maximum = 0.0;
+	rms = 0.0;
+	finalValue = 0.0;
+	settlingTime = 0.0;
+}
+//END class ProbeMeasurement
+
+
+
+//BEGIN class AnalysisResults
+QVector<double> AnalysisResults::values( int probe, Quantity quantity ) const
+{
+	QVector<double> values;
+	if ( probe < 0 || probe >= probeNames.size() )
+		return values;
+
+	values.reserve( runs.size() );
+
+	const QVector<AnalysisRun>::const_iterator end = runs.end();
+	for ( QVector<AnalysisRun>::const_iterator it = runs.begin(); it != end; ++it )
+	{
+		const ProbeMeasurement & m = it->measurements[probe];
+		switch ( quantity )
+		{
+			case Minimum:
+				values << m.minimum;
+				break;
+			case Maximum:
+				values << m.maximum;
+				break;
+			case RMS:
+				values << m.rms;
+				break;
+			case FinalValue:
+				values << m.finalValue;
+				break;
+			case SettlingTime:
+				values << m.settlingTime;
+				break;
+		}
+	}
+
+	return values;
+}
+
+
+QVector<int> AnalysisResults::histogram( int probe, Quantity quantity, int bins, double * low, double * high ) const
+{
+	const QVector<double> data = values( probe, quantity );
+	if ( data.isEmpty() || bins <= 0 )
+		return QVector<int>();
+
+	double lo = data[0];
+	double hi = data[0];
+	for ( int i = 1; i < data.size(); ++i )
+	{
+		lo = qMin( lo, data[i] );
+		hi = qMax( hi, data[i] );
+	}
+
+	if (low)
+		*low = lo;
+	if (high)
+		*high = hi;
+
+	QVector<int> counts( bins, 0 );
+	const double width = (hi - lo) / bins;
+
+	for ( int i = 0; i < data.size(); ++i )
+	{
+		int bin = (width > 0.0) ? int( (data[i] - lo) / width ) : 0;
+		if ( bin >= bins )
+			bin = bins - 1;
+		counts[bin]++;
+	}
+
+	return counts;
+}
+
+
+QString AnalysisResults::toCsv() const
+{
+	QStringList header;
+	header << "run";
+	for ( int i = 0; i < parameterNames.size(); ++i )
+		header << csvField( parameterNames[i] );
+	header << "converged";
+	for ( int i = 0; i < probeNames.size(); ++i )
+	{
+		const QString & name = probeNames[i];
+		header << csvField( name + " min" ) << csvField( name + " max" ) << csvField( name + " rms" )
+			<< csvField( name + " final" ) << csvField( name + " settling time" );
+	}
+
+	QString csv = header.join(",") + "\n";
+
+	for ( int run = 0; run < runs.size(); ++run )
+	{
+		const AnalysisRun & r = runs[run];
+
+		QStringList row;
+		row << QString::number(run);
+		for ( int i = 0; i < r.parameters.size(); ++i )
+			row << QString::number( r.parameters[i], 'g', 10 );
+		row << (r.converged ? "1" : "0");
+		for ( int i = 0; i < r.measurements.size(); ++i )
+		{
+			const ProbeMeasurement & m = r.measurements[i];
+			row << QString::number( m.minimum, 'g', 10 ) << QString::number( m.maximum, 'g', 10 )
+				<< QString::number( m.rms, 'g', 10 ) << QString::number( m.finalValue, 'g', 10 )
+				<< QString::number( m.settlingTime, 'g', 10 );
+		}
+
+		csv += row.join(",") + "\n";
+	}
+
+	return csv;
+}
+
+
+bool AnalysisResults::saveCsv( const QString & path ) const
+{
+	QFile file( path );
+	if ( !file.open( QIODevice::WriteOnly ) )
+		return false;
+
+	QTextStream stream( &file );
+	stream << toCsv();
+	file.close();
+	return true;
+}
+//END class AnalysisResults
+
+
+
+//BEGIN class CircuitAnalysis
+CircuitAnalysis::CircuitAnalysis()
+{
+	m_monteCarloRuns = 1;
+	m_duration = 0.1;
+	m_settlingTolerance = 0.02;
+	m_seed = 0;
+	m_maxThreads = 0;
+	m_bPrepared = false;
+}
+
+
+CircuitAnalysis::~CircuitAnalysis()
+{
+}
+
+
+bool CircuitAnalysis::findField( const QString & property, Element::Type type, VariedField * field )
+{
+	*field = ElementValue;
+
+	if ( property == "resistance" )
+		return type == Element::Element_Resistance;
+
+	if ( property == "Capacitance" )
+		return type == Element::Element_Capacitance;
+
+	if ( property == "Inductance" )
+		return type == Element::Element_Inductance;
+
+	if ( property == "voltage" )
+		return type == Element::Element_VoltagePoint
+				|| type == Element::Element_VoltageSource
+				|| type == Element::Element_VoltageSignal;
+
+	if ( property == "current" )
+		return type == Element::Element_CurrentSource
+				|| type == Element::Element_CurrentSignal;
+
+	if ( type != Element::Element_Diode )
+		return false;
+
+	if ( property == "I_S" )
+		*field = DiodeSaturationCurrent;
+	else if ( property == "N" )
+		*field = DiodeEmissionCoefficient;
+	else if ( property == "V_B" )
+		*field = DiodeBreakdownVoltage;
+	else
+		return false;
+
+	return true;
+}
+
+
+double CircuitAnalysis::fieldValue( const NetlistElement & element, VariedField field )
+{
+	switch ( field )
+	{
+		case ElementValue:
+			return element.value;
+		case DiodeSaturationCurrent:
+			return element.diodeSettings.I_S;
+		case DiodeEmissionCoefficient:
+			return element.diodeSettings.N;
+		case DiodeBreakdownVoltage:
+			return element.diodeSettings.V_B;
+	}
+	return 0.0;
+}
+
+
+void CircuitAnalysis::setFieldValue( NetlistElement * element, VariedField field, double value )
+{
+	switch ( field )
+	{
+		case ElementValue:
+			element->value = value;
+			break;
+		case DiodeSaturationCurrent:
+			element->diodeSettings.I_S = value;
+			break;
+		case DiodeEmissionCoefficient:
+			element->diodeSettings.N = value;
+			break;
+		case DiodeBreakdownVoltage:
+			element->diodeSettings.V_B = value;
+			break;
+	}
+}
+
+
+bool CircuitAnalysis::prepare( CircuitDocument * document )
+{
+	m_bPrepared = false;
+	m_netlist = Netlist();
+	m_probes.clear();
+	m_targets.clear();
+	m_errorString = QString::null;
+
+	const CircuitList circuits = document->circuitList();
+	if ( circuits.isEmpty() )
+	{
+		m_errorString = i18n("The circuit has not been set up for simulation yet.");
+		return false;
+	}
+
+	// Find the elements in each circuit, and the circuits that can't be copied
+	QHash< Circuit*, ElementList > circuitElements;
+	QHash< Circuit*, QString > unsupported;
+	const ComponentList components = document->componentList();
+
+	const ComponentList::const_iterator componentsEnd = components.end();
+	for ( ComponentList::const_iterator it = components.begin(); it != componentsEnd; ++it )
+	{
+		const ElementMapList & elementMaps = (*it)->elementMapList();
+		const ElementMapList::const_iterator mapsEnd = elementMaps.end();
+		for ( ElementMapList::const_iterator mit = elementMaps.begin(); mit != mapsEnd; ++mit )
+		{
+			Element * e = mit->e;
+			if ( !e || !e->elementSet() || !e->elementSet()->circuit() )
+				continue;
+
+			Circuit * circuit = e->elementSet()->circuit();
+			circuitElements[circuit] << e;
+			if ( !Netlist::isSupported( e->type() ) && !unsupported.contains(circuit) )
+				unsupported[circuit] = (*it)->name();
+		}
+	}
+
+	// The circuits that are needed are those with probes or varied components
+	QSet<Circuit*> needed;
+	QList<Component*> probes;
+
+	for ( ComponentList::const_iterator it = components.begin(); it != componentsEnd; ++it )
+	{
+		if ( VoltageProbe * probe = dynamic_cast<VoltageProbe*>(*it) )
+		{
+			const CircuitList::const_iterator circuitsEnd = circuits.end();
+			for ( CircuitList::const_iterator cit = circuits.begin(); cit != circuitsEnd; ++cit )
+			{
+				if ( (*cit)->contains( probe->pin1() ) || (*cit)->contains( probe->pin2() ) )
+					needed << *cit;
+			}
+			probes << probe;
+		}
+		else if ( CurrentProbe * probe = dynamic_cast<CurrentProbe*>(*it) )
+		{
+			ElementSet * elementSet = probe->voltageSource()->elementSet();
+			if ( elementSet && elementSet->circuit() )
+				needed << elementSet->circuit();
+			probes << probe;
+		}
+	}
+
+	if ( probes.isEmpty() )
+	{
+		m_errorString = i18n("There are no voltage or current probes in the circuit to measure.");
+		return false;
+	}
+
+	QList<Component*> variedComponents;
+	const QList<ParameterVariation>::const_iterator variationsEnd = m_variations.end();
+	for ( QList<ParameterVariation>::const_iterator it = m_variations.begin(); it != variationsEnd; ++it )
+	{
+		Component * component = dynamic_cast<Component*>( document->itemWithID( it->itemId ) );
+		if ( !component )
+		{
+			m_errorString = i18n("There is no component \"%1\" in the circuit.", it->itemId);
+			return false;
+		}
+
+		if ( it->distribution == ParameterVariation::Sweep && it->steps < 1 )
+		{
+			m_errorString = i18n("The sweep of \"%1\" of %2 has no steps.", it->property, it->itemId);
+			return false;
+		}
+
+		variedComponents << component;
+
+		const ElementMapList & elementMaps = component->elementMapList();
+		const ElementMapList::const_iterator mapsEnd = elementMaps.end();
+		for ( ElementMapList::const_iterator mit = elementMaps.begin(); mit != mapsEnd; ++mit )
+		{
+			if ( mit->e && mit->e->elementSet() && mit->e->elementSet()->circuit() )
+				needed << mit->e->elementSet()->circuit();
+		}
+	}
+
+	// Copy the needed circuits
+	QHash< Circuit*, int > cnodeOffsets;
+	QHash< Circuit*, int > cbranchOffsets;
+	QHash< Element*, int > elementIndexes;
+
+	const CircuitList::const_iterator circuitsEnd = circuits.end();
+	for ( CircuitList::const_iterator it = circuits.begin(); it != circuitsEnd; ++it )
+	{
+		Circuit * circuit = *it;
+		if ( !needed.contains(circuit) )
+			continue;
+
+		if ( unsupported.contains(circuit) )
+		{
+			m_errorString = i18n("\"%1\" cannot be simulated in an analysis.", unsupported[circuit]);
+			return false;
+		}
+
+		const int cnodeOffset = m_netlist.cnodeCount();
+		const int cbranchOffset = m_netlist.cbranchCount();
+		cnodeOffsets[circuit] = cnodeOffset;
+		cbranchOffsets[circuit] = cbranchOffset;
+		m_netlist.addCircuit( qMax( circuit->cnodeCount(), 0 ), qMax( circuit->branchCount(), 0 ) );
+
+		const ElementList elements = circuitElements.value(circuit);
+		const ElementList::const_iterator elementsEnd = elements.end();
+		for ( ElementList::const_iterator eit = elements.begin(); eit != elementsEnd; ++eit )
+			elementIndexes[*eit] = m_netlist.addElement( *eit, cnodeOffset, cbranchOffset );
+	}
+
+	// Find what the probes measure
+	const QList<Component*>::const_iterator probesEnd = probes.end();
+	for ( QList<Component*>::const_iterator it = probes.begin(); it != probesEnd; ++it )
+	{
+		ProbeSource source;
+		source.name = (*it)->id();
+
+		if ( VoltageProbe * probe = dynamic_cast<VoltageProbe*>(*it) )
+		{
+			for ( CircuitList::const_iterator cit = circuits.begin(); cit != circuitsEnd; ++cit )
+			{
+				if ( !cnodeOffsets.contains(*cit) )
+					continue;
+
+				if ( (*cit)->contains( probe->pin1() ) && probe->pin1()->eqId() >= 0 )
+					source.cnode1 = probe->pin1()->eqId() + cnodeOffsets[*cit];
+				if ( (*cit)->contains( probe->pin2() ) && probe->pin2()->eqId() >= 0 )
+					source.cnode2 = probe->pin2()->eqId() + cnodeOffsets[*cit];
+			}
+		}
+		else
+		{
+			VoltageSource * voltageSource = static_cast<CurrentProbe*>(*it)->voltageSource();
+			ElementSet * elementSet = voltageSource->elementSet();
+			if ( elementSet && voltageSource->cbranch(0) )
+				source.cbranch = voltageSource->cbranch(0)->n() + cbranchOffsets.value( elementSet->circuit() );
+		}
+
+		m_probes << source;
+	}
+
+	// Find the element parameters changed by each variation
+	for ( int v = 0; v < m_variations.size(); ++v )
+	{
+		const ParameterVariation & variation = m_variations[v];
+		const ElementMapList & elementMaps = variedComponents[v]->elementMapList();
+		const ElementMapList::const_iterator mapsEnd = elementMaps.end();
+
+		for ( ElementMapList::const_iterator mit = elementMaps.begin(); mit != mapsEnd; ++mit )
+		{
+			VariationTarget target;
+			if ( !mit->e || !findField( variation.property, mit->e->type(), &target.field ) )
+				continue;
+
+			const int index = elementIndexes.value( mit->e, -1 );
+			if ( index == -1 )
+				continue;
+
+			target.variation = v;
+			target.element = index;
+			target.nominal = fieldValue( m_netlist.element(index), target.field );
+			m_targets << target;
+		}
+
+		bool found = false;
+		const QList<VariationTarget>::const_iterator targetsEnd = m_targets.end();
+		for ( QList<VariationTarget>::const_iterator it = m_targets.begin(); it != targetsEnd && !found; ++it )
+			found = (it->variation == v);
+
+		if ( !found )
+		{
+			m_errorString = i18n("%1 has no property \"%2\" that can be varied.", variation.itemId, variation.property);
+			return false;
+		}
+	}
+
+	m_bPrepared = true;
+	return true;
+}
+
+
+int CircuitAnalysis::runCount() const
+{
+	if ( !m_bPrepared )
+		return 0;
+
+	int count = qMax( m_monteCarloRuns, 1 );
+
+	const QList<ParameterVariation>::const_iterator end = m_variations.end();
+	for ( QList<ParameterVariation>::const_iterator it = m_variations.begin(); it != end; ++it )
+	{
+		if ( it->distribution == ParameterVariation::Sweep )
+			count *= it->steps;
+	}
+
+	return count;
+}
+
+
+AnalysisResults CircuitAnalysis::run() const
+{
+	AnalysisResults results;
+
+	const QList<ParameterVariation>::const_iterator variationsEnd = m_variations.end();
+	for ( QList<ParameterVariation>::const_iterator it = m_variations.begin(); it != variationsEnd; ++it )
+		results.parameterNames << it->itemId + "/" + it->property;
+
+	const QList<ProbeSource>::const_iterator probesEnd = m_probes.end();
+	for ( QList<ProbeSource>::const_iterator it = m_probes.begin(); it != probesEnd; ++it )
+		results.probeNames << it->name;
+
+	const int count = runCount();
+	if ( count <= 0 )
+		return results;
+
+	// Each task writes to its own element, so no locking is needed; the
+	// vector is only detached here, before the tasks start.
+	results.runs.resize( count );
+	AnalysisRun * runs = results.runs.data();
+
+	QThreadPool pool;
+	if ( m_maxThreads > 0 )
+		pool.setMaxThreadCount( m_maxThreads );
+
+	for ( int i = 0; i < count; ++i )
+		pool.start( new AnalysisTask( this, i, runs + i ) );
+
+	pool.waitForDone();
+	return results;
+}
+
+
+double CircuitAnalysis::randomFactor( int run, int variation ) const
+{
+	const ParameterVariation & v = m_variations[variation];
+
+	quint64 state = (quint64(m_seed) << 32)
+			^ (quint64(run) * Q_UINT64_C(0x9E3779B97F4A7C15))
+			^ (quint64(variation) * Q_UINT64_C(0xD1B54A32D192ED03));
+
+	if ( v.distribution == ParameterVariation::Uniform )
+		return 1.0 + v.tolerance * (2.0 * nextUniform(&state) - 1.0);
+
+	// Box-Muller; 1 - u is in (0, 1], so the log is finite
+	const double u1 = 1.0 - nextUniform(&state);
+	const double u2 = nextUniform(&state);
+	const double normal = std::sqrt( -2.0 * std::log(u1) ) * std::cos( 2.0 * M_PI * u2 );
+	return 1.0 + (v.tolerance / 3.0) * normal;
+}
+
+
+void CircuitAnalysis::doRun( int run, AnalysisRun * result ) const
+{
+	Netlist netlist = m_netlist;
+
+	// Work out the value of each variation; sweeps vary slowest-first in the
+	// order they were added, and the Monte Carlo repeats fastest.
+	const int variationCount = m_variations.size();
+	QVector<double> values( variationCount );
+	int combination = run / qMax( m_monteCarloRuns, 1 );
+
+	for ( int v = 0; v < variationCount; ++v )
+	{
+		const ParameterVariation & variation = m_variations[v];
+		if ( variation.distribution != ParameterVariation::Sweep )
+		{
+			values[v] = randomFactor( run, v );
+			continue;
+		}
+
+		const int index = combination % variation.steps;
+		combination /= variation.steps;
+
+		if ( variation.steps > 1 )
+			values[v] = variation.from + (variation.to - variation.from) * index / (variation.steps - 1);
+		else
+			values[v] = variation.from;
+	}
+
+	result->parameters.fill( 0.0, variationCount );
+	QVector<bool> recorded( variationCount, false );
+
+	const QList<VariationTarget>::const_iterator targetsEnd = m_targets.end();
+	for ( QList<VariationTarget>::const_iterator it = m_targets.begin(); it != targetsEnd; ++it )
+	{
+		const int v = it->variation;
+		double value = values[v];
+		if ( m_variations[v].distribution != ParameterVariation::Sweep )
+			value *= it->nominal;
+
+		setFieldValue( &netlist.element( it->element ), it->field, value );
+
+		if ( !recorded[v] )
+		{
+			result->parameters[v] = value;
+			recorded[v] = true;
+		}
+	}
+
+	// Simulate, sampling each probe after every step
+	NetlistSimulation simulation( netlist );
+
+	const int steps = qMax( 1, int( m_duration / LINEAR_UPDATE_PERIOD + 0.5 ) );
+	const int probeCount = m_probes.size();
+	QVector< QVector<double> > samples( probeCount );
+	for ( int p = 0; p < probeCount; ++p )
+		samples[p].reserve( steps );
+
+	result->converged = simulation.start();
+
+	for ( int i = 0; i < steps; ++i )
+	{
+		if ( i > 0 )
+			simulation.step();
+
+		for ( int p = 0; p < probeCount; ++p )
+		{
+			const ProbeSource & source = m_probes[p];
+			if ( source.cbranch != noBranch )
+				samples[p] << -simulation.current( source.cbranch );
+			else
+				samples[p] << simulation.voltage( source.cnode1 ) - simulation.voltage( source.cnode2 );
+		}
+	}
+
+	result->measurements.resize( probeCount );
+	for ( int p = 0; p < probeCount; ++p )
+		result->measurements[p] = measure( samples[p], LINEAR_UPDATE_PERIOD );
+}
+
+
+ProbeMeasurement CircuitAnalysis::measure( const QVector<double> & samples, double timeStep ) const
+{
+	ProbeMeasurement m;
+	if ( samples.isEmpty() )
+		return m;
+
+	const int n = samples.size();
+	double sumSquares = 0.0;
+	m.minimum = m.maximum = samples[0];
+
+	for ( int i = 0; i < n; ++i )
+	{
+		const double v = samples[i];
+		m.minimum = qMin( m.minimum, v );
+		m.maximum = qMax( m.maximum, v );
+		sumSquares += v * v;
+	}
+
+	m.rms = std::sqrt( sumSquares / n );
+	m.finalValue = samples[n-1];
+
+	// Sample i is taken at the end of step i+1
+	const double band = m_settlingTolerance * qMax( std::abs( m.finalValue ), m.maximum - m.minimum );
+	for ( int i = n - 1; i >= 0; --i )
+	{
+		if ( std::abs( samples[i] - m.finalValue ) > band )
+		{
+			m.settlingTime = (i + 1) * timeStep;
+			break;
+		}
+	}
+
+	return m;
+}
+//END class CircuitAnalysis
@@ -0,0 +1,254 @@
+/***************************************************************************
+ *   Copyright (C) 2026 by the KTechLab developers                         *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ ***************************************************************************/
+
+#ifndef CIRCUITANALYSIS_H
+#define CIRCUITANALYSIS_H
+
+#include "netlist.h"
+
+#include <qlist.h>
+#include <qstring.h>
+#include <qstringlist.h>
+#include <qvector.h>
+
+class CircuitDocument;
+
+/**
+A change to one property of a component over the runs of a CircuitAnalysis.
+The property is given by the id used in the component's property editor, and
+is applied to every matching element of the component:
+
+@li "resistance": resistances
+@li "Capacitance": capacitances
+@li "Inductance": inductances
+@li "voltage": voltage points, sources and signals (signal amplitudes are peak)
+@li "current": current sources and signals
+@li "I_S", "N", "V_B": diode settings
+*/
+class ParameterVariation
+{
+	public:
+		enum Distribution
+		{
+			Sweep,		///< steps values evenly spaced from from to to (inclusive)
+			Uniform,	///< Uniformly within nominal * (1 +/- tolerance)
+			Gaussian	///< Normally distributed, with 3 sigma = nominal * tolerance
+		};
+
+		ParameterVariation();
+
+		QString itemId;
+		QString property;
+		Distribution distribution;
+		double from;
+		double to;
+		int steps;
+		double tolerance;
+};
+
+
+/**
+What a probe measured during one run.
+*/
+class ProbeMeasurement
+{
+	public:
+		ProbeMeasurement();
+
+		double minimum;
+		double maximum;
+		double rms;
+		double finalValue;
+		/**
+		 * Time after which the value stayed within the settling tolerance of
+		 * its final value.
+		 */
+		double settlingTime;
+};
+
+
+/**
+The parameters and measurements of one run of a CircuitAnalysis.
+*/
+class AnalysisRun
+{
+	public:
+		AnalysisRun() : converged(false) {}
+
+		/// Values of the varied parameters, in the order they were added
+		QVector<double> parameters;
+		/// Measurements, in the order of AnalysisResults::probeNames
+		QVector<ProbeMeasurement> measurements;
+		/// Whether the initial operating point converged
+		bool converged;
+};
+
+
+/**
+The results of a CircuitAnalysis: a table with one row per run.
+*/
+class AnalysisResults
+{
+	public:
+		enum Quantity
+		{
+			Minimum,
+			Maximum,
+			RMS,
+			FinalValue,
+			SettlingTime
+		};
+
+		/**
+		 * @return the given quantity of a probe, over all runs.
+		 */
+		QVector<double> values( int probe, Quantity quantity ) const;
+		/**
+		 * Counts the values of the given quantity in bins evenly spaced
+		 * between the smallest and largest values.
+		 * @param low if non-null, set to the lower edge of the first bin
+		 * @param high if non-null, set to the upper edge of the last bin
+		 */
+		QVector<int> histogram( int probe, Quantity quantity, int bins, double * low = 0l, double * high = 0l ) const;
+		/**
+		 * @return the table as comma-separated values, with a header line.
+		 */
+		QString toCsv() const;
+		/**
+		 * Writes toCsv to the given file.
+		 * @return whether successful
+		 */
+		bool saveCsv( const QString & path ) const;
+
+		QStringList parameterNames;
+		QStringList probeNames;
+		QVector<AnalysisRun> runs;
+};
+
+
+/**
+Runs many variants of the circuits in a document, for parameter sweeps and
+Monte Carlo tolerance analysis.
+
+prepare copies the elements of the document's circuits into a Netlist; after
+that, run simulates every variant from rest for the given duration on a
+thread pool, without involving the document, the Simulator or the event loop.
+Each run sees every voltage and current probe in the document.
+
+The runs are the combinations of the values of all sweeps, each repeated
+monteCarloRuns times with fresh random values. The random values depend only
+on the seed and the run number, so results do not depend on the number of
+threads used.
+
+@short Parameter sweep and Monte Carlo analysis
+*/
+class CircuitAnalysis
+{
+	public:
+		CircuitAnalysis();
+		~CircuitAnalysis();
+
+		void addVariation( const ParameterVariation & variation ) { m_variations << variation; }
+		void setMonteCarloRuns( int runs ) { m_monteCarloRuns = runs; }
+		/**
+		 * Sets the simulated time of each run, in seconds.
+		 */
+		void setDuration( double duration ) { m_duration = duration; }
+		/**
+		 * Sets the band around the final value, relative to the larger of
+		 * the final value and the range of the signal, that a signal must stay
+		 * within to count as settled.
+		 */
+		void setSettlingTolerance( double tolerance ) { m_settlingTolerance = tolerance; }
+		void setSeed( quint32 seed ) { m_seed = seed; }
+		/**
+		 * Sets the number of threads used; 0 for one per processor.
+		 */
+		void setMaxThreads( int threads ) { m_maxThreads = threads; }
+		/**
+		 * Copies the circuits of the document. Must be called from the GUI
+		 * thread while the document's circuits are assigned.
+		 * @return whether successful; if not, errorString says why
+		 */
+		bool prepare( CircuitDocument * document );
+		QString errorString() const { return m_errorString; }
+		/**
+		 * @return the number of runs that run will do.
+		 */
+		int runCount() const;
+		/**
+		 * Does all of the runs, returning once they have finished. May be
+		 * called from any thread after prepare has succeeded.
+		 */
+		AnalysisResults run() const;
+		/**
+		 * Does one run. This is what the worker threads call.
+		 */
+		void doRun( int run, AnalysisRun * result ) const;
+
+	protected:
+		/**
+		 * A quantity of the netlist measured by a probe: the voltage between
+		 * two nodes, or the current through a branch.
+		 */
+		class ProbeSource
+		{
+			public:
+				ProbeSource() : cnode1(noCNode), cnode2(noCNode), cbranch(noBranch) {}
+
+				QString name;
+				int cnode1;
+				int cnode2;
+				int cbranch;
+		};
+
+		enum VariedField
+		{
+			ElementValue,
+			DiodeSaturationCurrent,
+			DiodeEmissionCoefficient,
+			DiodeBreakdownVoltage
+		};
+
+		/**
+		 * An element parameter changed by a variation.
+		 */
+		class VariationTarget
+		{
+			public:
+				int variation;
+				int element;
+				VariedField field;
+				double nominal;
+		};
+
+		static bool findField( const QString & property, Element::Type type, VariedField * field );
+		static double fieldValue( const NetlistElement & element, VariedField field );
+		static void setFieldValue( NetlistElement * element, VariedField field, double value );
+		/**
+		 * @return the factor for a randomly varied parameter in the given run.
+		 */
+		double randomFactor( int run, int variation ) const;
+		ProbeMeasurement measure( const QVector<double> & samples, double timeStep ) const;
+
+		QList<ParameterVariation> m_variations;
+		int m_monteCarloRuns;
+		double m_duration;
+		double m_settlingTolerance;
+		quint32 m_seed;
+		int m_maxThreads;
+
+		Netlist m_netlist;
+		QList<ProbeSource> m_probes;
+		QList<VariationTarget> m_targets;
+		QString m_errorString;
+		bool m_bPrepared;
+};
+
+#endif
@@ -19,6 +19,7 @@
 #include "drawparts/drawpart.h"
 #include "ecnode.h"
 #include "itemdocumentdata.h"
+#include "itemview.h"
 #include "ktechlab.h"
 #include "pin.h"
 #include "simulator.h"
@@ -32,6 +33,7 @@
 #include <kactionmenu.h>
 
 #include <qregexp.h>
+#include <qregion.h>
 #include <qtimer.h>
 
 #include <ktlconfig.h>
@@ -56,6 +58,7 @@ CircuitDocument::CircuitDocument( const QString & caption, const char *name )
 	connect( this, SIGNAL(connectorAdded(Connector*)), this, SLOT(requestAssignCircuits()) );
 	connect( this, SIGNAL(connectorAdded(Connector*)), this, SLOT(connectorAdded(Connector*)) );
 	
+	m_bAssignCircuitsDeferred = false;
 	m_updateCircuitsTmr = new QTimer();
 	connect( m_updateCircuitsTmr, SIGNAL(timeout()), this, SLOT(assignCircuits()) );
 	
@@ -203,9 +206,13 @@ void CircuitDocument::slotUpdateConfiguration()
 		n->setShowVoltageColor( KTLConfig::showVoltageColor() );
 	}
 	
+	const bool dynamicConnectors = KTLConfig::showVoltageColor() || KTLConfig::animateWires();
 	ConnectorList::iterator connectorsEnd = m_connectorList.end();
 	for ( ConnectorList::iterator it = m_connectorList.begin(); it != connectorsEnd; ++it )
+	{
+		(*it)->setDynamic( dynamicConnectors );
 		(*it)->updateConnectorLines();
+	}
 	
 	ComponentList::iterator componentsEnd = m_componentList.end();
 	for ( ComponentList::iterator it = m_componentList.begin(); it != componentsEnd; ++it )
@@ -218,6 +225,16 @@ void CircuitDocument::update()
 	CircuitICNDocument::update();
 
 	bool animWires = KTLConfig::animateWires();
+	
+	// Only items that can be seen in one of the views need to be redrawn
+	QRegion visible;
+	const ViewList views = viewList();
+	ViewList::const_iterator viewsEnd = views.end();
+	for ( ViewList::const_iterator it = views.begin(); it != viewsEnd; ++it )
+	{
+		if ( ItemView * itemView = dynamic_cast<ItemView*>( (View*)*it ) )
+			visible += itemView->visibleCanvasRect();
+	}
 
 	if ( KTLConfig::showVoltageColor() || animWires )
 	{
@@ -232,7 +249,10 @@ void CircuitDocument::update()
 		for ( ConnectorList::iterator it = m_connectorList.begin(); it != end; ++it )
 		{
 			(*it)->incrementCurrentAnimation( 1.0 / double(KTLConfig::refreshRate()) );
-			(*it)->updateConnectorLines( animWires );
+			
+			// Off-screen connectors are updated once they are scrolled into view
+			if ( visible.intersects( (*it)->linesBoundingRect().adjusted( -2, -2, 2, 2 ) ) )
+				(*it)->updateConnectorLines( animWires );
 		}
 	}
 
@@ -241,8 +261,8 @@ void CircuitDocument::update()
 		ECNodeMap::iterator end = m_ecNodeList.end();
 		for ( ECNodeMap::iterator it = m_ecNodeList.begin(); it != end; ++it )
 		{
-			// static_cast<ECNode*>(*it)->setNodeChanged();
-			(*it)->setNodeChanged();
+			if ( visible.intersects( (*it)->boundingRect() ) )
+				(*it)->setNodeChanged();
 		}
 	}
 }
@@ -312,6 +332,20 @@ void CircuitDocument::requestAssignCircuits()
     if (m_bDeleted) {
         return;
     }
+	
+	if ( isEditingProperties() )
+	{
+		// Items being rebuilt in a property edit would otherwise request
+		// this once per item; the circuits are deleted straight away so that
+		// they don't refer to elements that are being removed.
+		if ( !m_bAssignCircuitsDeferred )
+		{
+			deleteCircuits();
+			m_bAssignCircuitsDeferred = true;
+		}
+		return;
+	}
+	
 	deleteCircuits();
 	m_updateCircuitsTmr->stop();
     m_updateCircuitsTmr->setSingleShot( true );
@@ -319,6 +353,16 @@ void CircuitDocument::requestAssignCircuits()
 }
 
 
+void CircuitDocument::propertyEditCommitted()
+{
+	if ( !m_bAssignCircuitsDeferred )
+		return;
+	
+	m_bAssignCircuitsDeferred = false;
+	requestAssignCircuits();
+}
+
+
 void CircuitDocument::connectorAdded( Connector * connector )
 {
 	if (connector) {
@@ -557,6 +601,7 @@ void CircuitDocument::assignCircuits()
 	circuitListEnd = m_circuitList.end();
 	for ( CircuitList::iterator it = m_circuitList.begin(); it != circuitListEnd; ++it )
 	{
+		(*it)->solveOperatingPoint();
 		(*it)->initCache();
 		Simulator::self()->attachCircuit(*it);
 	}
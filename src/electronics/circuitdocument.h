@@ -73,6 +73,15 @@ class CircuitDocument : public CircuitICNDocument
 		int countExtCon( const ItemList &cnItemList ) const;
 
 		virtual void update();
+		/**
+		 * @return the circuits, as last assigned. This is empty while circuits
+		 * are waiting to be reassigned after a change to the document.
+		 */
+		CircuitList circuitList() const { return m_circuitList; }
+		/**
+		 * @return the components that were assigned to the circuits.
+		 */
+		ComponentList componentList() const { return m_componentList; }
 	
 	public slots:
 		/**
@@ -104,6 +113,7 @@ class CircuitDocument : public CircuitICNDocument
 		virtual void fillContextMenu( const QPoint &pos );
 		virtual bool isValidItem( Item *item );
 		virtual bool isValidItem( const QString &itemId );
+		virtual void propertyEditCommitted();
 		
 		KActionMenu *m_pOrientationAction;
 	
@@ -145,6 +155,7 @@ class CircuitDocument : public CircuitICNDocument
 		void deleteCircuits();
 	
 		QTimer *m_updateCircuitsTmr;
+		bool m_bAssignCircuitsDeferred; ///< Whether circuits need assigning at the end of a property edit
 		CircuitList m_circuitList;
 		ComponentList m_toSimulateList;
 		ComponentList m_componentList; // List is built up during call to assignCircuits
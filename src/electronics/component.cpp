@@ -41,6 +41,7 @@
 #include <kdebug.h>
 #include <qbitarray.h>
 #include <qpainter.h>
+#include <qpixmapcache.h>
 #include <qwidget.h>
 #include <qmatrix.h>
 
@@ -54,7 +55,8 @@
 Component::Component( ICNDocument *icnDocument, bool newItem, const QString &id )
         : CNItem( icnDocument, newItem, id ),
         m_angleDegrees(0),
-        b_flipped(false)
+        b_flipped(false),
+        m_bCacheSymbol(false)
 {
     m_pCircuitDocument = dynamic_cast<CircuitDocument*>(icnDocument);
 
@@ -357,6 +359,76 @@ void Component::updateAttachedPositioning()
 }
 
 
+/**
+ * Splits a device coordinate into the pixel it lies in and the offset within
+ * that pixel, in eighths of a pixel.
+ */
+static void splitSubPixel( double coord, int * pixel, int * eighths )
+{
+    const int sub = qRound( coord * 8 );
+    *pixel = (sub >= 0) ? (sub / 8) : -((7 - sub) / 8);
+    *eighths = sub - *pixel * 8;
+}
+
+
+void Component::draw( QPainter & p )
+{
+    // The symbol can only be copied if the view is not rotated or sheared
+    const QMatrix matrix = p.worldMatrix();
+    const double scale = matrix.m11();
+    if ( !m_bCacheSymbol || matrix.m12() != 0.0 || matrix.m21() != 0.0 || matrix.m22() != scale || scale <= 0.0 )
+    {
+        CNItem::draw( p );
+        return;
+    }
+
+    const QRect symbolRect = boundingRect().adjusted( -2, -2, 2, 2 );
+    const QRect localRect = symbolRect.translated( -int(x()), -int(y()) );
+    const QPointF deviceTopLeft = matrix.map( QPointF( symbolRect.topLeft() ) );
+
+    // Keep the sub-pixel position, so that the copied symbol looks the same
+    // as the symbol drawn in place
+    int originX, originY, eighthsX, eighthsY;
+    splitSubPixel( deviceTopLeft.x(), & originX, & eighthsX );
+    splitSubPixel( deviceTopLeft.y(), & originY, & eighthsY );
+
+    const QPen pen = this->pen();
+    const QBrush brush = this->brush();
+    const QString key = QString("ktl-symbol:%1:%2:%3:%4:%5:%6:%7:%8:%9")
+        .arg( type() )
+        .arg( m_angleDegrees ).arg( b_flipped ).arg( isSelected() )
+        .arg( pen.color().rgba() ).arg( pen.width() )
+        .arg( brush.color().rgba() ).arg( int(brush.style()) )
+        .arg( scale )
+        + QString(":%1,%2,%3,%4:%5,%6")
+        .arg( localRect.x() ).arg( localRect.y() ).arg( localRect.width() ).arg( localRect.height() )
+        .arg( eighthsX ).arg( eighthsY );
+
+    QPixmap pixmap;
+    if ( !QPixmapCache::find( key, & pixmap ) )
+    {
+        pixmap = QPixmap( int(std::ceil( symbolRect.width() * scale )) + 1, int(std::ceil( symbolRect.height() * scale )) + 1 );
+        pixmap.fill( Qt::transparent );
+
+        QPainter symbolPainter( & pixmap );
+        symbolPainter.setRenderHints( p.renderHints() );
+        symbolPainter.setFont( p.font() );
+        symbolPainter.translate( eighthsX / 8.0, eighthsY / 8.0 );
+        symbolPainter.scale( scale, scale );
+        symbolPainter.translate( -symbolRect.topLeft() );
+        CNItem::draw( symbolPainter );
+        symbolPainter.end();
+
+        QPixmapCache::insert( key, pixmap );
+    }
+
+    p.save();
+    p.resetMatrix();
+    p.drawPixmap( originX, originY, pixmap );
+    p.restore();
+}
+
+
 void Component::drawPortShape( QPainter & p )
 {
     int h = height();
@@ -1146,15 +1218,24 @@ double Component::voltageLength( double v )
 // static
 QColor Component::voltageColor( double v )
 {
-    double prop = voltageLength( v );
+    const int index = voltageColorIndex( v );
+    const double prop = double( qAbs(index) ) / voltageColorLevels;
 
-    if ( v >= 0 )
+    if ( index >= 0 )
         return QColor( int(255*prop), int(166*prop), 0 );
     else
         return QColor( 0, int(136*prop), int(255*prop) );
 }
 
 
+// static
+int Component::voltageColorIndex( double v )
+{
+    const int level = int( voltageLength( v ) * voltageColorLevels + 0.5 );
+    return ( v >= 0 ) ? level : -level;
+}
+
+
 //BEGIN class ElementMap
 ElementMap::ElementMap()
 {
@@ -84,11 +84,22 @@ class Component : public CNItem
 		virtual ~Component();
 	
 		ECNode* createPin( double _x, double _y, int orientation, const QString &name );
+		/**
+		 * Number of different colours that voltageColor uses for each sign
+		 * of the voltage (excluding the colour for zero volts).
+		 */
+		static const int voltageColorLevels = 64;
 		/**
 		 * Converts the voltage level to a colour - this is used in drawing
 		 * wires and pins.
 		 */
 		static QColor voltageColor( double v );
+		/**
+		 * @return the index of the colour that voltageColor gives for the
+		 * voltage, from -voltageColorLevels to voltageColorLevels. Items only
+		 * need to be redrawn when this changes.
+		 */
+		static int voltageColorIndex( double v );
 		/**
 		 * @return a value between 0.0 and 1.0, representing a scaled version of
 		 * the absolute value of the voltage.
@@ -122,6 +133,11 @@ class Component : public CNItem
 		 */
 		CircuitDocument *circuitDocument() const { return m_pCircuitDocument; }
 		void initElements( const uint stage );
+		/**
+		 * @return the elements of the component and the pins they are
+		 * connected to.
+		 */
+		const ElementMapList & elementMapList() const { return m_elementMapList; }
 		virtual void finishedCreation();
 		/**
 		 * If reinherit (and use) the stepNonLogic function, then you must also
@@ -258,6 +274,13 @@ class Component : public CNItem
 		virtual void removeItem();
 	
 	protected:
+		/**
+		 * If m_bCacheSymbol is set, then the symbol is drawn from a pixmap
+		 * that is shared by all components of the same type, orientation,
+		 * size, pen and brush at the current zoom level. Otherwise, this just
+		 * calls drawShape.
+		 */
+		virtual void draw( QPainter & p );
 		/**
 		 * Convenience functionality provided for components in a port shape
 		 * (such as ParallelPortComponent and SerialPortComponent).
@@ -338,6 +361,13 @@ class Component : public CNItem
 		QPointer<CircuitDocument> m_pCircuitDocument;
 		int m_angleDegrees;
 		bool b_flipped;
+		/**
+		 * Set this to true in the constructor if what drawShape draws only
+		 * depends on the type, size, orientation, pen, brush and selection of
+		 * the component (and not on e.g. properties or the simulation). See
+		 * draw.
+		 */
+		bool m_bCacheSymbol;
 	
 	private:
 		/**
@@ -41,6 +41,7 @@ BiDirLED::BiDirLED( ICNDocument *icnDocument, bool newItem, const char *id )
 {
 	m_name = i18n("Bidirectional LED");
 	m_bDynamicContent = true;
+	setDynamic(true);
 	
 	setSize( -8, -16, 16, 32 );
 	init1PinLeft();
@@ -49,9 +50,9 @@ BiDirLED::BiDirLED( ICNDocument *icnDocument, bool newItem, const char *id )
 	
 	m_pDiode[0] = createDiode( m_pNNode[0], m_pPNode[0] );
 	m_pDiode[1] = createDiode( m_pPNode[0], m_pNNode[0] );
+	LED::integrateBrightness( m_pDiode[0] );
+	LED::integrateBrightness( m_pDiode[1] );
 	
-	avg_brightness[0] = avg_brightness[1] = 255;
-	lastUpdatePeriod = 1.;
 	r[0]=r[1]=g[0]=g[1]=b[0]=b[1]=0;
 	last_brightness[0] = last_brightness[1] = 255;
 	
@@ -80,30 +81,14 @@ void BiDirLED::dataChanged()
 	}
 }
 
-void BiDirLED::stepNonLogic()
-{
-	lastUpdatePeriod += LINEAR_UPDATE_PERIOD;
-	
-	for ( unsigned i = 0; i < 2; i++ )
-		avg_brightness[i] += LED::brightness(m_pDiode[i]->current()) * LINEAR_UPDATE_PERIOD;
-}
-
 void BiDirLED::drawShape( QPainter &p )
 {
 	initPainter(p);
 	
 	for ( unsigned i = 0; i < 2; i++ )
 	{
-		uint _b;
-		if ( lastUpdatePeriod == 0. )
-			_b = last_brightness[i];
-		
-		else
-		{
-			_b = uint(avg_brightness[i]/lastUpdatePeriod);
-			last_brightness[i] = _b;
-		}
-		avg_brightness[i] = 0.;
+		LED::averageBrightness( m_pDiode[i], &last_brightness[i] );
+		uint _b = last_brightness[i];
 	
 		p.setBrush( QColor( uint(255-(255-_b)*(1-r[i])), uint(255-(255-_b)*(1-g[i])), uint(255-(255-_b)*(1-b[i])) ) );
 		
@@ -126,7 +111,6 @@ void BiDirLED::drawShape( QPainter &p )
 		p.drawPolygon(pa);
 		p.drawPolyline(pa);
 	}
-	lastUpdatePeriod = 0.;
 		
 	// Draw the arrows indicating it's a LED
 	int _x = (int)x()-2;
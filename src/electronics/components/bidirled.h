@@ -26,8 +26,6 @@ class BiDirLED : public Component
 		static LibraryItem *libraryItem();
 	
 		virtual void dataChanged();
-		virtual void stepNonLogic();
-		virtual bool doesStepNonLogic() const { return true; }
 	
 	private:
 		virtual void drawShape( QPainter &p );
@@ -36,9 +34,7 @@ class BiDirLED : public Component
 		double g[2];
 		double b[2];
 	
-		double avg_brightness[2];
 		uint last_brightness[2];
-		double lastUpdatePeriod;
 		Diode *m_pDiode[2];
 };
 
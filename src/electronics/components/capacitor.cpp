@@ -37,6 +37,7 @@ Capacitor::Capacitor( ICNDocument *icnDocument, bool newItem, const char *id )
 	: Component( icnDocument, newItem, id ? id : "capacitor" )
 {
 	m_name = i18n("Capacitor");
+	m_bCacheSymbol = true;
 	setSize( -8, -8, 16, 16 );
 	
 	init1PinLeft();
@@ -41,6 +41,7 @@ Demultiplexer::Demultiplexer( ICNDocument *icnDocument, bool newItem, const char
 	m_name = i18n("Demultiplexer");
 	
 	m_input = 0l;
+	m_inputBus.setCallback( this, (BusCallbackPtr)(&Demultiplexer::inputsChanged) );
 	
 	createProperty( "addressSize", Variant::Type::Int );
 	property("addressSize")->setCaption( i18n("Address Size") );
@@ -87,14 +88,9 @@ void Demultiplexer::dataChanged()
 }
 
 
-void Demultiplexer::inStateChanged( bool /*state*/ )
+void Demultiplexer::inputsChanged()
 {
-	unsigned long long pos = 0;
-	for ( unsigned i = 0; i < m_aLogic.size(); ++i )
-	{
-		if ( m_aLogic[i]->isHigh() )
-			pos += 1 << i;
-	}
+	const unsigned pos = LogicBus::pack(m_aLogic);
 	for ( unsigned i = 0; i < m_xLogic.size(); ++i )
 		m_xLogic[i]->setHigh( (pos == i) && m_input->isHigh() );
 }
@@ -130,7 +126,7 @@ void Demultiplexer::initPins( unsigned newAddressSize )
 	{
 		node =  ecNodeWithID("X");
 		m_input = createLogicIn(node);
-		m_input->setCallback( this, (CallbackPtr)(&Demultiplexer::inStateChanged) );
+		m_inputBus.addInput(m_input);
 	}
 	
 	if ( newXLogicCount > oldXLogicCount )
@@ -139,15 +135,15 @@ void Demultiplexer::initPins( unsigned newAddressSize )
 		for ( unsigned i = oldXLogicCount; i < newXLogicCount; ++i )
 		{
 			node = ecNodeWithID("X"+QString::number(i));
-			m_xLogic.insert( i, createLogicOut(node,false) );
+			m_xLogic[i] = createLogicOut(node,false);
 		}
 		
 		m_aLogic.resize(newAddressSize);
 		for ( unsigned i = oldAddressSize; i < newAddressSize; ++i )
 		{
 			node = ecNodeWithID("A"+QString::number(i));
-			m_aLogic.insert( i, createLogicIn(node) );
-			m_aLogic[i]->setCallback( this, (CallbackPtr)(&Demultiplexer::inStateChanged) );
+			m_aLogic[i] = createLogicIn(node);
+			m_inputBus.addInput( m_aLogic[i] );
 		}
 	}
 	else
@@ -165,6 +161,7 @@ void Demultiplexer::initPins( unsigned newAddressSize )
 		{
 			QString id = "A"+QString::number(i);
 			removeDisplayText(id);
+			m_inputBus.removeInput( m_aLogic[i] );
 			removeElement( m_aLogic[i], false );
 			removeNode(id);
 		}
@@ -35,8 +35,12 @@ protected:
 	 */
 	void initPins( unsigned addressSize );
 	
-	void inStateChanged( bool newState );
+	/**
+	 * Called once the address and data inputs have settled.
+	 */
+	void inputsChanged();
 	
+	LogicBus m_inputBus;
 	QVector<LogicIn*> m_aLogic;
 	QVector<LogicOut*> m_xLogic;
 	LogicIn * m_input;
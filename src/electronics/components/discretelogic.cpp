@@ -244,6 +244,7 @@ ECLogicOutput::ECLogicOutput( ICNDocument *icnDocument, bool newItem, const char
 	m_highTime = 0;
 	m_bLastState = false;
 	m_bDynamicContent = true;
+	setDynamic(true);
 	
 	m_pIn->setCallback( this, (CallbackPtr)(&ECLogicOutput::inStateChanged) );
 }
@@ -79,26 +79,27 @@ ECBCDTo7Segment::ECBCDTo7Segment( ICNDocument *icnDocument, bool newItem, const
 	rbLogic = createLogicIn( ecNodeWithID("rb") );
 	enLogic = createLogicIn( ecNodeWithID("en") );
 	
-	ALogic->setCallback( this, (CallbackPtr)(&ECBCDTo7Segment::inStateChanged) );
-	BLogic->setCallback( this, (CallbackPtr)(&ECBCDTo7Segment::inStateChanged) );
-	CLogic->setCallback( this, (CallbackPtr)(&ECBCDTo7Segment::inStateChanged) );
-	DLogic->setCallback( this, (CallbackPtr)(&ECBCDTo7Segment::inStateChanged) );
-	ltLogic->setCallback( this, (CallbackPtr)(&ECBCDTo7Segment::inStateChanged) );
-	rbLogic->setCallback( this, (CallbackPtr)(&ECBCDTo7Segment::inStateChanged) );
-	enLogic->setCallback( this, (CallbackPtr)(&ECBCDTo7Segment::inStateChanged) );
+	m_inputBus.addInput(ALogic);
+	m_inputBus.addInput(BLogic);
+	m_inputBus.addInput(CLogic);
+	m_inputBus.addInput(DLogic);
+	m_inputBus.addInput(ltLogic);
+	m_inputBus.addInput(rbLogic);
+	m_inputBus.addInput(enLogic);
 	
 	for ( uint i=0; i<7; ++i )
 	{
 		outLogic[i] = createLogicOut( ecNodeWithID( QChar('a'+i) ), false );
-		outLogic[i]->setCallback( this, (CallbackPtr)(&ECBCDTo7Segment::inStateChanged) );
+		m_inputBus.addInput( outLogic[i] );
 	}
-	inStateChanged(false);
+	m_inputBus.setCallback( this, (BusCallbackPtr)(&ECBCDTo7Segment::inStateChanged) );
+	inStateChanged();
 }
 
 ECBCDTo7Segment::~ECBCDTo7Segment()
 {}
 
-void ECBCDTo7Segment::inStateChanged(bool)
+void ECBCDTo7Segment::inStateChanged()
 {
 	bool A = ALogic->isHigh();
 	bool B = BLogic->isHigh();
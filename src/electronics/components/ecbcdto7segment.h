@@ -28,7 +28,11 @@ public:
 	static LibraryItem *libraryItem();
 	
 private:
-	void inStateChanged( bool newState );
+	/**
+	 * Called once the inputs have settled.
+	 */
+	void inStateChanged();
+	LogicBus m_inputBus;
 	LogicIn *ALogic, *BLogic, *CLogic, *DLogic;
 	LogicIn *ltLogic, *rbLogic, *enLogic;
 	LogicOut *outLogic[7];
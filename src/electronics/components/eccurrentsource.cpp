@@ -38,6 +38,7 @@ ECCurrentSource::ECCurrentSource( ICNDocument *icnDocument, bool newItem, const
 	: Component( icnDocument, newItem, id ? id : "current_source" )
 {
 	m_name = i18n("Current Source");
+	m_bCacheSymbol = true;
 	setSize( -16, -8, 24, 24 );
 
 	init1PinLeft(8);
@@ -36,6 +36,7 @@ ECGround::ECGround( ICNDocument *icnDocument, bool newItem, const char *id )
 	: Component( icnDocument, newItem, (id) ? id : "ground" )
 {
 	m_name = i18n("Ground");
+	m_bCacheSymbol = true;
 	setSize( -8, -8, 16, 16 );
 	init1PinRight();
 	m_pPNode[0]->pin()->setGroundType( Pin::gt_always );
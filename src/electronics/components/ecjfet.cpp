@@ -62,6 +62,7 @@ ECJFET::ECJFET( int JFET_type, ICNDocument * icnDocument, bool newItem, const ch
 		m_name = i18n("N-Channel JFET");
 	else
 		m_name = i18n("P-Channel JFET");
+	m_bCacheSymbol = true;
 	
 	setSize( -8, -8, 16, 16 );
 	m_pJFET = createJFET( createPin( 8, -16, 90, "D" ), createPin( -16, 0, 0, "G" ), createPin( 8, 16, 270, "S" ), JFET_type );
@@ -38,6 +38,7 @@ ECOpAmp::ECOpAmp( ICNDocument *icnDocument, bool newItem, const char *id )
 	: Component( icnDocument, newItem, id ? id : "opamp" )
 {
 	m_name = i18n("Operational Amplifier");
+	m_bCacheSymbol = true;
 	
 	QPolygon pa(3);
 	pa[0] = QPoint( -16, -16 );
@@ -41,6 +41,7 @@ ECSevenSegment::ECSevenSegment( ICNDocument *icnDocument, bool newItem, const ch
 {
 	m_name = i18n("Seven Segment LED");
 	m_bDynamicContent = true;
+	setDynamic(true);
 	
 	//QStringList pins = QStringList::split( ',', "g,f,e,d,"+QString(QChar(0xB7))+",c,b,a" );
     QStringList pins = QString("g,f,e,d,"+QString(QChar(0xB7))+",c,b,a" ).split(',');
@@ -61,13 +62,10 @@ ECSevenSegment::ECSevenSegment( ICNDocument *icnDocument, bool newItem, const ch
 	{
 		m_diodes[i] = 0L;
 		m_nodes[i] = 0L;
-		avg_brightness[i] = 0.;
 		last_brightness[i] = 255;
 	}
 	m_nNode = 0L;
 	
-	lastUpdatePeriod = 1.;
-	
 	initDIPSymbol( pins, 64 );
 	initDIP(pins);
 	
@@ -112,23 +110,15 @@ void ECSevenSegment::dataChanged()
 			m_diodes[7] = createDiode( m_nodes[7], m_nNode );
 		else
 			m_diodes[7] = createDiode( m_nNode, m_nodes[7] );
+		
+		for ( int i=0; i<8; i++ )
+			LED::integrateBrightness( m_diodes[i] );
 	}
 	
 	update();
 }
 
 
-void ECSevenSegment::stepNonLogic()
-{
-	if ( !m_diodes[0] ) return;
-
-	for ( int i=0; i<8; i++ ) {
-		avg_brightness[i] += LED::brightness( m_diodes[i]->current() ) * LINEAR_UPDATE_PERIOD;
-	}
-	
-	lastUpdatePeriod += LINEAR_UPDATE_PERIOD;
-}
-
 void ECSevenSegment::drawShape( QPainter &p )
 {
 	CNItem::drawShape(p);
@@ -150,13 +140,8 @@ void ECSevenSegment::drawShape( QPainter &p )
 // 	pen.setCapStyle(Qt::RoundCap);
 // 	p.setPen(pen);
 	
-	if ( lastUpdatePeriod != 0. )
-	{
-		for ( uint i=0; i<8; ++i )
-		{
-			last_brightness[i] = (uint)(avg_brightness[i]/lastUpdatePeriod);
-		}
-	}
+	for ( uint i=0; i<8; ++i )
+		LED::averageBrightness( m_diodes[i], &last_brightness[i] );
 	
 	double _b;
 	
@@ -201,10 +186,5 @@ void ECSevenSegment::drawShape( QPainter &p )
 	p.setPen( Qt::NoPen );
 	p.drawPie( x2+3, y3-2, 3, 3, 0, 16*360 );
 	
-	lastUpdatePeriod = 0.;
-	for ( uint i=0; i<8; ++i ) {
-		avg_brightness[i] = 0.;
-	}
-	
 	deinitPainter(p);
 }
@@ -29,16 +29,12 @@ public:
 	static Item* construct( ItemDocument *itemDocument, bool newItem, const char *id );
 	static LibraryItem *libraryItem();
 	
-	virtual void stepNonLogic();
-	virtual bool doesStepNonLogic() const { return true; }
 	virtual void dataChanged();
 	
 private:
 	virtual void drawShape( QPainter &p );
 	
 	bool m_bCommonCathode;
-	double lastUpdatePeriod;
-	double avg_brightness[8];
 	uint last_brightness[8];
 	Diode *m_diodes[8];
 	ECNode *m_nodes[8];
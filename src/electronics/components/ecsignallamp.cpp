@@ -54,6 +54,7 @@ ECSignalLamp::ECSignalLamp( ICNDocument *icnDocument, bool newItem, const char *
 	advanceSinceUpdate = 0;
 	avgPower = 0.;
 	m_bDynamicContent = true;
+	setDynamic(true);
 }
 
 ECSignalLamp::~ECSignalLamp()
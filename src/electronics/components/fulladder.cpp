@@ -63,10 +63,10 @@ FullAdder::FullAdder( ICNDocument *icnDocument, bool newItem, const char *id )
 	node = ecNodeWithID(">");
 	inLogic = createLogicIn(node);
 	
-	
-	ALogic->setCallback( this, (CallbackPtr)(&FullAdder::inStateChanged) );
-	BLogic->setCallback( this, (CallbackPtr)(&FullAdder::inStateChanged) );
-	inLogic->setCallback( this, (CallbackPtr)(&FullAdder::inStateChanged) );
+	m_inputBus.addInput(ALogic);
+	m_inputBus.addInput(BLogic);
+	m_inputBus.addInput(inLogic);
+	m_inputBus.setCallback( this, (BusCallbackPtr)(&FullAdder::inStateChanged) );
 }
 
 FullAdder::~FullAdder()
@@ -74,17 +74,12 @@ FullAdder::~FullAdder()
 }
 
 
-void FullAdder::inStateChanged( bool /*state*/ )
+void FullAdder::inStateChanged()
 {
-	const bool A = ALogic->isHigh();
-	const bool B = BLogic->isHigh();
-	const bool in = inLogic->isHigh();
-	
-	const bool out = (!A && B && in) || (A && !B && in) || (A && B);
-	const bool S = (!A && !B && in) || (!A && B && !in) || (A && !B && !in) || (A && B && in);
+	const unsigned sum = unsigned(ALogic->isHigh()) + unsigned(BLogic->isHigh()) + unsigned(inLogic->isHigh());
 	
-	SLogic->setHigh(S);
-	outLogic->setHigh(out);
+	SLogic->setHigh( sum & 1 );
+	outLogic->setHigh( sum & 2 );
 }
 
 
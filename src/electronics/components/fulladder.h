@@ -27,8 +27,12 @@ public:
 	static LibraryItem *libraryItem();
 	
 protected:
-	void inStateChanged( bool newState );
+	/**
+	 * Called once the A, B and carry inputs have settled.
+	 */
+	void inStateChanged();
 	
+	LogicBus m_inputBus;
 	LogicIn *ALogic, *BLogic, *inLogic;
 	LogicOut *outLogic, *SLogic;
 };
@@ -36,6 +36,7 @@ Inductor::Inductor( ICNDocument *icnDocument, bool newItem, const char *id )
 	: Component( icnDocument, newItem, id ? id : "inductor" )
 {
 	m_name = i18n("Inductor");
+	m_bCacheSymbol = true;
 	setSize( -16, -8, 32, 16 );
 	
 	init1PinLeft();
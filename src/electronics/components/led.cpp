@@ -38,12 +38,12 @@ LED::LED( ICNDocument *icnDocument, bool newItem, const char *id )
 	: ECDiode( icnDocument, newItem, id ? id : "led" )
 {
 	m_bDynamicContent = true;
+	setDynamic(true);
 	m_name = i18n("LED");
 	setSize( -8, -16, 24, 24, true );
-	avg_brightness = 255;
-	lastUpdatePeriod = 1.;
 	r=g=b=0;
 	last_brightness = 255;
+	integrateBrightness( m_diode );
 	
 	createProperty( "0-color", Variant::Type::Color );
 	property("0-color")->setCaption( i18n("Color") );
@@ -62,12 +62,6 @@ void LED::dataChanged()
 	b = color.blue() / (double)0x100;
 }
 
-void LED::stepNonLogic()
-{
-	avg_brightness   += brightness(m_diode->current()) * LINEAR_UPDATE_PERIOD;
-	lastUpdatePeriod += LINEAR_UPDATE_PERIOD;
-}
-
 void LED::drawShape( QPainter &p )
 {
 	int _x = int(x());
@@ -76,16 +70,8 @@ void LED::drawShape( QPainter &p )
 	initPainter(p);
 	
 	//BEGIN draw "Diode" part
-	uint _b;
-
-	if(lastUpdatePeriod != 0.) {
-		last_brightness = (uint)(avg_brightness/lastUpdatePeriod);
-	}
-
-	_b = last_brightness;
-
-	avg_brightness   = 0.;
-	lastUpdatePeriod = 0.;
+	averageBrightness( m_diode, &last_brightness );
+	uint _b = last_brightness;
 
 	p.setBrush(QColor(uint(255 - (255 - _b) * (1 - r)),
 			  uint(255 - (255 - _b) * (1 - g)),
@@ -115,10 +101,31 @@ void LED::drawShape( QPainter &p )
 	deinitPainter(p);
 }
 
+// Currents at which a LED starts to light up and is fully lit
+static const double LED_MIN_CURRENT = 0.002;
+static const double LED_MAX_CURRENT = 0.018;
+
 uint LED::brightness( double i )
 {
-	if ( i > 0.018 ) return 0;
-	if ( i < 0.002 ) return 255;
-	return (uint)(255 * (1 - ((i - 0.002) / 0.016)));
+	if ( i > LED_MAX_CURRENT ) return 0;
+	if ( i < LED_MIN_CURRENT ) return 255;
+	return (uint)(255 * (1 - ((i - LED_MIN_CURRENT) / (LED_MAX_CURRENT - LED_MIN_CURRENT))));
+}
+
+void LED::integrateBrightness( Diode * diode )
+{
+	// brightness is linear in the current between these limits, so the mean
+	// brightness is the brightness of the mean limited current
+	diode->setCurrentIntegration( LED_MIN_CURRENT, LED_MAX_CURRENT );
+}
+
+bool LED::averageBrightness( Diode * diode, uint * brightness, double minPeriod )
+{
+	double current;
+	if ( !diode || !diode->takeAverageCurrent( &current, minPeriod ) )
+		return false;
+	
+	*brightness = LED::brightness(current);
+	return true;
 }
 
@@ -31,19 +31,27 @@ public:
 	 * Returns the brightness for the given current, from 255 (off) -> 0 (on)
 	 */
 	static uint brightness( double i );
+	/**
+	 * Makes the diode integrate its current over the range that brightness
+	 * depends on, for use with averageBrightness.
+	 */
+	static void integrateBrightness( Diode * diode );
+	/**
+	 * Sets brightness to the mean brightness of the diode since this was last
+	 * called, if that was more than minPeriod seconds of simulated time ago.
+	 * The diode must have been set up with integrateBrightness.
+	 * @return whether brightness was set
+	 */
+	static bool averageBrightness( Diode * diode, uint * brightness, double minPeriod = 0.0 );
 	
 	virtual void dataChanged();
-	virtual void stepNonLogic();
-	virtual bool doesStepNonLogic() const { return true; }
 	
 private:
 	virtual void drawShape( QPainter &p );
 	
 	double r, g, b;
 	
-	double avg_brightness;
 	uint last_brightness;
-	double lastUpdatePeriod;
 };
 
 #endif
@@ -26,9 +26,8 @@ LEDPart::LEDPart( Component *pParent, const QString& strPNode, const QString& st
 	m_strNNode = strNNode;
 	
 	m_pDiode = pParent->createDiode( pParent->ecNodeWithID( strPNode ), pParent->ecNodeWithID( strNNode ) );
+	LED::integrateBrightness( m_pDiode );
 		
-	avg_brightness = 255;
-	lastUpdatePeriod = 1.;
 	last_brightness = 255;
 	r=g=b=0;
 }
@@ -52,25 +51,10 @@ void LEDPart::setColor( const QColor &color )
 	b = color.blue()  / (double)0x100;
 }
 
-void LEDPart::step()
-{
-	avg_brightness += LED::brightness( m_pDiode->current() ) * LINEAR_UPDATE_PERIOD;
-	lastUpdatePeriod += LINEAR_UPDATE_PERIOD;
-}
-
 void LEDPart::draw( QPainter &p, int x, int y, int w, int h )
 {
-	uint _b;
-	if ( lastUpdatePeriod == 0. )
-		_b = last_brightness;
-	else
-	{
-		_b = (uint)(avg_brightness/lastUpdatePeriod);
-		last_brightness = _b;
-	}
-	
-	avg_brightness = 0.;
-	lastUpdatePeriod = 0.;
+	LED::averageBrightness( m_pDiode, &last_brightness );
+	uint _b = last_brightness;
 	
 	p.setBrush( QColor( uint(255-(255-_b)*(1-r)), uint(255-(255-_b)*(1-g)), uint(255-(255-_b)*(1-b)) ) );
 	p.drawRect( x, y, w, h );
@@ -98,6 +82,7 @@ LEDBarGraphDisplay::LEDBarGraphDisplay( ICNDocument* icnDocument, bool newItem,
 {
 	m_name = i18n("Bar Graph Display");
 	m_bDynamicContent = true;
+	setDynamic(true);
 		
 	m_numRows = 0;
 		
@@ -228,13 +213,6 @@ void LEDBarGraphDisplay::initPins()
 	m_numRows = numRows;
 }
 
-void LEDBarGraphDisplay::stepNonLogic()
-{
-	// Update LED brightnesses.
-	for( unsigned i = 0; i < m_numRows; i++ )
-		m_LEDParts[i]->step();
-}
-
 void LEDBarGraphDisplay::drawShape( QPainter &p )
 {
 	Component::drawShape(p);
@@ -31,7 +31,6 @@ class LEDPart
 		
 		void setDiodeSettings( const DiodeSettings& ds );
 		void setColor( const QColor &color );
-		void step();
 		
 		void draw( QPainter &p, int x, int y, int w, int h );
 		
@@ -42,8 +41,6 @@ class LEDPart
 		QString m_strPNode, m_strNNode;
 		
 		double r, g, b;
-		double lastUpdatePeriod;
-		double avg_brightness;
 		uint last_brightness;	
 };
 
@@ -60,8 +57,6 @@ class LEDBarGraphDisplay : public Component
 		void initPins();
 		void dataChanged();
 		
-		virtual void stepNonLogic();
-		virtual bool doesStepNonLogic() const { return true; }
 		virtual void drawShape( QPainter &p );
 
 		LEDPart* m_LEDParts[max_LED_rows];
@@ -48,6 +48,8 @@ MagnitudeComparator::MagnitudeComparator( ICNDocument *icnDocument, bool newItem
 	outputs = 3;
 	
 	firstTime = true;
+	
+	m_inputBus.setCallback( this, (BusCallbackPtr)(&MagnitudeComparator::inStateChanged) );
 }
 
 MagnitudeComparator::~MagnitudeComparator()
@@ -63,35 +65,30 @@ void MagnitudeComparator::dataChanged()
 
 void MagnitudeComparator::inStateChanged()
 {
-	int i;
+	// Bits of the output word, in the same order as m_output
+	const unsigned greater = 1 << 0;
+	const unsigned less = 1 << 1;
+	const unsigned equal = 1 << 2;
 	
-	for ( i = 0; i < 3; i++ )
-		m_output[i]->setHigh(false);
+	const unsigned a = LogicBus::pack(m_aLogic);
+	const unsigned b = LogicBus::pack(m_bLogic);
 	
-// 	for ( i = dataInt("numInput")-1; i >= 0; i-- ) {
-	for ( i = m_oldABLogicCount-1; i >= 0; i-- ) {
-		if (m_aLogic[i]->isHigh() && !m_bLogic[i]->isHigh())
-		{
-			m_output[0]->setHigh(true);
-			return;
-		}
-		else if ( !m_aLogic[i]->isHigh() && m_bLogic[i]->isHigh() ) {
-			m_output[1]->setHigh(true);
-			return;
-		}
-	}
+	unsigned out;
+	if ( a > b )
+		out = greater;
+	else if ( a < b )
+		out = less;
+	else if ( m_cLogic[2]->isHigh() )
+		out = equal;
+	else if ( m_cLogic[0]->isHigh() )
+		out = m_cLogic[1]->isHigh() ? 0 : greater;
+	else if ( m_cLogic[1]->isHigh() )
+		out = less;
+	else
+		out = greater | less;
 	
-	if ( m_cLogic[2]->isHigh() )
-		m_output[2]->setHigh(true);
-	else if ( m_cLogic[0]->isHigh() ) {
-		if ( !m_cLogic[1]->isHigh() )
-			m_output[0]->setHigh(true);
-	} else if ( m_cLogic[1]->isHigh() )
-		m_output[1]->setHigh(true);
-	else {
-		m_output[0]->setHigh(true);
-		m_output[1]->setHigh(true);
-	}
+	// Drive all of the outputs at once, rather than clearing them first
+	LogicBus::drive( m_output, out );
 }
 
 
@@ -137,15 +134,15 @@ void MagnitudeComparator::initPins()
 		for ( int i = 0; i < cascadingInputs; i++ )
 		{
 			node = ecNodeWithID( inNames[i] );
-			m_cLogic.insert( i, createLogicIn(node) );
-			m_cLogic[i]->setCallback( this, (CallbackPtr)(&MagnitudeComparator::inStateChanged));
+			m_cLogic[i] = createLogicIn(node);
+			m_inputBus.addInput( m_cLogic[i] );
 		}
 		
 		m_output.resize(3);
 		for ( int i = 0; i < outputs; i++ )
 		{
 			node = ecNodeWithID( outNames[i] );
-			m_output.insert( i, createLogicOut(node,false) );
+			m_output[i] = createLogicOut(node,false);
 		}
 		firstTime = false;
 	}
@@ -156,16 +153,16 @@ void MagnitudeComparator::initPins()
 		for ( int i=m_oldABLogicCount; i<newABLogicCount; ++i )
 		{
 			node = ecNodeWithID("A"+QString::number(i));
-			m_aLogic.insert( i, createLogicIn(node) );
-			m_aLogic[i]->setCallback( this, (CallbackPtr)(&MagnitudeComparator::inStateChanged) );
+			m_aLogic[i] = createLogicIn(node);
+			m_inputBus.addInput( m_aLogic[i] );
 		}
 		
 		m_bLogic.resize(newABLogicCount);
 		for ( int i=m_oldABLogicCount; i<newABLogicCount; ++i )
 		{
 			node = ecNodeWithID("B"+QString::number(i));
-			m_bLogic.insert( i, createLogicIn(node) );
-			m_bLogic[i]->setCallback( this, (CallbackPtr)(&MagnitudeComparator::inStateChanged) );
+			m_bLogic[i] = createLogicIn(node);
+			m_inputBus.addInput( m_bLogic[i] );
 		}
 	}
 	else
@@ -174,6 +171,7 @@ void MagnitudeComparator::initPins()
 		{
 			QString id = "A"+QString::number(i);
 			removeDisplayText(id);
+			m_inputBus.removeInput( m_aLogic[i] );
 			removeElement( m_aLogic[i], false );
 			removeNode(id);
 		}
@@ -182,6 +180,7 @@ void MagnitudeComparator::initPins()
 		{
 			QString id = "B"+QString::number(i);
 			removeDisplayText(id);
+			m_inputBus.removeInput( m_bLogic[i] );
 			removeElement( m_bLogic[i], false );
 			removeNode(id);
 		}
@@ -31,6 +31,9 @@ class MagnitudeComparator : public CallbackClass, public Component
 	protected:
 		void initPins();
 		virtual void dataChanged();
+		/**
+		 * Called once the A, B and cascading inputs have settled.
+		 */
 		void inStateChanged();
 		
 		int m_oldABLogicCount;
@@ -40,6 +43,7 @@ class MagnitudeComparator : public CallbackClass, public Component
 	
 		QBitArray m_data;
 		
+		LogicBus m_inputBus;
 		QVector<LogicIn*> m_aLogic;
 		QVector<LogicIn*> m_bLogic;
 		QVector<LogicIn*> m_cLogic;
@@ -44,6 +44,7 @@ MatrixDisplay::MatrixDisplay( ICNDocument *icnDocument, bool newItem, const char
 {
 	m_name = i18n("Matrix Display");
 	m_bDynamicContent = true;
+	setDynamic(true);
 	
 	//BEGIN Reset members
 	for ( unsigned i = 0; i < max_md_height; i++ )
@@ -51,7 +52,6 @@ MatrixDisplay::MatrixDisplay( ICNDocument *icnDocument, bool newItem, const char
 	for ( unsigned i = 0; i < max_md_width; i++ )
 		m_pColNodes[i] = 0l;
 	
-	m_lastUpdatePeriod = 0.0;
 	m_r = m_g = m_b = 0.0;
 	m_bRowCathode = true;
 	m_numRows = 0;
@@ -119,6 +119,8 @@ void MatrixDisplay::dataChanged()
 					m_pDiodes[i][j] = createDiode( m_pColNodes[i], m_pRowNodes[j] );
 				else
 					m_pDiodes[i][j] = createDiode( m_pRowNodes[j], m_pColNodes[i] );
+				
+				LED::integrateBrightness( m_pDiodes[i][j] );
 			}
 		}
 	}
@@ -136,8 +138,6 @@ void MatrixDisplay::initPins( unsigned numRows, unsigned numCols )
 	if ( numCols > max_md_width )
 		numCols = max_md_width;
 	
-	m_lastUpdatePeriod = 0.0;
-	
 	//BEGIN Remove diodes
 	// All the diodes are going to be readded from dataChanged (where this
 	// function is called from), so easiest just to delete the diodes now and
@@ -149,19 +149,16 @@ void MatrixDisplay::initPins( unsigned numRows, unsigned numCols )
 			removeElement( m_pDiodes[i][j], false );
 	}
 	
-	m_avgBrightness.resize(numCols);
 	m_lastBrightness.resize(numCols);
 	m_pDiodes.resize(numCols);
 	
 	for ( unsigned i = 0; i < numCols; i++ )
 	{
-		m_avgBrightness[i].resize(numRows);
 		m_lastBrightness[i].resize(numRows);
 		m_pDiodes[i].resize(numRows);
 		
 		for ( unsigned j = 0; j < numRows; j++ )
 		{
-			m_avgBrightness[i][j] = 0.0;
 			m_lastBrightness[i][j] = 255;
 			m_pDiodes[i][j] = 0l;
 		}
@@ -232,17 +229,6 @@ QString MatrixDisplay::rowPinID( int row ) const
 	return QString("row_%1").arg(QString::number(row));
 }
 
-void MatrixDisplay::stepNonLogic()
-{
-	for ( unsigned i = 0; i < m_numCols; i++ )
-	{
-		for ( unsigned j = 0; j < m_numRows; j++ )
-			m_avgBrightness[i][j] += LED::brightness( m_pDiodes[i][j]->current() ) * LINEAR_UPDATE_PERIOD;
-	}
-	
-	m_lastUpdatePeriod += LINEAR_UPDATE_PERIOD;
-}
-
 void MatrixDisplay::drawShape( QPainter &p )
 {
 	if ( isSelected() )
@@ -262,8 +248,7 @@ void MatrixDisplay::drawShape( QPainter &p )
 	{
 		for ( int j = 0; j < int(m_numRows); j++ )
 		{
-			if ( m_lastUpdatePeriod > minUpdatePeriod )
-				m_lastBrightness[i][j] = unsigned(m_avgBrightness[i][j]/m_lastUpdatePeriod);
+			LED::averageBrightness( m_pDiodes[i][j], &m_lastBrightness[i][j], minUpdatePeriod );
 			
 			double _b = m_lastBrightness[i][j];
 			
@@ -274,16 +259,5 @@ void MatrixDisplay::drawShape( QPainter &p )
 		}
 	}
 	
-	if ( m_lastUpdatePeriod > minUpdatePeriod )
-	{
-		m_lastUpdatePeriod = 0.0;
-	
-		for ( unsigned i = 0; i < m_numCols; i++ )
-		{
-			for ( unsigned j = 0; j < m_numRows; j++ )
-				m_avgBrightness[i][j] = 0.0;
-		}
-	}
-	
 	deinitPainter(p);
 }
@@ -29,9 +29,6 @@ class MatrixDisplay : public Component
 		static Item* construct( ItemDocument *itemDocument, bool newItem, const char *id );
 		static LibraryItem *libraryItem();
 	
-		virtual void stepNonLogic();
-		virtual bool doesStepNonLogic() const { return true; }
-		
 	protected:
 		virtual void drawShape( QPainter &p );
 		virtual void dataChanged();
@@ -40,15 +37,12 @@ class MatrixDisplay : public Component
 		QString rowPinID( int row ) const;
 		
 		
-		QVector< QVector<double> > m_avgBrightness;
 		QVector< QVector<unsigned> > m_lastBrightness;
 		QVector< QVector<Diode*> > m_pDiodes;
 		
 		ECNode * m_pRowNodes[max_md_height];
 		ECNode * m_pColNodes[max_md_width];
 		
-		double m_lastUpdatePeriod;
-		
 		double m_r, m_g, m_b;
 		bool m_bRowCathode;
 		
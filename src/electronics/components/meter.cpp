@@ -34,6 +34,7 @@ Meter::Meter( ICNDocument *icnDocument, bool newItem, const char *id )
 	b_firstRun = true;
 	m_prevProp = 0.0;
 	setSize( -16, -16, 32, 32 );
+	setDynamic(true);
 
 	p_displayText = addDisplayText( "meter", QRect( -16, 16, 32, 16 ), displayText() );
 	
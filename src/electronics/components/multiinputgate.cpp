@@ -43,6 +43,7 @@ MultiInputGate::MultiInputGate( ICNDocument *icnDocument, bool newItem, const ch
 	
 	init1PinRight(16);
 	m_pOut = createLogicOut( m_pPNode[0], false );
+	m_gate.setOutput( m_pOut );
 	
 	createProperty( "numInput", Variant::Type::Int );
 	property("numInput")->setCaption( i18n("Number Inputs") );
@@ -133,6 +134,9 @@ void MultiInputGate::updateInputs( int newNum )
 	setSize( r, true );
 	updateSymbolText();
 	
+	// The inputs that are removed below are deleted
+	m_gate.clearInputs();
+	
 	const bool added = ( newNum > m_numInputs );
 	if (added)
 	{
@@ -156,6 +160,7 @@ void MultiInputGate::updateInputs( int newNum )
 	}
 	
 	m_numInputs = newNum;
+	m_gate.setInputs( inLogic, m_numInputs );
 	
 	// We can't call a pure-virtual function if we haven't finished our constructor yet...
 	if (m_bDoneInit)
@@ -246,6 +251,7 @@ ECXnor::ECXnor( ICNDocument *icnDocument, bool newItem, const char *id )
 {
 	m_name = i18n("XNOR gate");
 	
+	m_gate.setFunction( LogicGate::OneHigh, m_bInvertedOutput );
 	inStateChanged(false);
 }
 
@@ -315,6 +321,7 @@ ECXor::ECXor( ICNDocument *icnDocument, bool newItem, const char *id )
 {
 	m_name = i18n("XOR gate");
 	
+	m_gate.setFunction( LogicGate::OneHigh, m_bInvertedOutput );
 	inStateChanged(false);
 }
 
@@ -382,6 +389,7 @@ ECOr::ECOr( ICNDocument *icnDocument, bool newItem, const char *id )
 {
 	m_name = i18n("OR gate");
 	
+	m_gate.setFunction( LogicGate::AnyHigh, m_bInvertedOutput );
 	inStateChanged(false);
 }
 
@@ -450,6 +458,7 @@ ECNor::ECNor( ICNDocument *icnDocument, bool newItem, const char *id )
 {
 	m_name = i18n("NOR Gate");
 	
+	m_gate.setFunction( LogicGate::AnyHigh, m_bInvertedOutput );
 	inStateChanged(false);
 }
 
@@ -518,6 +527,7 @@ ECNand::ECNand( ICNDocument *icnDocument, bool newItem, const char *id )
 {
 	m_name = i18n("NAND Gate");
 	
+	m_gate.setFunction( LogicGate::AllHigh, m_bInvertedOutput );
 	inStateChanged(false);
 }
 
@@ -581,6 +591,7 @@ ECAnd::ECAnd( ICNDocument *icnDocument, bool newItem, const char *id )
 {
 	m_name = i18n("AND Gate");
 	
+	m_gate.setFunction( LogicGate::AllHigh, m_bInvertedOutput );
 	inStateChanged(false);
 }
 
@@ -67,6 +67,7 @@ class MultiInputGate : public CallbackClass, public Component
 		LogicIn *inLogic[maxGateInput];
 		ECNode *inNode[maxGateInput];
 		LogicOut * m_pOut;
+		LogicGate m_gate; ///< Evaluates the gate when it has at most LogicGate::MaxInputs inputs
 		LogicSymbolShape m_logicSymbolShape;
 		QString m_rectangularShapeText;
 		bool m_bInvertedOutput;
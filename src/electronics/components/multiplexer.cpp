@@ -41,6 +41,7 @@ Multiplexer::Multiplexer( ICNDocument *icnDocument, bool newItem, const char *id
 	m_name = i18n("Multiplexer");
 	
 	m_output = 0l;
+	m_inputBus.setCallback( this, (BusCallbackPtr)(&Multiplexer::inputsChanged) );
 	
 	createProperty( "addressSize", Variant::Type::Int );
 	property("addressSize")->setCaption( i18n("Address Size") );
@@ -87,15 +88,9 @@ void Multiplexer::dataChanged()
 }
 
 
-void Multiplexer::inStateChanged( bool /*state*/ )
+void Multiplexer::inputsChanged()
 {
-	unsigned long long pos = 0;
-	for ( unsigned i = 0; i < m_aLogic.size(); ++i )
-	{
-		if ( m_aLogic[i]->isHigh() )
-			pos += 1 << i;
-	}
-	m_output->setHigh( m_xLogic[pos]->isHigh() );
+	m_output->setHigh( m_xLogic[ LogicBus::pack(m_aLogic) ]->isHigh() );
 }
 
 
@@ -139,16 +134,16 @@ void Multiplexer::initPins( unsigned newAddressSize )
 		for ( unsigned i=oldXLogicCount; i<newXLogicCount; ++i )
 		{
 			node = ecNodeWithID("X"+QString::number(i));
-			m_xLogic.insert( i, createLogicIn(node) );
-			m_xLogic[i]->setCallback( this, (CallbackPtr)(&Multiplexer::inStateChanged) );
+			m_xLogic[i] = createLogicIn(node);
+			m_inputBus.addInput( m_xLogic[i] );
 		}
 		
 		m_aLogic.resize(newAddressSize);
 		for ( unsigned i=oldAddressSize; i<newAddressSize; ++i )
 		{
 			node = ecNodeWithID("A"+QString::number(i));
-			m_aLogic.insert( i, createLogicIn(node) );
-			m_aLogic[i]->setCallback( this, (CallbackPtr)(&Multiplexer::inStateChanged) );
+			m_aLogic[i] = createLogicIn(node);
+			m_inputBus.addInput( m_aLogic[i] );
 		}
 	}
 	else
@@ -157,6 +152,7 @@ void Multiplexer::initPins( unsigned newAddressSize )
 		{
 			QString id = "X"+QString::number(i);
 			removeDisplayText(id);
+			m_inputBus.removeInput( m_xLogic[i] );
 			removeElement( m_xLogic[i], false );
 			removeNode(id);
 		}
@@ -166,6 +162,7 @@ void Multiplexer::initPins( unsigned newAddressSize )
 		{
 			QString id = "A"+QString::number(i);
 			removeDisplayText(id);
+			m_inputBus.removeInput( m_aLogic[i] );
 			removeElement( m_aLogic[i], false );
 			removeNode(id);
 		}
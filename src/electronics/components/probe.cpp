@@ -80,6 +80,21 @@ FloatingProbe::FloatingProbe( ICNDocument *icnDocument, bool newItem, const char
 	property("lower_abs_value")->setMinValue(0.0);
 	property("lower_abs_value")->setUnit("V");
 	property("lower_abs_value")->setAdvanced(true);
+	
+	createProperty( "trigger", Variant::Type::Select );
+	property("trigger")->setCaption( i18n("Trigger") );
+	QStringMap triggers;
+	triggers["None"] = i18n("None");
+	triggers["Rising"] = i18n("Rising Level");
+	triggers["Falling"] = i18n("Falling Level");
+	triggers["Any"] = i18n("Any Level Crossing");
+	property("trigger")->setAllowed( triggers );
+	property("trigger")->setValue("None");
+	
+	createProperty( "trigger_level", Variant::Type::Double );
+	property("trigger_level")->setCaption( i18n("Trigger Level") );
+	property("trigger_level")->setValue(0.0);
+	property("trigger_level")->setAdvanced(true);
 }
 
 
@@ -99,6 +114,16 @@ void FloatingProbe::dataChanged()
 	
 	m_pFloatingProbeData->setUpperAbsValue( dataDouble("upper_abs_value") );
 	m_pFloatingProbeData->setLowerAbsValue( dataDouble("lower_abs_value") );
+	
+	const QString trigger = dataString("trigger");
+	FloatingProbeData::Trigger mode = FloatingProbeData::NoTrigger;
+	if ( trigger == "Rising" )
+		mode = FloatingProbeData::RisingLevel;
+	else if ( trigger == "Falling" )
+		mode = FloatingProbeData::FallingLevel;
+	else if ( trigger == "Any" )
+		mode = FloatingProbeData::AnyLevel;
+	m_pFloatingProbeData->setTrigger( mode, dataDouble("trigger_level") );
 }
 
 
@@ -246,6 +271,41 @@ LogicProbe::LogicProbe( ICNDocument *icnDocument, bool newItem, const char *id )
 	p_probeData = p_logicProbeData = static_cast<LogicProbeData*>(registerProbe(this));
 	property("color")->setValue( p_probeData->color() );
 	
+	createProperty( "trigger", Variant::Type::Select );
+	property("trigger")->setCaption( i18n("Trigger") );
+	QStringMap triggers;
+	triggers["None"] = i18n("None");
+	triggers["Rising"] = i18n("Rising Edge");
+	triggers["Falling"] = i18n("Falling Edge");
+	triggers["Any"] = i18n("Any Edge");
+	triggers["HighPulse"] = i18n("High Pulse");
+	triggers["LowPulse"] = i18n("Low Pulse");
+	property("trigger")->setAllowed( triggers );
+	property("trigger")->setValue("None");
+	
+	createProperty( "min_pulse_width", Variant::Type::Double );
+	property("min_pulse_width")->setCaption( i18n("Minimum Pulse Width") );
+	property("min_pulse_width")->setUnit("s");
+	property("min_pulse_width")->setValue(0.0);
+	property("min_pulse_width")->setMinValue(0.0);
+	property("min_pulse_width")->setAdvanced(true);
+	
+	createProperty( "max_pulse_width", Variant::Type::Double );
+	property("max_pulse_width")->setCaption( i18n("Maximum Pulse Width") );
+	property("max_pulse_width")->setUnit("s");
+	property("max_pulse_width")->setValue(0.0);
+	property("max_pulse_width")->setMinValue(0.0);
+	property("max_pulse_width")->setAdvanced(true);
+	
+	createProperty( "pattern", Variant::Type::Select );
+	property("pattern")->setCaption( i18n("Trigger Pattern") );
+	QStringMap bits;
+	bits["DontCare"] = i18n("Don't Care");
+	bits["Low"] = i18n("Low");
+	bits["High"] = i18n("High");
+	property("pattern")->setAllowed( bits );
+	property("pattern")->setValue("DontCare");
+	
 	m_pSimulator = Simulator::self();
 	m_pIn->setCallback( this, (CallbackPtr)(&LogicProbe::logicCallback) );
 	logicCallback(false);
@@ -257,6 +317,41 @@ LogicProbe::~LogicProbe()
 }
 
 
+void LogicProbe::dataChanged()
+{
+	Probe::dataChanged();
+	
+	if (!p_logicProbeData)
+		return;
+	
+	const QString trigger = dataString("trigger");
+	LogicProbeData::Trigger mode = LogicProbeData::NoTrigger;
+	if ( trigger == "Rising" )
+		mode = LogicProbeData::RisingEdge;
+	else if ( trigger == "Falling" )
+		mode = LogicProbeData::FallingEdge;
+	else if ( trigger == "Any" )
+		mode = LogicProbeData::AnyEdge;
+	else if ( trigger == "HighPulse" )
+		mode = LogicProbeData::HighPulse;
+	else if ( trigger == "LowPulse" )
+		mode = LogicProbeData::LowPulse;
+	
+	// A maximum width of 0 means that the width is not limited
+	p_logicProbeData->setTrigger( mode,
+			uint64_t( dataDouble("min_pulse_width") * LOGIC_UPDATE_RATE ),
+			uint64_t( dataDouble("max_pulse_width") * LOGIC_UPDATE_RATE ) );
+	
+	const QString pattern = dataString("pattern");
+	if ( pattern == "Low" )
+		p_logicProbeData->setPatternBit( LogicProbeData::PatternLow );
+	else if ( pattern == "High" )
+		p_logicProbeData->setPatternBit( LogicProbeData::PatternHigh );
+	else
+		p_logicProbeData->setPatternBit( LogicProbeData::DontCare );
+}
+
+
 void LogicProbe::logicCallback( bool value )
 {
 	p_logicProbeData->addDataPoint( LogicDataPoint( value, m_pSimulator->time() ) );
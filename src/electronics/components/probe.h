@@ -64,6 +64,11 @@ class VoltageProbe : public FloatingProbe
 		static LibraryItem *libraryItem();
 		
 		virtual void stepNonLogic();
+		/**
+		 * The probe measures the voltage of pin1 relative to pin2.
+		 */
+		Pin * pin1() const { return m_pPin1; }
+		Pin * pin2() const { return m_pPin2; }
 		
 	protected:
 		Pin * m_pPin1;
@@ -83,6 +88,10 @@ class CurrentProbe : public FloatingProbe
 		static LibraryItem *libraryItem();
 		
 		virtual void stepNonLogic();
+		/**
+		 * The probe measures the negated current through this voltage source.
+		 */
+		VoltageSource * voltageSource() const { return m_voltageSource; }
 		
 	protected:
 		VoltageSource *m_voltageSource;
@@ -103,6 +112,7 @@ class LogicProbe : public CallbackClass, public Probe
 		void logicCallback( bool value );
 	
 	protected:
+		virtual void dataChanged();
 		virtual void drawShape( QPainter &p );
 		
 		LogicProbeData * p_logicProbeData;
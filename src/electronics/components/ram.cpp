@@ -44,18 +44,19 @@ RAM::RAM( ICNDocument *icnDocument, bool newItem, const char *id )
 	m_pWE = 0l;
 	m_wordSize = 0;
 	m_addressSize = 0;
+	m_inputBus.setCallback( this, (BusCallbackPtr)(&RAM::inStateChanged) );
 	
-	createProperty( "wordSize", Variant::Type::Int );
-	property("wordSize")->setCaption( i18n("Word Size") );
-	property("wordSize")->setMinValue(1);
-	property("wordSize")->setMaxValue(64);
-	property("wordSize")->setValue(2);
+	m_pWordSize = createProperty( "wordSize", Variant::Type::Int );
+	m_pWordSize->setCaption( i18n("Word Size") );
+	m_pWordSize->setMinValue(1);
+	m_pWordSize->setMaxValue(64);
+	m_pWordSize->setValue(2);
 	
-	createProperty( "addressSize", Variant::Type::Int );
-	property("addressSize")->setCaption( i18n("Address Size") );
-	property("addressSize")->setMinValue(1);
-	property("addressSize")->setMaxValue(24);
-	property("addressSize")->setValue(4);
+	m_pAddressSize = createProperty( "addressSize", Variant::Type::Int );
+	m_pAddressSize->setCaption( i18n("Address Size") );
+	m_pAddressSize->setMinValue(1);
+	m_pAddressSize->setMaxValue(24);
+	m_pAddressSize->setValue(4);
 	
 	m_data = createProperty( "data", Variant::Type::Raw )->value().toBitArray();
 }
@@ -67,8 +68,8 @@ RAM::~RAM()
 
 void RAM::dataChanged()
 {
-	m_wordSize = dataInt("wordSize");
-	m_addressSize = dataInt("addressSize");
+	m_wordSize = m_pWordSize->toInt();
+	m_addressSize = m_pAddressSize->toInt();
 	
 	int newSize = int( m_wordSize * std::pow( 2., m_addressSize ) );
 	m_data.resize(newSize);
@@ -77,10 +78,8 @@ void RAM::dataChanged()
 }
 
 
-void RAM::inStateChanged( bool newState )
+void RAM::inStateChanged()
 {
-	Q_UNUSED(newState);
-	
 	bool cs = m_pCS->isHigh();
 	bool oe = m_pOE->isHigh();
 	bool we = m_pWE->isHigh();
@@ -94,9 +93,7 @@ void RAM::inStateChanged( bool newState )
 	if ( !cs || (!oe && !we) )
 		return;
 	
-	unsigned address = 0;
-	for ( int i = 0; i < m_addressSize; ++i )
-		address += (m_address[i]->isHigh() ? 1 : 0) << i;
+	const unsigned address = LogicBus::pack(m_address);
 	
 	if (we)
 	{
@@ -117,8 +114,8 @@ void RAM::initPins()
 	int oldWordSize = m_dataIn.size();
 	int oldAddressSize = m_address.size();
 	
-	int newWordSize = dataInt("wordSize");
-	int newAddressSize = dataInt("addressSize");
+	int newWordSize = m_pWordSize->toInt();
+	int newAddressSize = m_pAddressSize->toInt();
 	
 	if ( newAddressSize == oldAddressSize &&
 			newWordSize == oldWordSize )
@@ -152,21 +149,21 @@ void RAM::initPins()
 	{
 		node =  ecNodeWithID("CS");
 		m_pCS = createLogicIn(node);
-		m_pCS->setCallback( this, (CallbackPtr)(&RAM::inStateChanged) );
+		m_inputBus.addInput(m_pCS);
 	}
 	
 	if (!m_pOE)
 	{
 		node =  ecNodeWithID("OE");
 		m_pOE = createLogicIn(node);
-		m_pOE->setCallback( this, (CallbackPtr)(&RAM::inStateChanged) );
+		m_inputBus.addInput(m_pOE);
 	}
 	
 	if (!m_pWE)
 	{
 		node =  ecNodeWithID("WE");
 		m_pWE = createLogicIn(node);
-		m_pWE->setCallback( this, (CallbackPtr)(&RAM::inStateChanged) );
+		m_inputBus.addInput(m_pWE);
 	}
 	
 	if ( newWordSize > oldWordSize )
@@ -177,11 +174,11 @@ void RAM::initPins()
 		for ( int i = oldWordSize; i < newWordSize; ++i )
 		{
 			node = ecNodeWithID( QString("DI%1").arg( QString::number(i) ) );
-			m_dataIn.insert( i, createLogicIn(node) );
-			m_dataIn[i]->setCallback( this, (CallbackPtr)(&RAM::inStateChanged) ); 
+			m_dataIn[i] = createLogicIn(node);
+			m_inputBus.addInput( m_dataIn[i] );
 			
 			node = ecNodeWithID( QString("DO%1").arg( QString::number(i) ) );
-			m_dataOut.insert( i, createLogicOut(node, false) );
+			m_dataOut[i] = createLogicOut(node, false);
 		}
 	}
 	else if ( newWordSize < oldWordSize )
@@ -190,6 +187,7 @@ void RAM::initPins()
 		{
 			QString id = QString("DO%1").arg( QString::number(i) );
 			removeDisplayText(id);
+			m_inputBus.removeInput( m_dataIn[i] );
 			removeElement( m_dataIn[i], false );
 			removeNode(id);
 			
@@ -210,8 +208,8 @@ void RAM::initPins()
 		for ( int i = oldAddressSize; i < newAddressSize; ++i )
 		{
 			node = ecNodeWithID( QString("A%1").arg( QString::number(i) ) );
-			m_address.insert( i, createLogicIn(node) );
-			m_address[i]->setCallback( this, (CallbackPtr)(&RAM::inStateChanged) );
+			m_address[i] = createLogicIn(node);
+			m_inputBus.addInput( m_address[i] );
 		}
 	}
 	else if ( newAddressSize < oldAddressSize )
@@ -220,6 +218,7 @@ void RAM::initPins()
 		{
 			QString id = QString("A%1").arg( QString::number(i) );
 			removeDisplayText(id);
+			m_inputBus.removeInput( m_address[i] );
 			removeElement( m_address[i], false );
 			removeNode(id);
 		}
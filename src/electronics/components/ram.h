@@ -32,13 +32,19 @@ class RAM : public CallbackClass, public Component
 	protected:
 		void initPins();
 		virtual void dataChanged();
-		void inStateChanged( bool newState );
+		/**
+		 * Called once the control, address and data inputs have settled.
+		 */
+		void inStateChanged();
 	
 		QBitArray m_data;
+		LogicBus m_inputBus;
 		LogicIn * m_pCS; // Chip select
 		LogicIn * m_pOE; // Output enable
 		LogicIn * m_pWE; // Write enable
 		
+		Property * m_pWordSize;
+		Property * m_pAddressSize;
 		int m_wordSize;
 		int m_addressSize;
 		
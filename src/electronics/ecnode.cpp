@@ -23,11 +23,11 @@
 ECNode::ECNode( ICNDocument *icnDocument, Node::node_type _type, int dir, const QPoint &pos, QString *_id )
 	: Node( icnDocument, _type, dir, pos, _id )
 {
-	m_prevV = 0;
-	m_prevI = 0;
+	m_prevDrawnState = 0;
 	m_pinPoint = 0l;
 	m_bShowVoltageBars = KTLConfig::showVoltageBars();
 	m_bShowVoltageColor = KTLConfig::showVoltageColor();
+	setDynamic( m_bShowVoltageBars || m_bShowVoltageColor );
 
 	if ( icnDocument )
 		icnDocument->registerItem(this);
@@ -72,25 +72,54 @@ void ECNode::setNumPins( unsigned num )
 Pin *ECNode::pin( unsigned num ) const
     { return (num < m_pins.size()) ? m_pins[num] : 0l; }
 
+void ECNode::setShowVoltageBars( bool show )
+{
+	m_bShowVoltageBars = show;
+	setDynamic( m_bShowVoltageBars || m_bShowVoltageColor );
+}
+
+
+void ECNode::setShowVoltageColor( bool show )
+{
+	m_bShowVoltageColor = show;
+	setDynamic( m_bShowVoltageBars || m_bShowVoltageColor );
+}
+
+
+void ECNode::setDynamic( bool yes )
+{
+	Node::setDynamic(yes);
+	if (m_pinPoint)
+		m_pinPoint->setDynamic(yes);
+}
+
+
 void ECNode::setNodeChanged()
 {
 	if ( !canvas() || numPins() != 1 ) return;
 
 	Pin * pin = m_pins[0];
 
-	double v = pin->voltage();
-	double i = pin->current();
+	const int state = drawnState( pin->voltage(), pin->current() );
 
-	if ( v != m_prevV || i != m_prevI ) {
+	if ( state != m_prevDrawnState ) {
 		QRect r = boundingRect();
 // 		r.setCoords( r.left()+(r.width()/2)-1, r.top()+(r.height()/2)-1, r.right()-(r.width()/2)+1, r.bottom()-(r.height()/2)+1 );
-		canvas()->setChanged(r);
-		m_prevV = v;
-		m_prevI = i;
+		if ( isDynamic() )
+			canvas()->setDynamicChanged(r);
+		else	canvas()->setChanged(r);
+		m_prevDrawnState = state;
 	}
 }
 
 
+int ECNode::drawnState( double v, double i ) const
+{
+	Q_UNUSED(i);
+	return m_bShowVoltageColor ? Component::voltageColorIndex( v ) : 0;
+}
+
+
 void ECNode::setParentItem( CNItem * parentItem )
 {
 	Node::setParentItem(parentItem);
@@ -64,9 +64,22 @@ class ECNode : public Node
 			//{ return (num < m_pins.size()) ? m_pins[num] : 0l; }
 
 		bool showVoltageBars() const { return m_bShowVoltageBars; }
-		void setShowVoltageBars( bool show ) { m_bShowVoltageBars = show; }
+		/**
+		 * The node is dynamic on the canvas while it shows either the voltage
+		 * bars or the voltage color.
+		 */
+		void setShowVoltageBars( bool show );
 		bool showVoltageColor() const { return m_bShowVoltageColor; }
-		void setShowVoltageColor( bool show ) { m_bShowVoltageColor = show; }
+		void setShowVoltageColor( bool show );
+		/**
+		 * Also sets the pin point, which is drawn in the voltage color, to be
+		 * dynamic or not.
+		 */
+		virtual void setDynamic( bool yes );
+		/**
+		 * Invalidates the node on the canvas if the way that its voltage and
+		 * current are drawn has changed since the last call.
+		 */
 		void setNodeChanged();
 		
 		/**
@@ -141,10 +154,16 @@ class ECNode : public Node
 		void removeSwitch( Switch * sw );
 
 	protected:
+		/**
+		 * @return a value that changes whenever the drawing of the given
+		 * voltage and current at this node changes. This implementation
+		 * uses the voltage colour.
+		 */
+		virtual int drawnState( double v, double i ) const;
+		
 		bool m_bShowVoltageBars;
 		bool m_bShowVoltageColor;
-		double m_prevV;
-		double m_prevI;
+		int m_prevDrawnState;
 		KtlQCanvasRectangle * m_pinPoint;
 		PinVector m_pins;
 		
@@ -15,11 +15,16 @@
 #include "ecnode.h"
 #include "wire.h"
 
+#include <ktlconfig.h>
+
 ElectronicConnector::ElectronicConnector(ECNode* startNode, ECNode* endNode, ICNDocument* _ICNDocument, QString* id): Connector(startNode, endNode, _ICNDocument, id)
 {
 	m_startEcNode = startNode;
 	m_endEcNode = endNode;
 	
+	// Only drawn according to the simulation if voltages or currents are shown
+	setDynamic( KTLConfig::showVoltageColor() || KTLConfig::animateWires() );
+	
 	if( startNode && endNode ) {
 		connect(startNode, SIGNAL(numPinsChanged(unsigned)), this, SLOT(syncWiresWithNodes()));
 		connect(endNode, SIGNAL(numPinsChanged(unsigned)), this, SLOT(syncWiresWithNodes()));
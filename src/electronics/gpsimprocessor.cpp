@@ -607,33 +607,80 @@ void GpsimDebugger::initAddressToLineMap()
 				delete debugLine;
 		}
 	}
+	
+	initLineIndex();
 }
 
 
-void GpsimDebugger::setBreakpoints( const QString & path, const IntList & lines )
+void GpsimDebugger::initLineIndex()
 {
-	for ( unsigned i = 0; i < m_addressSize; i++ )
+	m_fileIDs.clear();
+	m_lineToAddresses.clear();
+	m_fileAddresses.clear();
+	m_breakpointAddresses.fill( false, m_addressSize );
+	
+	for ( unsigned i = 0; i < m_addressSize; ++i )
 	{
 		DebugLine * dl = m_addressToLineMap[i];
-		if ( !dl || dl->fileName() != path )
+		if ( !dl )
 			continue;
 		
-		dl->setBreakpoint( lines.contains( dl->line() ) );
+		QHash< QString, int >::const_iterator it = m_fileIDs.constFind( dl->fileName() );
+		int id;
+		if ( it == m_fileIDs.constEnd() )
+		{
+			id = m_fileAddresses.size();
+			m_fileIDs.insert( dl->fileName(), id );
+			m_fileAddresses.resize( id + 1 );
+		}
+		else
+			id = it.value();
+		
+		m_fileAddresses[id] << i;
+		m_lineToAddresses[ FileLine( id, dl->line() ) ] << i;
+		
+		if ( dl->isBreakpoint() )
+			m_breakpointAddresses.setBit(i);
 	}
 }
 
 
+int GpsimDebugger::fileID( const QString & path ) const
+{
+	return m_fileIDs.value( path, -1 );
+}
+
+
+void GpsimDebugger::setAddressBreakpoint( unsigned address, bool isBreakpoint )
+{
+	m_addressToLineMap[address]->setBreakpoint( isBreakpoint );
+	m_breakpointAddresses.setBit( address, isBreakpoint );
+}
+
+
+void GpsimDebugger::setBreakpoints( const QString & path, const IntList & lines )
+{
+	int id = fileID( path );
+	if ( id == -1 )
+		return;
+	
+	const QVector<unsigned> & addresses = m_fileAddresses[id];
+	QVector<unsigned>::const_iterator end = addresses.end();
+	for ( QVector<unsigned>::const_iterator it = addresses.begin(); it != end; ++it )
+		setAddressBreakpoint( *it, lines.contains( m_addressToLineMap[*it]->line() ) );
+}
+
+
 void GpsimDebugger::setBreakpoint( const QString & path, int line, bool isBreakpoint )
 {
-	for ( unsigned i = 0; i < m_addressSize; i++ )
-	{
-		if ( !m_addressToLineMap[i] )
-			continue;
-		
-		if ( (m_addressToLineMap[i]->fileName() == path) &&
-					( line == m_addressToLineMap[i]->line() ) )
-			m_addressToLineMap[i]->setBreakpoint(isBreakpoint);
-	}
+	int id = fileID( path );
+	if ( id == -1 )
+		return;
+	
+	const QVector<unsigned> addresses = m_lineToAddresses.value( FileLine( id, line ) );
+	QVector<unsigned>::const_iterator end = addresses.end();
+	for ( QVector<unsigned>::const_iterator it = addresses.begin(); it != end; ++it )
+		setAddressBreakpoint( *it, isBreakpoint );
 }
 
 
@@ -665,11 +712,17 @@ void GpsimDebugger::emitLineReached()
 
 void GpsimDebugger::checkForBreak()
 {
-	DebugLine * currentLine = m_addressToLineMap[ m_pGpsim->picProcessor()->pc->get_value() ];
+	unsigned pc = m_pGpsim->picProcessor()->pc->get_value();
+	bool lineBreakpoint = (pc < m_addressSize) && m_breakpointAddresses.testBit(pc);
+	
+	// Common case: no breakpoint here, and not stepping
+	if ( !lineBreakpoint && (m_stackLevelLowerBreak < 0) )
+		return;
+	
+	DebugLine * currentLine = (pc < m_addressSize) ? m_addressToLineMap[pc] : 0l;
 	int currentStackLevel = int( m_pGpsim->picProcessor()->stack->pointer & m_pGpsim->picProcessor()->stack->stack_mask );
 	
 	bool ontoNextLine = m_pBreakFromOldLine != currentLine;
-	bool lineBreakpoint = currentLine ? currentLine->isBreakpoint() : false;
 	bool stackBreakpoint = m_stackLevelLowerBreak >= currentStackLevel;
 		
 	if ( ontoNextLine && (lineBreakpoint || stackBreakpoint) )
@@ -679,16 +732,15 @@ void GpsimDebugger::checkForBreak()
 
 int GpsimDebugger::programAddress( const QString & path, int line )
 {
-	for ( unsigned i = 0; i < m_addressSize; ++i )
-	{
-		DebugLine * dl = m_addressToLineMap[i];
-		if ( !dl || (dl->line() != line) || (dl->fileName() != path) )
-			continue;
-		
-		return i;
-	}
+	int id = fileID( path );
+	if ( id == -1 )
+		return -1;
 	
-	return -1;
+	QHash< FileLine, QVector<unsigned> >::const_iterator it = m_lineToAddresses.constFind( FileLine( id, line ) );
+	if ( it == m_lineToAddresses.constEnd() )
+		return -1;
+	
+	return it.value().first();
 }
 
 
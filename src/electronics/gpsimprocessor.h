@@ -16,7 +16,10 @@
 
 #include "sourceline.h"
 
+#include <qbitarray.h>
+#include <qhash.h>
 #include <qmap.h>
+#include <qpair.h>
 // #include <q3valuevector.h>
 #include <qobject.h>
 #include <qlist.h>
@@ -224,12 +227,33 @@ class GpsimDebugger : public QObject
 		
 	protected:
 		void initAddressToLineMap();
+		/**
+		 * Builds the file and line lookup tables from m_addressToLineMap.
+		 * Called once the address to line map has been generated.
+		 */
+		void initLineIndex();
+		/**
+		 * @return the ID of the given file in the line index, or -1 if no
+		 * program address is associated with the file.
+		 */
+		int fileID( const QString & path ) const;
+		/**
+		 * Sets whether the line at the given address is a breakpoint, keeping
+		 * the breakpoint bitset in sync with the DebugLine.
+		 */
+		void setAddressBreakpoint( unsigned address, bool isBreakpoint );
 		void stackStep( int dl );
 		void emitLineReached();
 		
+		typedef QPair<int, int> FileLine; // (file ID, line)
+		
 		int m_stackLevelLowerBreak; // Set by step-over, for when the stack level decreases to the one given
 		SourceLine m_previousAtLineEmit; // Used for working out whether we should emit a new line reached signal
 		DebugLine ** m_addressToLineMap;
+		QHash< QString, int > m_fileIDs; // File name to the ID used in m_lineToAddresses
+		QHash< FileLine, QVector<unsigned> > m_lineToAddresses; // Addresses of each line, in increasing order
+		QVector< QVector<unsigned> > m_fileAddresses; // Addresses of each file (indexed by file ID)
+		QBitArray m_breakpointAddresses; // Whether the line at each address is a breakpoint
 		DebugLine * m_pBreakFromOldLine;
 		GpsimProcessor * m_pGpsim;
 		Type m_type;
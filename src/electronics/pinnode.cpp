@@ -56,6 +56,7 @@ PinNode::PinNode(ICNDocument* icnDocument, int dir, const QPoint& pos, QString*
 	m_pinPoint = new KtlQCanvasRectangle( 0, 0, 3, 3, canvas() );
 	m_pinPoint->setBrush(Qt::black);
 	m_pinPoint->setPen( QPen(Qt::black));
+	m_pinPoint->setDynamic( isDynamic() );
 }
 
 
@@ -120,6 +121,21 @@ void PinNode::drawShape( QPainter & p )
 }
 
 
+int PinNode::drawnState( double v, double i ) const
+{
+	int length = 0;
+	int thickness = 0;
+	if ( m_bShowVoltageBars )
+	{
+		length = calcLength( v );
+		thickness = calcThickness( calcIProp( i ) );
+	}
+	
+	// The length is at most vLength and the thickness at most iLength
+	return ((ECNode::drawnState( v, i ) * (4*vLength) + length + 2*vLength) * (2*iLength)) + thickness;
+}
+
+
 void PinNode::initPoints()
 {
 	int l = - m_length;
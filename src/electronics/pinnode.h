@@ -34,6 +34,10 @@ public:
 	
 protected:
 	virtual void initPoints();
+	/**
+	 * Also includes the length and thickness of the voltage bar.
+	 */
+	virtual int drawnState( double v, double i ) const;
 };
 
 #endif
@@ -18,8 +18,11 @@
 #include "nonlinear.h"
 #include "pin.h"
 #include "reactive.h"
+#include "simulationprofiler.h"
 #include "wire.h"
 
+#include <kdebug.h>
+
 //#include <vector>
 #include <cmath>
 #include <map>
@@ -299,6 +302,27 @@ void Circuit::init()
 }
 
 
+void Circuit::solveOperatingPoint()
+{
+	m_operatingPoint = OperatingPointResult();
+	
+	if ( !m_elementSet || m_cnodeCount+m_branchCount <= 0 || !m_elementSet->containsNonLinear() )
+	{
+		m_operatingPoint.converged = true;
+		return;
+	}
+	
+	m_operatingPoint = m_elementSet->solveOperatingPoint();
+	
+	if ( !m_operatingPoint.converged )
+		kWarning() << k_funcinfo << "operating point did not converge after " << m_operatingPoint.iterations
+			<< " iterations (" << m_operatingPoint.gminSteps << " gmin steps, "
+			<< m_operatingPoint.sourceSteps << " source steps)" << endl;
+	
+	updateNodalVoltages();
+}
+
+
 void Circuit::initCache()
 {
 	m_elementSet->updateInfo();
@@ -402,9 +426,13 @@ void Circuit::cacheAndUpdate()
 		}
 	}
 	
+	if ( SimulationProfiler::isEnabled() )
+		SimulationProfiler::self()->addLogicCacheLookup( node->data != 0l );
+	
 	if(node->data) {
 		(*m_elementSet->x()) = *node->data;
 		m_elementSet->updateInfo();
+		m_elementSet->integrateCurrents();
 		return;
 	}
 	
@@ -62,6 +62,14 @@ public:
 
 	bool contains( Pin *node );
 	bool containsNonLinear() const { return m_elementSet->containsNonLinear(); }
+	/**
+		* @return the number of (non-ground) nodes, as found in init().
+		*/
+	int cnodeCount() const { return m_cnodeCount; }
+	/**
+		* @return the number of branches (voltage sources), as found in init().
+		*/
+	int branchCount() const { return m_branchCount; }
 
 	void init();
 	/**
@@ -69,6 +77,17 @@ public:
 		* doLogic are called for the first time. Preps the circuit.
 		*/
 	void initCache();
+	/**
+		* Finds the operating point of a circuit containing nonlinear elements
+		* (using gmin and source stepping if needed), so that the simulation
+		* starts from a converged solution. Called after the elements have been
+		* initialized, before initCache.
+		*/
+	void solveOperatingPoint();
+	/**
+		* @return the diagnostics from the last call to solveOperatingPoint.
+		*/
+	OperatingPointResult operatingPoint() const { return m_operatingPoint; }
 	/**
 		* Marks all cached results as invalidated and removes them.
 		*/
@@ -123,6 +142,7 @@ protected:
 	PinList m_pinList;
 	ElementList m_elementList;
 	ElementSet *m_elementSet;
+	OperatingPointResult m_operatingPoint;
 
 	//Stuff for caching
 	bool m_bCanCache;
@@ -56,11 +56,19 @@ void CurrentSignal::addCurrents()
 	if ( !b_status )
 		return;
 	
-	if ( m_newCurrent == m_oldCurrent )
+	const double current = m_sourceScale * m_newCurrent;
+	if ( current == m_oldCurrent )
 		return;
 
-	b_i( 0 ) -= m_newCurrent-m_oldCurrent;
-	b_i( 1 ) += m_newCurrent-m_oldCurrent;
+	b_i( 0 ) -= current-m_oldCurrent;
+	b_i( 1 ) += current-m_oldCurrent;
 	
-	m_oldCurrent = m_newCurrent;
+	m_oldCurrent = current;
+}
+
+
+void CurrentSignal::setSourceScale( double scale )
+{
+	m_sourceScale = scale;
+	addCurrents();
 }
@@ -28,6 +28,7 @@ public:
 	void setCurrent( double current );
 	double current() { return m_current; }
 	virtual void time_step();
+	virtual void setSourceScale( double scale );
 
 protected:
 	virtual void updateCurrents();
@@ -35,7 +36,7 @@ protected:
 	void addCurrents();
 	
 	double m_current; // Current
-	double m_oldCurrent; // Old calculated current
+	double m_oldCurrent; // Current added to b, including the source scale
 	double m_newCurrent; // New calculated current
 };
 
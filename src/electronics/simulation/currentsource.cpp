@@ -45,8 +45,21 @@ void CurrentSource::add_initial_dc()
 	if (!b_status)
 		return;
 	
-	b_i( 0 ) -= m_i;
-	b_i( 1 ) += m_i;
+	b_i( 0 ) -= m_sourceScale * m_i;
+	b_i( 1 ) += m_sourceScale * m_i;
+}
+
+void CurrentSource::setSourceScale( double scale )
+{
+	if ( scale == m_sourceScale ) return;
+	
+	// Remove the current at the old scale
+	m_i = -m_i;
+	add_initial_dc();
+	m_i = -m_i;
+	
+	m_sourceScale = scale;
+	add_initial_dc();
 }
 
 
@@ -26,6 +26,8 @@ public:
 	
 	virtual Type type() const { return Element_CurrentSource; }
 	void setCurrent( const double i );
+	double current() const { return m_i; }
+	virtual void setSourceScale( double scale );
 
 protected:
 	virtual void updateCurrents();
@@ -12,6 +12,7 @@
 #include "diode.h"
 #include "elementset.h"
 #include "matrix.h"
+#include "simulator.h"
 
 #include <cmath>
 
@@ -41,6 +42,11 @@ Diode::Diode()
 	m_numCNodes = 2;
 	g_new = g_old = I_new = I_old = V_prev = 0.0;
 	updateLim();
+	
+	m_bIntegrateCurrent = false;
+	m_minIntegratedCurrent = m_maxIntegratedCurrent = 0.0;
+	m_integratedCurrent = m_charge = 0.0;
+	m_lastIntegrationTime = m_integrationStart = 0;
 }
 
 
@@ -77,35 +83,68 @@ void Diode::updateCurrents()
 }
 
 
-void Diode::update_dc()
+void Diode::setCurrentIntegration( double minCurrent, double maxCurrent )
 {
-	if (!b_status)
-		return;
+	m_bIntegrateCurrent = true;
+	m_minIntegratedCurrent = minCurrent;
+	m_maxIntegratedCurrent = maxCurrent;
 	
-	calc_eq();
+	m_charge = 0.0;
+	m_lastIntegrationTime = m_integrationStart = Simulator::self()->time();
+	m_integratedCurrent = qBound( minCurrent, current(), maxCurrent );
+}
+
+
+void Diode::doIntegrateCurrent()
+{
+	const long long now = Simulator::self()->time();
+	if ( now > m_lastIntegrationTime )
+	{
+		m_charge += m_integratedCurrent * (now - m_lastIntegrationTime);
+		m_lastIntegrationTime = now;
+	}
 	
-	A_g( 0, 0 ) += g_new - g_old;
-	A_g( 1, 1 ) += g_new - g_old;
-	A_g( 0, 1 ) -= g_new - g_old;
-	A_g( 1, 0 ) -= g_new - g_old;
+	m_integratedCurrent = qBound( m_minIntegratedCurrent, current(), m_maxIntegratedCurrent );
+}
+
+
+bool Diode::takeAverageCurrent( double * average, double minPeriod )
+{
+	if ( !m_bIntegrateCurrent )
+		return false;
 	
-	b_i( 0 ) -= I_new - I_old;
-	b_i( 1 ) += I_new - I_old;
+	doIntegrateCurrent();
 	
-	g_old = g_new;
-	I_old = I_new;
+	const long long period = m_lastIntegrationTime - m_integrationStart;
+	if ( period <= 0 || period <= minPeriod * LOGIC_UPDATE_RATE )
+		return false;
+	
+	*average = m_charge / period;
+	m_charge = 0.0;
+	m_integrationStart = m_lastIntegrationTime;
+	return true;
 }
 
 
-
 #ifndef MIN
 # define MIN(x,y) (((x) < (y)) ? (x) : (y))
 #endif
 
 
+void Diode::update_dc()
+{
+	if (!b_status)
+		return;
+	
+	finishUpdate( exp( prepareUpdate() ) );
+}
 
-void Diode::calc_eq()
+
+double Diode::prepareUpdate()
 {
+	if (!b_status)
+		return 0.0;
+	
 	double N = m_diodeSettings.N;
 	double V_B = m_diodeSettings.V_B;
 // 	double R = m_diodeSettings.R;
@@ -124,14 +163,54 @@ void Diode::calc_eq()
 	
 	V_prev = v;
 	
+	return exponent(v);
+}
+
+
+void Diode::finishUpdate( double exponential )
+{
+	if (!b_status)
+		return;
+	
 	double I_D;
-	calcIg( v, & I_D, & g_new );
+	calcIg( V_prev, exponential, & I_D, & g_new );
 	
-	I_new = I_D - (v * g_new);
+	I_new = I_D - (V_prev * g_new);
+	
+	A_g( 0, 0 ) += g_new - g_old;
+	A_g( 1, 1 ) += g_new - g_old;
+	A_g( 0, 1 ) -= g_new - g_old;
+	A_g( 1, 0 ) -= g_new - g_old;
+	
+	b_i( 0 ) -= I_new - I_old;
+	b_i( 1 ) += I_new - I_old;
+	
+	g_old = g_new;
+	I_old = I_new;
+}
+
+
+double Diode::exponent( double V ) const
+{
+	double N = m_diodeSettings.N;
+	double V_B = m_diodeSettings.V_B;
+	
+	if ( V >= (-3 * N * V_T) )
+		return MIN( V / (N * V_T), KTL_MAX_EXPONENT );
+	else if ( V_B == 0 || V >= -V_B )
+		return 0.0;
+	else
+		return MIN( -(V_B + V) / N / V_T, KTL_MAX_EXPONENT );
 }
 
 
 void Diode::calcIg( double V, double * I_D, double * g ) const
+{
+	calcIg( V, exp( exponent(V) ), I_D, g );
+}
+
+
+void Diode::calcIg( double V, double exponential, double * I_D, double * g ) const
 {
 	double I_S = m_diodeSettings.I_S;
 	double N = m_diodeSettings.N;
@@ -143,8 +222,8 @@ void Diode::calcIg( double V, double * I_D, double * g ) const
 	if ( V >= (-3 * N * V_T) )
 	{
 		if ( g )
-			*g = diodeConductance( V, I_S, N ) + g_tiny;
-		*I_D = diodeCurrent( V, I_S, N ) + (g_tiny * V);
+			*g = (I_S * exponential / (N * V_T)) + g_tiny;
+		*I_D = (I_S * (exponential - 1)) + (g_tiny * V);
 	}
 	else if ( V_B == 0 || V >= -V_B )
 	{
@@ -156,10 +235,9 @@ void Diode::calcIg( double V, double * I_D, double * g ) const
 	}
 	else
 	{
-		double a = exp( -(V_B + V) / N / V_T );
-		*I_D = (-I_S * a) + (g_tiny * V);
+		*I_D = (-I_S * exponential) + (g_tiny * V);
 		if ( g )
-			*g = I_S * a / V_T / N + g_tiny;
+			*g = I_S * exponential / V_T / N + g_tiny;
 	}
 }
 
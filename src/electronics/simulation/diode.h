@@ -54,12 +54,57 @@ class Diode : public NonLinear
 		 * Returns the current flowing through the diode
 		 */
 		double current() const;
+		/**
+		 * The first half of update_dc, used by DiodeBatch: limits the junction
+		 * voltage for this iteration and returns the argument to exp() needed
+		 * to evaluate the diode there.
+		 */
+		double prepareUpdate();
+		/**
+		 * The second half of update_dc: calculates the current and conductance
+		 * given exp() of the value returned by prepareUpdate, and updates the
+		 * matrix and b vector.
+		 */
+		void finishUpdate( double exponential );
+		/**
+		 * Starts keeping the integral over simulated time of the current
+		 * through the diode, limited to between minCurrent and maxCurrent.
+		 * Displays use this to find how bright a LED has been since it was
+		 * last drawn, without having to sample the current every step.
+		 */
+		void setCurrentIntegration( double minCurrent, double maxCurrent );
+		/**
+		 * Adds the (limited) current since the previous call to the integral,
+		 * and takes the current flowing now. The current is constant between
+		 * calls, as ElementSet calls this whenever it has a new solution.
+		 */
+		void integrateCurrent()
+		{
+			if ( m_bIntegrateCurrent )
+				doIntegrateCurrent();
+		}
+		/**
+		 * If the current has been integrated for more than minPeriod seconds
+		 * of simulated time, sets average to the mean limited current over
+		 * that time and restarts the integration.
+		 * @return whether average was set
+		 */
+		bool takeAverageCurrent( double * average, double minPeriod = 0.0 );
 	
 	protected:
 		virtual void updateCurrents();
-		void calc_eq();
+		/**
+		 * @return the argument to exp() that calcIg needs at voltage V (zero
+		 * if it does not need one).
+		 */
+		double exponent( double V ) const;
 		void calcIg( double V, double * I, double * g ) const;
+		/**
+		 * As calcIg, with exponential being exp( exponent(V) ).
+		 */
+		void calcIg( double V, double exponential, double * I, double * g ) const;
 		void updateLim();
+		void doIntegrateCurrent();
 		
 		double g_new, g_old;
 		double I_new, I_old;
@@ -67,6 +112,14 @@ class Diode : public NonLinear
 		double V_lim;
 	
 		DiodeSettings m_diodeSettings;
+		
+		bool m_bIntegrateCurrent;
+		double m_minIntegratedCurrent;
+		double m_maxIntegratedCurrent;
+		double m_integratedCurrent; ///< Limited current since the last integration
+		double m_charge; ///< Integral of the limited current, in amp logic steps
+		long long m_lastIntegrationTime;
+		long long m_integrationStart;
 };
 
 #endif
@@ -0,0 +1,146 @@
+/***************************************************************************
+ *   Copyright (C) 2026 by the KTechLab developers                         *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ ***************************************************************************/
+
+#include "diode.h"
+#include "diodebatch.h"
+
+#include <cmath>
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+static const double EXP_MIN = -708.0;
+static const double EXP_MAX = 709.0;
+static const double LOG2E = 1.44269504088896338700e+00;
+// ln(2) split so that k * LN2_HI is exact for the k used here
+static const double LN2_HI = 6.93147180369123816490e-01;
+static const double LN2_LO = 1.90821492927058770002e-10;
+
+// Taylor coefficients 1/j! of exp(r); for |r| <= ln(2)/2 the truncation error
+// of the degree 12 polynomial is below 2e-16.
+static const int EXP_DEGREE = 12;
+static const double EXP_COEFF[EXP_DEGREE+1] =
+{
+	1.0,
+	1.0,
+	1.0 / 2.0,
+	1.0 / 6.0,
+	1.0 / 24.0,
+	1.0 / 120.0,
+	1.0 / 720.0,
+	1.0 / 5040.0,
+	1.0 / 40320.0,
+	1.0 / 362880.0,
+	1.0 / 3628800.0,
+	1.0 / 39916800.0,
+	1.0 / 479001600.0
+};
+
+
+double DiodeBatch::exp( double x )
+{
+	if ( x < EXP_MIN )
+		x = EXP_MIN;
+	else if ( x > EXP_MAX )
+		x = EXP_MAX;
+	
+	// exp(x) = 2^k * exp(r), with |r| <= ln(2)/2
+	const double k = std::floor( x * LOG2E + 0.5 );
+	const double r = (x - k * LN2_HI) - k * LN2_LO;
+	
+	double p = EXP_COEFF[EXP_DEGREE];
+	for ( int j = EXP_DEGREE - 1; j >= 0; --j )
+		p = p * r + EXP_COEFF[j];
+	
+	return std::ldexp( p, int(k) );
+}
+
+
+DiodeBatch::DiodeBatch()
+{
+}
+
+
+void DiodeBatch::addDiode( Diode * diode )
+{
+	if ( !diode || m_diodes.contains(diode) )
+		return;
+	
+	m_diodes << diode;
+	m_exponents.resize( m_diodes.size() );
+	m_exponentials.resize( m_diodes.size() );
+}
+
+
+void DiodeBatch::integrateCurrents()
+{
+	const QVector<Diode*>::const_iterator end = m_diodes.constEnd();
+	for ( QVector<Diode*>::const_iterator it = m_diodes.constBegin(); it != end; ++it )
+		(*it)->integrateCurrent();
+}
+
+
+void DiodeBatch::update_dc()
+{
+	const int n = m_diodes.size();
+	Diode * const * diodes = m_diodes.constData();
+	double * exponents = m_exponents.data();
+	double * exponentials = m_exponentials.data();
+	
+	for ( int i = 0; i < n; ++i )
+		exponents[i] = diodes[i]->prepareUpdate();
+	
+	exp( exponents, exponentials, n );
+	
+	for ( int i = 0; i < n; ++i )
+		diodes[i]->finishUpdate( exponentials[i] );
+}
+
+
+void DiodeBatch::exp( const double * x, double * y, int n )
+{
+	int i = 0;
+	
+#ifdef __SSE2__
+	const __m128d min = _mm_set1_pd( EXP_MIN );
+	const __m128d max = _mm_set1_pd( EXP_MAX );
+	const __m128d log2e = _mm_set1_pd( LOG2E );
+	const __m128d ln2Hi = _mm_set1_pd( LN2_HI );
+	const __m128d ln2Lo = _mm_set1_pd( LN2_LO );
+	const __m128i bias = _mm_set_epi32( 0, 0, 1023, 1023 );
+	
+	for ( ; i + 1 < n; i += 2 )
+	{
+		__m128d vx = _mm_loadu_pd( x + i );
+		vx = _mm_min_pd( _mm_max_pd( vx, min ), max );
+		
+		// Round to nearest (the default rounding mode); the upper two
+		// 32-bit lanes of ki are zero
+		__m128i ki = _mm_cvtpd_epi32( _mm_mul_pd( vx, log2e ) );
+		__m128d k = _mm_cvtepi32_pd( ki );
+		__m128d r = _mm_sub_pd( _mm_sub_pd( vx, _mm_mul_pd( k, ln2Hi ) ), _mm_mul_pd( k, ln2Lo ) );
+		
+		__m128d p = _mm_set1_pd( EXP_COEFF[EXP_DEGREE] );
+		for ( int j = EXP_DEGREE - 1; j >= 0; --j )
+			p = _mm_add_pd( _mm_mul_pd( p, r ), _mm_set1_pd( EXP_COEFF[j] ) );
+		
+		// Build 2^k from the biased exponent: move k+1023 (always positive
+		// here) into the low half of each 64-bit lane, and shift it into
+		// place
+		__m128i e = _mm_shuffle_epi32( _mm_add_epi32( ki, bias ), _MM_SHUFFLE(3, 1, 3, 0) );
+		e = _mm_slli_epi64( e, 52 );
+		
+		_mm_storeu_pd( y + i, _mm_mul_pd( p, _mm_castsi128_pd(e) ) );
+	}
+#endif
+	
+	for ( ; i < n; ++i )
+		y[i] = exp( x[i] );
+}
@@ -0,0 +1,65 @@
+/***************************************************************************
+ *   Copyright (C) 2026 by the KTechLab developers                         *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ ***************************************************************************/
+
+#ifndef DIODEBATCH_H
+#define DIODEBATCH_H
+
+#include <qvector.h>
+
+class Diode;
+
+/**
+Evaluates all of the diodes in an ElementSet together in each Newton-Raphson
+iteration. Circuits such as LED matrices and seven segment displays contain
+many diodes, and evaluating them one at a time spends most of the time in
+exp(). Here the voltage limiting is done for every diode first, then all of
+the exponentials are computed in one vectorized pass, and finally the
+currents and conductances are stamped into the matrix.
+
+@short Batched evaluation of diodes
+*/
+class DiodeBatch
+{
+	public:
+		DiodeBatch();
+	
+		void addDiode( Diode * diode );
+		bool isEmpty() const { return m_diodes.isEmpty(); }
+		/**
+		 * Does the equivalent of Diode::update_dc for every diode.
+		 */
+		void update_dc();
+		/**
+		 * Calls Diode::integrateCurrent for every diode.
+		 */
+		void integrateCurrents();
+		/**
+		 * Sets y[i] = exp(x[i]) for 0 <= i < n. Uses SSE2 where available, two
+		 * values at a time, and exp(double) for the rest.
+		 *
+		 * x[i] is clamped to [-708, 709] so that the result is always a normal
+		 * double: above 709 this gives exp(709) where std::exp would overflow
+		 * to inf, and below -708 exp(-708) where std::exp would go to zero.
+		 * Within that range the relative error against std::exp is below
+		 * 1e-15.
+		 */
+		static void exp( const double * x, double * y, int n );
+		/**
+		 * The scalar version of exp(const double*, double*, int), with the
+		 * same clamping and accuracy.
+		 */
+		static double exp( double x );
+	
+	protected:
+		QVector<Diode*> m_diodes;
+		QVector<double> m_exponents;
+		QVector<double> m_exponentials;
+};
+
+#endif
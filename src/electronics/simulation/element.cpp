@@ -20,6 +20,7 @@ Element::Element()
 {
 	b_status = false;
 	p_eSet = 0;
+	m_sourceScale = 1.0;
 	b_componentDeleted = false;
 
 	for ( int i = 0; i < MAX_CNODES; i++ )
@@ -162,6 +162,13 @@ public:
 	 * Does the required MNA stuff. This should be called from ElementSet when necessary.
 	 */
 	virtual void add_initial_dc() = 0;
+	/**
+	 * Sets the factor by which independent sources scale the voltage or
+	 * current that they add to b, for source stepping (see
+	 * ElementSet::solveOperatingPoint). Sources reinherit this to update b;
+	 * other elements ignore it. The default is 1.
+	 */
+	virtual void setSourceScale( double scale ) { m_sourceScale = scale; }
 	/**
 	 * This is called from the Component destructor. When elementSetDeleted has
 	 * also been called, this class will delete itself.
@@ -212,6 +219,10 @@ protected:
 	 * pointers to the circuit, and at least one of its nodes is not ground.
 	 */
 	bool b_status;
+	/**
+	 * The factor set by setSourceScale.
+	 */
+	double m_sourceScale;
 
 private:
 	bool b_componentDeleted;
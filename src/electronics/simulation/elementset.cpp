@@ -10,6 +10,7 @@
 
 #include "bjt.h"
 #include "circuit.h"
+#include "diode.h"
 #include "elementset.h"
 #include "element.h"
 #include "logic.h"
@@ -79,7 +80,8 @@ ElementSet::~ElementSet()
 
 void ElementSet::setCacheInvalidated()
 {
-	m_pCircuit->setCacheInvalidated();
+	if (m_pCircuit)
+		m_pCircuit->setCacheInvalidated();
 }
 
 
@@ -91,7 +93,10 @@ void ElementSet::addElement( Element *e )
 	if ( e->isNonLinear() )
 	{
 		b_containsNonLinear = true;
-		m_cnonLinearList.append( static_cast<NonLinear*>(e) );
+		if ( e->type() == Element::Element_Diode )
+			m_diodeBatch.addDiode( static_cast<Diode*>(e) );
+		else
+			m_cnonLinearList.append( static_cast<NonLinear*>(e) );
 	}
 }
 
@@ -120,7 +125,7 @@ void ElementSet::createMatrixMap()
 }
 
 
-void ElementSet::doNonLinear( int maxIterations, double maxErrorV, double maxErrorI )
+bool ElementSet::doNonLinear( int maxIterations, double maxErrorV, double maxErrorI, int * iterations )
 {
 	QuickVector *p_x_prev = new QuickVector(p_x);
 
@@ -130,8 +135,10 @@ void ElementSet::doNonLinear( int maxIterations, double maxErrorV, double maxErr
 	const NonLinearList::iterator end = m_cnonLinearList.end();
 	
 	int k = 0;
+	bool converged = false;
 	do {
 		// Tell the nonlinear elements to update its J, A and b from the newly calculated x
+		m_diodeBatch.update_dc();
 		for ( NonLinearList::iterator it = m_cnonLinearList.begin(); it != end; ++it )
 			(*it)->update_dc();
 
@@ -141,8 +148,11 @@ void ElementSet::doNonLinear( int maxIterations, double maxErrorV, double maxErr
 		p_A->fbSub(p_x);
 		updateInfo();
 		
+		if ( m_pCircuit && SimulationProfiler::isEnabled() )
+			SimulationProfiler::self()->addLUDecomposition();
+		
 		// Now, check for convergence
-		bool converged = true;
+		converged = true;
 		for ( unsigned i = 0; i < m_cn; ++i )
 		{
 			double diff = std::abs( (*p_x_prev)[i] - (*p_x)[i] );
@@ -170,7 +180,111 @@ void ElementSet::doNonLinear( int maxIterations, double maxErrorV, double maxErr
 	}
 	while ( ++k < maxIterations );
 
+	const int done = (k < maxIterations) ? k+1 : maxIterations;
+	
+	// Sets without a circuit are analysis copies, possibly on another thread
+	if ( m_pCircuit && SimulationProfiler::isEnabled() )
+		SimulationProfiler::self()->addNewtonIterations( done );
+	
+	if (iterations)
+		*iterations = done;
+	
+	m_diodeBatch.integrateCurrents();
+
     delete p_x_prev;
+	return converged;
+}
+
+
+// Limits for solveOperatingPoint
+static const int OP_MAX_ITERATIONS = 200;	// Per stage
+static const double OP_GMIN_START = 1e-2;
+static const double OP_GMIN_END = 1e-12;
+static const int OP_SOURCE_STEPS = 20;
+
+
+OperatingPointResult ElementSet::solveOperatingPoint()
+{
+	OperatingPointResult result;
+	
+	if ( !b_containsNonLinear || !p_A )
+	{
+		result.converged = true;
+		return result;
+	}
+	
+	int iterations = 0;
+	
+	// Each fallback starts again from the solution we were given, rather than
+	// from wherever the attempt before it diverged to
+	QuickVector initialX( p_x );
+	
+	// Most circuits converge with plain Newton-Raphson, given enough iterations
+	result.converged = doNonLinear( OP_MAX_ITERATIONS, 1e-9, 1e-12, &iterations );
+	result.iterations += iterations;
+	if ( result.converged )
+		return result;
+	
+	// Gmin stepping: a conductance from every node to ground makes the system
+	// well conditioned. It is reduced a decade at a time, each stage starting
+	// from the solution of the previous one, and then removed.
+	*p_x = initialX;
+	bool stageConverged = true;
+	for ( double gmin = OP_GMIN_START; gmin >= OP_GMIN_END && stageConverged; gmin /= 10.0 )
+	{
+		addGmin(gmin);
+		stageConverged = doNonLinear( OP_MAX_ITERATIONS, 1e-9, 1e-12, &iterations );
+		addGmin(-gmin);
+		
+		result.iterations += iterations;
+		result.gminSteps++;
+	}
+	
+	if ( stageConverged )
+	{
+		result.converged = doNonLinear( OP_MAX_ITERATIONS, 1e-9, 1e-12, &iterations );
+		result.iterations += iterations;
+		if ( result.converged )
+			return result;
+	}
+	
+	// Source stepping: ramp the independent sources up from zero. Only the
+	// sources are scaled; what the diodes and reactive elements add to b
+	// stays as it is, so each step solves the circuit with its sources at
+	// that strength.
+	*p_x = initialX;
+	for ( int step = 1; step <= OP_SOURCE_STEPS; ++step )
+	{
+		setSourceScale( double(step) / OP_SOURCE_STEPS );
+		
+		stageConverged = doNonLinear( OP_MAX_ITERATIONS, 1e-9, 1e-12, &iterations );
+		result.iterations += iterations;
+		result.sourceSteps++;
+		
+		if ( !stageConverged )
+			break;
+	}
+	
+	// Make sure the sources are back at full strength
+	setSourceScale( 1.0 );
+	
+	result.converged = stageConverged;
+	return result;
+}
+
+
+void ElementSet::addGmin( double g )
+{
+	for ( unsigned i = 0; i < m_cn; ++i )
+		p_A->g( i, i ) += g;
+}
+
+
+void ElementSet::setSourceScale( double scale )
+{
+	const ElementList::iterator end = m_elementList.end();
+	for ( ElementList::iterator it = m_elementList.begin(); it != end; ++it )
+		(*it)->setSourceScale( scale );
 }
 
 
@@ -180,7 +294,12 @@ bool ElementSet::doLinear( bool performLU )
 		return false;
 	
 	if (performLU)
+	{
 		p_A->performLU();
+		
+		if ( m_pCircuit && SimulationProfiler::isEnabled() )
+			SimulationProfiler::self()->addLUDecomposition();
+	}
 
 	*p_x = *p_b;   // <<< why does this code work, when I try it, I always get the default shallow copy.
 
@@ -13,6 +13,8 @@
 
 //#include <vector>
 
+#include "diodebatch.h"
+
 #include <qlist.h>
 
 class CBranch;
@@ -28,6 +30,21 @@ class QuickVector;  // not exactly sure how these types of declarations work.
 typedef QList<Element*> ElementList;
 typedef QList<NonLinear*> NonLinearList;
 
+/**
+Diagnostics from ElementSet::solveOperatingPoint.
+*/
+class OperatingPointResult
+{
+	public:
+		OperatingPointResult()
+			: converged(false), iterations(0), gminSteps(0), sourceSteps(0) {}
+	
+		bool converged;
+		int iterations;	///< Newton-Raphson iterations over all stages
+		int gminSteps;	///< Gmin stepping stages used (0 if not needed)
+		int sourceSteps;	///< Source stepping stages used (0 if not needed)
+};
+
 /**
 Steps in simulation of a set of elements:
 (1) Create this class with given number of nodes "n" and voltage sources "m"
@@ -50,6 +67,8 @@ public:
 	 * Create a new circuit, with "n" nodes and "m" voltage sources.
 	 * After creating the circuit, you must call setGround to specify
 	 * the ground nodes, before adding any elements.
+	 * @param circuit the owning circuit; may be null for sets simulated on
+	 * their own (see NetlistSimulation), which are then not profiled
 	 */
 	ElementSet( Circuit * circuit, const int n, const int m );
 	/**
@@ -80,8 +99,19 @@ public:
 	/**
 	 * Solves for nonlinear elements, or just does linear if it doesn't contain
 	 * any nonlinear.
+	 * @param iterations if non-null, set to the number of iterations done
+	 * @return whether the iterations converged
+	 */
+	bool doNonLinear( int maxIterations, double maxErrorV = 1e-9, double maxErrorI = 1e-12, int * iterations = 0l );
+	/**
+	 * Finds the operating point of a set containing nonlinear elements,
+	 * starting from the current solution. This tries plain Newton-Raphson
+	 * with a generous iteration limit first; if that does not converge, it
+	 * falls back to gmin stepping and then to source stepping. Reactive
+	 * elements keep their companion models, so e.g. capacitor voltages carry
+	 * over from the current solution.
 	 */
-	void doNonLinear( int maxIterations, double maxErrorV = 1e-9, double maxErrorI = 1e-12 );
+	OperatingPointResult solveOperatingPoint();
 	/**
 	 * Solves for linear and logic elements.
 	 * @returns true if anything changed
@@ -108,8 +138,23 @@ public:
 	 * Update the nodal voltages and branch currents from the x vector
 	 */
 	void updateInfo();
+	/**
+	 * Tells the diodes that there is a new solution, for those integrating
+	 * their current (see Diode::setCurrentIntegration). doNonLinear does this
+	 * itself; it is needed after updateInfo when x has been set directly.
+	 */
+	void integrateCurrents() { m_diodeBatch.integrateCurrents(); }
 	
 private:
+	/**
+	 * Adds a conductance of g from every node to ground.
+	 */
+	void addGmin( double g );
+	/**
+	 * Scales the independent sources (see Element::setSourceScale).
+	 */
+	void setSourceScale( double scale );
+
 // calc engine stuff 
 	Matrix *p_A;
 	QuickVector *p_x;
@@ -117,7 +162,8 @@ private:
 // end calc engine stuff.
 
 	ElementList m_elementList;
-	NonLinearList m_cnonLinearList;
+	NonLinearList m_cnonLinearList; ///< Nonlinear elements other than diodes
+	DiodeBatch m_diodeBatch;
 
 	uint m_cb;
 	CBranch **m_cbranches; // Pointer to an array of cbranches
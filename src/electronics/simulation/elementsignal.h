@@ -29,6 +29,8 @@ public:
 	~ElementSignal();
 	
 	void setStep(Type type, double frequency );
+	Type signalType() const { return m_type; }
+	double frequency() const { return m_frequency; }
 	/**
 	 * Advances the timer, returns amplitude (between -1 and 1)
 	 */
@@ -38,6 +38,7 @@ class Inductance : public Reactive
 		virtual void time_step();
 		virtual void add_initial_dc();
 		void setInductance( double i );
+		double inductance() const { return m_inductance; }
 
 	protected:
 		virtual void updateCurrents();
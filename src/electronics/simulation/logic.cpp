@@ -37,6 +37,8 @@ LogicIn::LogicIn( LogicConfig config )
 {
 	m_config = config;
 	m_pCallbackFunction = 0l;
+	m_pGate = 0l;
+	m_gateMask = 0;
 	m_numCNodes = 1;
 	m_bLastState = false;
 	m_pNextLogic = 0l;
@@ -76,12 +78,11 @@ void LogicIn::check()
 		newState = p_cnode[0]->v > m_config.risingTrigger;
 	}
 	
-	if ( m_pCallbackFunction && (newState != m_bLastState) )
+	if ( newState != m_bLastState )
 	{
 		m_bLastState = newState;
-		(m_pCallbackObject->*m_pCallbackFunction)(newState);
+		callCallback();
 	}
-	m_bLastState = newState;
 }
 
 
@@ -275,7 +276,17 @@ void LogicOut::add_initial_dc()
 		return;
 	
 	A_g( 0, 0 ) += m_g_out-m_old_g_out;
-	b_i( 0 ) += m_g_out*m_v_out-m_old_g_out*m_old_v_out;
+	b_i( 0 ) += m_sourceScale*(m_g_out*m_v_out-m_old_g_out*m_old_v_out);
+}
+
+void LogicOut::setSourceScale( double scale )
+{
+	// Only the current of the Norton equivalent is a source; the output
+	// conductance stays
+	if ( b_status && !m_bUseLogicChain )
+		b_i( 0 ) += (scale-m_sourceScale)*m_g_out*m_v_out;
+	
+	m_sourceScale = scale;
 }
 
 void LogicOut::updateCurrents()
@@ -334,3 +345,194 @@ void LogicOut::setHigh( bool high )
 }
 //END class LogicOut
 
+
+
+
+//BEGIN class LogicGate
+LogicGate::LogicGate()
+{
+	m_function = AllHigh;
+	m_bInverted = false;
+	m_mask = 0;
+	m_inputs = 0;
+	m_bQueued = false;
+	m_pOut = 0l;
+	m_pNextChanged = 0l;
+}
+
+
+LogicGate::~LogicGate()
+{
+	// As with LogicBus, the inputs usually outlive the gate
+	clearInputs();
+	
+	if ( m_bQueued && !Simulator::isDestroyedSim() )
+		Simulator::self()->removeChangedGate(this);
+}
+
+
+void LogicGate::setFunction( Function function, bool inverted )
+{
+	m_function = function;
+	m_bInverted = inverted;
+}
+
+
+bool LogicGate::setInputs( LogicIn ** inputs, int count )
+{
+	clearInputs();
+	
+	if ( count > MaxInputs )
+		return false;
+	
+	m_inputList.resize( count );
+	for ( int i = 0; i < count; ++i )
+	{
+		const unsigned mask = 1u << i;
+		m_inputList[i] = inputs[i];
+		m_mask |= mask;
+		if ( inputs[i]->isHigh() )
+			m_inputs |= mask;
+		inputs[i]->setGate( this, mask );
+	}
+	
+	return true;
+}
+
+
+void LogicGate::clearInputs()
+{
+	const int count = m_inputList.size();
+	for ( int i = 0; i < count; ++i )
+		m_inputList[i]->setGate( 0l, 0 );
+	
+	m_inputList.clear();
+	m_mask = 0;
+	m_inputs = 0;
+}
+
+
+void LogicGate::queue()
+{
+	m_bQueued = true;
+	Simulator::self()->addChangedGate(this);
+}
+
+
+void LogicGate::evaluate()
+{
+	m_bQueued = false;
+	
+	if ( !m_pOut || !m_mask )
+		return;
+	
+	bool high = false;
+	switch ( m_function )
+	{
+		case AllHigh:
+			high = (m_inputs == m_mask);
+			break;
+			
+		case AnyHigh:
+			high = (m_inputs != 0);
+			break;
+			
+		case OneHigh:
+			// Nonzero with only one bit set
+			high = m_inputs && !(m_inputs & (m_inputs - 1));
+			break;
+	}
+	
+	m_pOut->setHigh( high != m_bInverted );
+}
+//END class LogicGate
+
+
+
+//BEGIN class LogicBus
+LogicBus::LogicBus()
+{
+	m_pCallbackFunction = 0l;
+	m_pCallbackObject = 0l;
+	m_bQueued = false;
+}
+
+
+LogicBus::~LogicBus()
+{
+	// The inputs usually outlive the bus (they are removed with the rest of
+	// the component's elements), so make sure they don't call back into it
+	const QList<LogicIn*>::iterator end = m_inputs.end();
+	for ( QList<LogicIn*>::iterator it = m_inputs.begin(); it != end; ++it )
+		(*it)->setCallback( 0l, (CallbackPtr)0l );
+	
+	if ( m_bQueued && !Simulator::isDestroyedSim() )
+		Simulator::self()->removeChangedBus(this);
+}
+
+
+void LogicBus::addInput( LogicIn * in )
+{
+	if ( !in || m_inputs.contains(in) )
+		return;
+	
+	m_inputs << in;
+	in->setCallback( this, (CallbackPtr)(&LogicBus::inputChanged) );
+}
+
+
+void LogicBus::removeInput( LogicIn * in )
+{
+	if ( !in || !m_inputs.removeAll(in) )
+		return;
+	
+	in->setCallback( 0l, (CallbackPtr)0l );
+}
+
+
+void LogicBus::setCallback( CallbackClass * object, BusCallbackPtr func )
+{
+	m_pCallbackFunction = func;
+	m_pCallbackObject = object;
+}
+
+
+void LogicBus::inputChanged( bool /*isHigh*/ )
+{
+	if ( m_bQueued )
+		return;
+	
+	m_bQueued = true;
+	Simulator::self()->addChangedBus(this);
+}
+
+
+void LogicBus::settle()
+{
+	m_bQueued = false;
+	
+	if (m_pCallbackFunction)
+		(m_pCallbackObject->*m_pCallbackFunction)();
+}
+
+
+unsigned LogicBus::pack( const QVector<LogicIn*> & inputs )
+{
+	unsigned value = 0;
+	const int n = inputs.size();
+	for ( int i = 0; i < n; ++i )
+	{
+		if ( inputs[i]->isHigh() )
+			value |= 1u << i;
+	}
+	return value;
+}
+
+
+void LogicBus::drive( const QVector<LogicOut*> & outputs, unsigned value )
+{
+	const int n = outputs.size();
+	for ( int i = 0; i < n; ++i )
+		outputs[i]->setHigh( value & (1u << i) );
+}
+//END class LogicBus
@@ -15,8 +15,11 @@
 
 #include <qpointer.h>
 #include <qlist.h>
+#include <qvector.h>
 
 class Component;
+class LogicIn;
+class LogicOut;
 class Pin;
 class Simulator;
 
@@ -37,6 +40,89 @@ class LogicConfig
 
 class CallbackClass {};
 typedef void(CallbackClass::*CallbackPtr)( bool isHigh );
+typedef void(CallbackClass::*BusCallbackPtr)();
+
+
+/**
+Compiled evaluation of a simple combinational gate (AND, OR, XOR and their
+inversions). The states of the inputs are kept packed in a word, updated
+directly by the LogicIns as they change, and the gate is evaluated once at the
+end of each logic update in which any input changed. This replaces calling
+back into the component for every input that changes, and having it scan all
+of its inputs each time.
+
+The output is driven one logic update after an input changes, as with a
+callback, so circuits that rely on gate delays (latches built from gates,
+ring oscillators) behave as before.
+
+@short Packed-input evaluation of a logic gate
+*/
+class LogicGate
+{
+	public:
+		enum Function
+		{
+			AllHigh,	///< AND; NAND when inverted
+			AnyHigh,	///< OR; NOR when inverted
+			OneHigh		///< XOR (exactly one input high); XNOR when inverted
+		};
+	
+		/**
+		 * The maximum number of inputs of a compiled gate. Gates with more
+		 * inputs are left to their callbacks.
+		 */
+		static const int MaxInputs = 32;
+	
+		LogicGate();
+		~LogicGate();
+	
+		void setFunction( Function function, bool inverted );
+		void setOutput( LogicOut * out ) { m_pOut = out; }
+		/**
+		 * Routes the state changes of the inputs to the gate. If there are
+		 * more than MaxInputs, the gate is not used and the inputs keep
+		 * calling back as usual.
+		 * @return whether the gate is in use
+		 */
+		bool setInputs( LogicIn ** inputs, int count );
+		/**
+		 * Stops routing state changes of the inputs to the gate. Call this
+		 * before removing inputs from the component.
+		 */
+		void clearInputs();
+		/**
+		 * Called by a LogicIn of the gate when its state changes.
+		 */
+		void setInput( unsigned mask, bool high )
+		{
+			if (high)
+				m_inputs |= mask;
+			else
+				m_inputs &= ~mask;
+			
+			if (!m_bQueued)
+				queue();
+		}
+		/**
+		 * Sets the output from the current inputs. Called from the Simulator.
+		 */
+		void evaluate();
+		
+		void setNextChanged( LogicGate * gate ) { m_pNextChanged = gate; }
+		LogicGate * nextChanged() const { return m_pNextChanged; }
+	
+	protected:
+		void queue();
+	
+		Function m_function;
+		bool m_bInverted;
+		unsigned m_mask;
+		unsigned m_inputs;
+		bool m_bQueued;
+		LogicOut * m_pOut;
+		LogicGate * m_pNextChanged;
+		QVector<LogicIn*> m_inputList;
+};
 
 /**
 Use this class for Logic Inputs - this will have infinite impedance.
@@ -74,6 +160,11 @@ class LogicIn : public Element
 		 * function will be called. At most one Callback can be added per LogicIn.
 		 */
 		void setCallback( CallbackClass * object, CallbackPtr func );
+		/**
+		 * Sends state changes to the given bit of the gate's packed inputs.
+		 * While a gate is set, it is used instead of the callback.
+		 */
+		void setGate( LogicGate * gate, unsigned mask ) { m_pGate = gate; m_gateMask = mask; }
 		/**
 		 * Reads the LogicConfig values in from KTLConfig, and returns them in a
 		 * nice object form.
@@ -92,11 +183,13 @@ class LogicIn : public Element
 		 */
 		void setNextLogic( LogicIn * next ) { m_pNextLogic = next; }
 		/**
-		 * Calls the callback function, if there is one.
+		 * Calls the callback function (or updates the gate), if there is one.
 		 */
 		void callCallback()
 		{
-			if (m_pCallbackFunction)
+			if (m_pGate)
+				m_pGate->setInput( m_gateMask, m_bLastState );
+			else if (m_pCallbackFunction)
 				(m_pCallbackObject->*m_pCallbackFunction)(m_bLastState);
 		}
 	
@@ -107,6 +200,8 @@ class LogicIn : public Element
 		// TODO: fix this crap NO FUNCTION POINTERS
 		CallbackPtr m_pCallbackFunction;
 		CallbackClass * m_pCallbackObject;
+		LogicGate * m_pGate;
+		unsigned m_gateMask;
 		bool m_bLastState;
 		LogicIn * m_pNextLogic;
 		LogicConfig m_config;
@@ -125,6 +220,7 @@ class LogicOut : public LogicIn
 		virtual void setLogic( LogicConfig config );
 		virtual void setElementSet( ElementSet *c );
 		virtual Type type() const { return Element_LogicOut; }
+		virtual void setSourceScale( double scale );
 	
 		/**
 		 * Call this function to override the logic-high output impedance as set by
@@ -211,5 +307,58 @@ class LogicOut : public LogicIn
 		bool m_bUseLogicChain;
 };
 
-#endif
+/**
+Groups the LogicIns of a multi-bit input (e.g. an address or data bus) so
+that the component is called back once per logic update, after every bit
+that changed in that update has settled, instead of once for each bit. This
+avoids evaluating the component with half-updated inputs and driving outputs
+that are overwritten straight away.
+
+@short Multi-bit logic input with a single settled callback
+*/
+class LogicBus : public CallbackClass
+{
+	public:
+		LogicBus();
+		~LogicBus();
+	
+		/**
+		 * Adds the LogicIn to the bus. This replaces any callback set on the
+		 * LogicIn with one to the bus.
+		 */
+		void addInput( LogicIn * in );
+		/**
+		 * Removes the LogicIn from the bus, and clears its callback. Call this
+		 * before removing the LogicIn from the component.
+		 */
+		void removeInput( LogicIn * in );
+		/**
+		 * The function passed will be called by the Simulator at the end of
+		 * any logic update in which one or more inputs of the bus changed.
+		 */
+		void setCallback( CallbackClass * object, BusCallbackPtr func );
+		/**
+		 * Calls the callback function. Called from the Simulator.
+		 */
+		void settle();
+		/**
+		 * @return the states of the inputs packed into a word, with inputs[i]
+		 * as bit i (at most 32 inputs).
+		 */
+		static unsigned pack( const QVector<LogicIn*> & inputs );
+		/**
+		 * Sets outputs[i] to bit i of value (at most 32 outputs). Outputs that
+		 * are already in the right state are left alone.
+		 */
+		static void drive( const QVector<LogicOut*> & outputs, unsigned value );
+	
+	protected:
+		void inputChanged( bool isHigh );
+	
+		QList<LogicIn*> m_inputs;
+		BusCallbackPtr m_pCallbackFunction;
+		CallbackClass * m_pCallbackObject;
+		bool m_bQueued;
+};
 
+#endif
@@ -0,0 +1,303 @@
+/***************************************************************************
+ *   Copyright (C) 2026 by the KTechLab developers                         *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ ***************************************************************************/
+
+#include "capacitance.h"
+#include "currentsignal.h"
+#include "currentsource.h"
+#include "elementset.h"
+#include "inductance.h"
+#include "netlist.h"
+#include "resistance.h"
+#include "voltagepoint.h"
+#include "voltagesignal.h"
+#include "voltagesource.h"
+
+#include <kdebug.h>
+
+//BEGIN class NetlistElement
+NetlistElement::NetlistElement()
+{
+	type = Element::Element_Resistance;
+	value = 0.0;
+	delta = 0.0;
+	signalType = ElementSignal::st_sinusoidal;
+	frequency = 0.0;
+
+	for ( int i = 0; i < MAX_CNODES; ++i )
+		cnodes[i] = noCNode;
+	for ( int i = 0; i < MAX_CBRANCHES; ++i )
+		cbranches[i] = noBranch;
+}
+//END class NetlistElement
+
+
+
+//BEGIN class Netlist
+Netlist::Netlist()
+{
+	m_cnodeCount = 0;
+	m_cbranchCount = 0;
+}
+
+
+bool Netlist::isSupported( Element::Type type )
+{
+	switch ( type )
+	{
+		case Element::Element_Capacitance:
+		case Element::Element_CurrentSignal:
+		case Element::Element_CurrentSource:
+		case Element::Element_Diode:
+		case Element::Element_Inductance:
+		case Element::Element_Resistance:
+		case Element::Element_VoltagePoint:
+		case Element::Element_VoltageSignal:
+		case Element::Element_VoltageSource:
+			return true;
+
+		default:
+			return false;
+	}
+}
+
+
+void Netlist::addCircuit( int cnodeCount, int cbranchCount )
+{
+	m_cnodeCount += cnodeCount;
+	m_cbranchCount += cbranchCount;
+}
+
+
+int Netlist::addElement( Element * element, int cnodeOffset, int cbranchOffset )
+{
+	if ( !element || !isSupported( element->type() ) )
+		return -1;
+
+	NetlistElement e;
+	e.type = element->type();
+
+	for ( int i = 0; i < element->numCNodes(); ++i )
+	{
+		CNode * node = element->cnode(i);
+		if ( !node )
+			e.cnodes[i] = noCNode;
+		else if ( node->isGround )
+			e.cnodes[i] = -1;
+		else
+			e.cnodes[i] = node->n() + cnodeOffset;
+	}
+
+	for ( int i = 0; i < element->numCBranches(); ++i )
+	{
+		CBranch * branch = element->cbranch(i);
+		e.cbranches[i] = branch ? int(branch->n()) + cbranchOffset : noBranch;
+	}
+
+	if ( element->isReactive() )
+		e.delta = static_cast<Reactive*>(element)->delta();
+
+	switch ( e.type )
+	{
+		case Element::Element_Capacitance:
+			e.value = static_cast<Capacitance*>(element)->capacitance();
+			break;
+
+		case Element::Element_CurrentSignal:
+		{
+			CurrentSignal * signal = static_cast<CurrentSignal*>(element);
+			e.value = signal->current();
+			e.signalType = signal->signalType();
+			e.frequency = signal->frequency();
+			break;
+		}
+
+		case Element::Element_CurrentSource:
+			e.value = static_cast<CurrentSource*>(element)->current();
+			break;
+
+		case Element::Element_Diode:
+			e.diodeSettings = static_cast<Diode*>(element)->settings();
+			break;
+
+		case Element::Element_Inductance:
+			e.value = static_cast<Inductance*>(element)->inductance();
+			break;
+
+		case Element::Element_Resistance:
+			e.value = static_cast<Resistance*>(element)->resistance();
+			break;
+
+		case Element::Element_VoltagePoint:
+			e.value = static_cast<VoltagePoint*>(element)->voltage();
+			break;
+
+		case Element::Element_VoltageSignal:
+		{
+			VoltageSignal * signal = static_cast<VoltageSignal*>(element);
+			e.value = signal->voltage();
+			e.signalType = signal->signalType();
+			e.frequency = signal->frequency();
+			break;
+		}
+
+		case Element::Element_VoltageSource:
+			e.value = static_cast<VoltageSource*>(element)->voltage();
+			break;
+
+		default:
+			break;
+	}
+
+	m_elements.append(e);
+	return m_elements.size() - 1;
+}
+//END class Netlist
+
+
+
+//BEGIN class NetlistSimulation
+NetlistSimulation::NetlistSimulation( const Netlist & netlist )
+{
+	m_pElementSet = new ElementSet( 0l, netlist.cnodeCount(), netlist.cbranchCount() );
+
+	for ( int i = 0; i < netlist.elementCount(); ++i )
+	{
+		const NetlistElement & ne = netlist.element(i);
+
+		Element * e = createElement( ne );
+		if ( !e )
+		{
+			kWarning() << k_funcinfo << "unsupported element type " << ne.type << endl;
+			continue;
+		}
+
+		m_elements.append(e);
+		if ( e->isReactive() )
+			m_reactiveElements.append( static_cast<Reactive*>(e) );
+
+		m_pElementSet->addElement(e);
+		e->setCNodes( ne.cnodes[0], ne.cnodes[1], ne.cnodes[2], ne.cnodes[3] );
+		e->setCBranches( ne.cbranches[0], ne.cbranches[1], ne.cbranches[2], ne.cbranches[3] );
+	}
+
+	m_pElementSet->createMatrixMap();
+
+	const QList<Element*>::iterator end = m_elements.end();
+	for ( QList<Element*>::iterator it = m_elements.begin(); it != end; ++it )
+		(*it)->add_initial_dc();
+}
+
+
+NetlistSimulation::~NetlistSimulation()
+{
+	// The elements only delete themselves once both their element set and
+	// component have gone; there is no component here, so delete them after
+	// the element set has let go of them.
+	delete m_pElementSet;
+	qDeleteAll( m_elements );
+}
+
+
+Element * NetlistSimulation::createElement( const NetlistElement & ne )
+{
+	switch ( ne.type )
+	{
+		case Element::Element_Capacitance:
+			return new Capacitance( ne.value, ne.delta );
+
+		case Element::Element_CurrentSignal:
+		{
+			CurrentSignal * signal = new CurrentSignal( ne.delta, ne.value );
+			signal->setStep( ne.signalType, ne.frequency );
+			return signal;
+		}
+
+		case Element::Element_CurrentSource:
+			return new CurrentSource( ne.value );
+
+		case Element::Element_Diode:
+		{
+			Diode * diode = new Diode();
+			diode->setDiodeSettings( ne.diodeSettings );
+			return diode;
+		}
+
+		case Element::Element_Inductance:
+			return new Inductance( ne.value, ne.delta );
+
+		case Element::Element_Resistance:
+			return new Resistance( ne.value );
+
+		case Element::Element_VoltagePoint:
+			return new VoltagePoint( ne.value );
+
+		case Element::Element_VoltageSignal:
+		{
+			VoltageSignal * signal = new VoltageSignal( ne.delta, ne.value );
+			signal->setStep( ne.signalType, ne.frequency );
+			return signal;
+		}
+
+		case Element::Element_VoltageSource:
+			return new VoltageSource( ne.value );
+
+		default:
+			return 0l;
+	}
+}
+
+
+bool NetlistSimulation::start()
+{
+	const QList<Reactive*>::iterator end = m_reactiveElements.end();
+	for ( QList<Reactive*>::iterator it = m_reactiveElements.begin(); it != end; ++it )
+		(*it)->time_step();
+
+	if ( !m_pElementSet->containsNonLinear() )
+	{
+		if ( m_pElementSet->cnodeCount() + m_pElementSet->cbranchCount() > 0 )
+			m_pElementSet->doLinear(true);
+		return true;
+	}
+
+	return m_pElementSet->solveOperatingPoint().converged;
+}
+
+
+void NetlistSimulation::step()
+{
+	if ( m_pElementSet->cnodeCount() + m_pElementSet->cbranchCount() <= 0 )
+		return;
+
+	const QList<Reactive*>::iterator end = m_reactiveElements.end();
+	for ( QList<Reactive*>::iterator it = m_reactiveElements.begin(); it != end; ++it )
+		(*it)->time_step();
+
+	if ( m_pElementSet->containsNonLinear() )
+		m_pElementSet->doNonLinear( 10, 1e-9, 1e-12 );
+	else
+		m_pElementSet->doLinear(true);
+}
+
+
+double NetlistSimulation::voltage( int cnode ) const
+{
+	if ( cnode < 0 || cnode >= m_pElementSet->cnodeCount() )
+		return 0.0;
+	return m_pElementSet->cnodes()[cnode]->v;
+}
+
+
+double NetlistSimulation::current( int cbranch ) const
+{
+	if ( cbranch < 0 || cbranch >= m_pElementSet->cbranchCount() )
+		return 0.0;
+	return m_pElementSet->cbranches()[cbranch]->i;
+}
+//END class NetlistSimulation
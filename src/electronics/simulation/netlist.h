@@ -0,0 +1,142 @@
+/***************************************************************************
+ *   Copyright (C) 2026 by the KTechLab developers                         *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ ***************************************************************************/
+
+#ifndef NETLIST_H
+#define NETLIST_H
+
+#include "diode.h"
+#include "element.h"
+#include "elementsignal.h"
+
+#include <qlist.h>
+#include <qvector.h>
+
+class ElementSet;
+class Reactive;
+
+/**
+The type, connections and parameters of one element in a Netlist.
+*/
+class NetlistElement
+{
+	public:
+		NetlistElement();
+
+		Element::Type type;
+		int cnodes[MAX_CNODES];		///< -1 for ground, noCNode if not connected
+		int cbranches[MAX_CBRANCHES];	///< noBranch if not used
+		/**
+		 * The resistance, capacitance, inductance, voltage or current of the
+		 * element, depending on its type (unused for diodes).
+		 */
+		double value;
+		double delta;	///< Time step of reactive elements
+		ElementSignal::Type signalType;
+		double frequency;
+		DiodeSettings diodeSettings;
+};
+
+
+/**
+A copy of the elements of one or more circuits as plain data. The nodes and
+branches of each circuit are appended to those already in the netlist, and the
+elements refer to them by number, so a netlist can be instantiated as many
+times as needed (see NetlistSimulation) without touching the circuits it was
+taken from. This is what allows analyses to run variants of a circuit on
+worker threads while the document keeps simulating.
+
+Only linear elements, independent sources and diodes are supported; logic and
+the transistor / op-amp models need more state than is copied here.
+
+@short Plain-data copy of circuit elements
+*/
+class Netlist
+{
+	public:
+		Netlist();
+
+		/**
+		 * @return whether elements of the given type can be added.
+		 */
+		static bool isSupported( Element::Type type );
+		/**
+		 * Reserves nodes and branches for another circuit. The elements of the
+		 * circuit should then be added with the previous cnodeCount and
+		 * cbranchCount as offsets.
+		 */
+		void addCircuit( int cnodeCount, int cbranchCount );
+		/**
+		 * Copies the element, which must already have been given its nodes and
+		 * branches by its circuit.
+		 * @return the index of the element in the netlist, or -1 if the type
+		 * of the element is not supported
+		 */
+		int addElement( Element * element, int cnodeOffset, int cbranchOffset );
+
+		int cnodeCount() const { return m_cnodeCount; }
+		int cbranchCount() const { return m_cbranchCount; }
+		int elementCount() const { return m_elements.size(); }
+		NetlistElement & element( int i ) { return m_elements[i]; }
+		const NetlistElement & element( int i ) const { return m_elements[i]; }
+
+	protected:
+		int m_cnodeCount;
+		int m_cbranchCount;
+		QVector<NetlistElement> m_elements;
+};
+
+
+/**
+An independent simulation of a Netlist, with its own ElementSet and elements.
+Nothing here refers to the Simulator, the profiler or any document, so
+different instances can be stepped on different threads.
+
+@short Transient simulation of a netlist
+*/
+class NetlistSimulation
+{
+	public:
+		NetlistSimulation( const Netlist & netlist );
+		~NetlistSimulation();
+
+		/**
+		 * Does the first time step, with all reactive elements starting from
+		 * rest (capacitors discharged, no current in inductors). Circuits with
+		 * nonlinear elements are solved with ElementSet::solveOperatingPoint.
+		 * @return whether the solution converged
+		 */
+		bool start();
+		/**
+		 * Advances the simulation by one time step of the reactive elements,
+		 * like Circuit::doNonLogic.
+		 */
+		void step();
+		/**
+		 * @return the voltage of the given node (0 for ground or for a node
+		 * that is not connected).
+		 */
+		double voltage( int cnode ) const;
+		/**
+		 * @return the current through the given branch.
+		 */
+		double current( int cbranch ) const;
+
+	protected:
+		static Element * createElement( const NetlistElement & element );
+
+		ElementSet * m_pElementSet;
+		QList<Element*> m_elements;
+		QList<Reactive*> m_reactiveElements;
+
+	private:
+		NetlistSimulation( const NetlistSimulation & );
+		NetlistSimulation & operator=( const NetlistSimulation & );
+};
+
+#endif
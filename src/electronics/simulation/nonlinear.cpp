@@ -15,7 +15,7 @@
 using namespace std;
 
 const double KTL_MAX_DOUBLE = 1.7976931348623157e+308;///< 7fefffff ffffffff
-const int KTL_MAX_EXPONENT = int( log( KTL_MAX_DOUBLE ) );
+extern const int KTL_MAX_EXPONENT = int( log( KTL_MAX_DOUBLE ) );
 
 
 NonLinear::NonLinear()
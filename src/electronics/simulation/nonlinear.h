@@ -13,6 +13,11 @@
 
 #include "element.h"
 
+/**
+The largest argument to exp() that does not overflow a double.
+*/
+extern const int KTL_MAX_EXPONENT;
+
 /**
 @short Represents a non-linear circuit element (such as a diode)
 @author David Saxton
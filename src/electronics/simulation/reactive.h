@@ -28,6 +28,7 @@ public:
 	 * Call this function to set the time period (in seconds)
 	 */
 	void setDelta( double delta );
+	double delta() const { return m_delta; }
 	/**
 	 * Called on every time step for the element to update itself
 	 */
@@ -0,0 +1,256 @@
+/***************************************************************************
+ *   Copyright (C) 2026 by the KTechLab developers                         *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ ***************************************************************************/
+
+#include "simulationprofiler.h"
+
+#include <qcoreapplication.h>
+#include <qdom.h>
+#include <qfile.h>
+#include <qtextstream.h>
+#include <qthread.h>
+
+bool SimulationProfiler::s_bEnabled = false;
+
+
+SimulationProfiler * SimulationProfiler::self()
+{
+	static SimulationProfiler profiler;
+	return &profiler;
+}
+
+
+bool SimulationProfiler::isGuiThread()
+{
+	QCoreApplication * app = QCoreApplication::instance();
+	return app && QThread::currentThread() == app->thread();
+}
+
+
+SimulationProfiler::SimulationProfiler()
+{
+	m_timer.start();
+	reset();
+}
+
+
+void SimulationProfiler::setEnabled( bool enabled )
+{
+	if ( enabled == s_bEnabled )
+		return;
+
+	// Don't count the time spent disabled towards the achieved speed
+	m_firstStepStart = -1;
+	m_simulatedNanoseconds = 0;
+	m_stepNanoseconds = 0;
+
+	s_bEnabled = enabled;
+}
+
+
+void SimulationProfiler::reset()
+{
+	for ( int i = 0; i < SectionCount; ++i )
+		m_sections[i] = ProfileCounter();
+
+	m_componentTypes.clear();
+	m_circuits.clear();
+	m_newtonIterations.fill( 0, NewtonIterationBuckets );
+	m_luDecompositions = 0;
+	m_logicCacheHits = 0;
+	m_logicCacheMisses = 0;
+
+	m_simulatorSteps = 0;
+	m_simulatedNanoseconds = 0;
+	m_stepNanoseconds = 0;
+	m_firstStepStart = -1;
+	m_lastStepEnd = -1;
+}
+
+
+void SimulationProfiler::addSectionTime( Section section, qint64 start )
+{
+	ProfileCounter & counter = m_sections[section];
+	counter.calls++;
+	counter.nanoseconds += timestamp() - start;
+}
+
+
+void SimulationProfiler::addComponentTime( const QString & type, qint64 start )
+{
+	ProfileCounter & counter = m_componentTypes[type];
+	counter.calls++;
+	counter.nanoseconds += timestamp() - start;
+}
+
+
+void SimulationProfiler::addCircuitTime( const Circuit * circuit, int nodeCount, int branchCount, qint64 start )
+{
+	CircuitProfile & profile = m_circuits[circuit];
+	profile.calls++;
+	profile.nanoseconds += timestamp() - start;
+	profile.nodeCount = nodeCount;
+	profile.branchCount = branchCount;
+}
+
+
+void SimulationProfiler::addNewtonIterations( int iterations )
+{
+	if ( iterations < 0 )
+		iterations = 0;
+	else if ( iterations >= NewtonIterationBuckets )
+		iterations = NewtonIterationBuckets - 1;
+
+	m_newtonIterations[iterations]++;
+}
+
+
+void SimulationProfiler::addSimulatorStep( qint64 simulatedNanoseconds, qint64 start )
+{
+	qint64 end = timestamp();
+
+	if ( m_firstStepStart == -1 )
+		m_firstStepStart = start;
+
+	m_simulatorSteps++;
+	m_simulatedNanoseconds += simulatedNanoseconds;
+	m_stepNanoseconds += end - start;
+	m_lastStepEnd = end;
+}
+
+
+double SimulationProfiler::achievedSpeed() const
+{
+	if ( m_firstStepStart == -1 || m_lastStepEnd <= m_firstStepStart )
+		return 0.0;
+
+	return double(m_simulatedNanoseconds) / double(m_lastStepEnd - m_firstStepStart);
+}
+
+
+double SimulationProfiler::load() const
+{
+	if ( m_firstStepStart == -1 || m_lastStepEnd <= m_firstStepStart )
+		return 0.0;
+
+	return double(m_stepNanoseconds) / double(m_lastStepEnd - m_firstStepStart);
+}
+
+
+QString SimulationProfiler::sectionName( Section section )
+{
+	switch ( section )
+	{
+		case ComponentStepNonLogic:
+			return "component-step-non-logic";
+		case CircuitNonLogic:
+			return "circuit-non-logic";
+		case LogicCallbacks:
+			return "logic-callbacks";
+		case GpsimExecution:
+			return "gpsim-execution";
+		case CircuitLogic:
+			return "circuit-logic";
+		case LogicChains:
+			return "logic-chains";
+		case LogicGates:
+			return "logic-gates";
+		case LogicBuses:
+			return "logic-buses";
+		case SectionCount:
+			break;
+	}
+	return QString::null;
+}
+
+
+static void setCounterAttributes( QDomElement & element, const ProfileCounter & counter )
+{
+	element.setAttribute( "calls", QString::number( counter.calls ) );
+	element.setAttribute( "nanoseconds", QString::number( counter.nanoseconds ) );
+}
+
+
+QString SimulationProfiler::toXml() const
+{
+	QDomDocument doc( "KTechlabSimulationProfile" );
+	QDomElement root = doc.createElement( "profile" );
+	doc.appendChild( root );
+
+	QDomElement speed = doc.createElement( "speed" );
+	speed.setAttribute( "steps", QString::number( m_simulatorSteps ) );
+	speed.setAttribute( "achieved", QString::number( achievedSpeed() ) );
+	speed.setAttribute( "load", QString::number( load() ) );
+	root.appendChild( speed );
+
+	for ( int i = 0; i < SectionCount; ++i )
+	{
+		QDomElement section = doc.createElement( "section" );
+		section.setAttribute( "name", sectionName( Section(i) ) );
+		setCounterAttributes( section, m_sections[i] );
+		root.appendChild( section );
+	}
+
+	QHash< QString, ProfileCounter >::const_iterator typesEnd = m_componentTypes.end();
+	for ( QHash< QString, ProfileCounter >::const_iterator it = m_componentTypes.begin(); it != typesEnd; ++it )
+	{
+		QDomElement component = doc.createElement( "component" );
+		component.setAttribute( "type", it.key() );
+		setCounterAttributes( component, it.value() );
+		root.appendChild( component );
+	}
+
+	int circuitNumber = 0;
+	QHash< const Circuit *, CircuitProfile >::const_iterator circuitsEnd = m_circuits.end();
+	for ( QHash< const Circuit *, CircuitProfile >::const_iterator it = m_circuits.begin(); it != circuitsEnd; ++it )
+	{
+		QDomElement circuit = doc.createElement( "circuit" );
+		circuit.setAttribute( "id", circuitNumber++ );
+		circuit.setAttribute( "nodes", it.value().nodeCount );
+		circuit.setAttribute( "branches", it.value().branchCount );
+		setCounterAttributes( circuit, it.value() );
+		root.appendChild( circuit );
+	}
+
+	QDomElement newton = doc.createElement( "newton-iterations" );
+	for ( int i = 0; i < NewtonIterationBuckets; ++i )
+	{
+		if ( !m_newtonIterations[i] )
+			continue;
+
+		QDomElement bucket = doc.createElement( "bucket" );
+		bucket.setAttribute( "iterations", i );
+		bucket.setAttribute( "count", QString::number( m_newtonIterations[i] ) );
+		newton.appendChild( bucket );
+	}
+	root.appendChild( newton );
+
+	QDomElement matrix = doc.createElement( "matrix" );
+	matrix.setAttribute( "lu-decompositions", QString::number( m_luDecompositions ) );
+	root.appendChild( matrix );
+
+	QDomElement cache = doc.createElement( "logic-cache" );
+	cache.setAttribute( "hits", QString::number( m_logicCacheHits ) );
+	cache.setAttribute( "misses", QString::number( m_logicCacheMisses ) );
+	root.appendChild( cache );
+
+	return doc.toString();
+}
+
+
+bool SimulationProfiler::saveToFile( const QString & path ) const
+{
+	QFile file( path );
+	if ( !file.open( QIODevice::WriteOnly ) )
+		return false;
+
+	QTextStream stream( &file );
+	stream << toXml();
+	file.close();
+	return true;
+}
@@ -0,0 +1,200 @@
+/***************************************************************************
+ *   Copyright (C) 2026 by the KTechLab developers                         *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ ***************************************************************************/
+
+#ifndef SIMULATIONPROFILER_H
+#define SIMULATIONPROFILER_H
+
+#include <qelapsedtimer.h>
+#include <qhash.h>
+#include <qstring.h>
+#include <qvector.h>
+
+class Circuit;
+
+/**
+Accumulated time spent in one part of the simulation.
+*/
+class ProfileCounter
+{
+	public:
+		ProfileCounter() : calls(0), nanoseconds(0) {}
+
+		quint64 calls;
+		quint64 nanoseconds;
+};
+
+
+/**
+Accumulated time spent solving one circuit.
+*/
+class CircuitProfile : public ProfileCounter
+{
+	public:
+		CircuitProfile() : nodeCount(0), branchCount(0) {}
+
+		int nodeCount;
+		int branchCount;
+};
+
+
+/**
+Opt-in instrumentation of the simulator. Nothing is recorded unless profiling
+has been enabled with setEnabled; the simulation code checks isEnabled (a
+single static flag) before taking any timestamps, so the cost of profiling when
+disabled is one predictable branch per section.
+
+The profiler is not thread-safe, and only records what happens on the GUI
+thread, where the simulator runs. isEnabled may be called from any thread; it
+returns false on other threads, so that e.g. analyses running in a thread pool
+skip profiling as they do when it is disabled. Everything else must only be
+called from the GUI thread.
+
+The recorded data can be viewed in the simulation profiler tool view, or
+written out as XML with toXml / saveToFile.
+*/
+class SimulationProfiler
+{
+	public:
+		/**
+		 * Only call this from the GUI thread.
+		 */
+		static SimulationProfiler * self();
+
+		/**
+		 * The parts of Simulator::step that are timed.
+		 */
+		enum Section
+		{
+			ComponentStepNonLogic,	///< Component::stepNonLogic
+			CircuitNonLogic,		///< Circuit::doNonLogic
+			LogicCallbacks,			///< Component callbacks attached to the simulator
+			GpsimExecution,			///< GpsimProcessor::executeNext
+			CircuitLogic,			///< Circuit::doLogic for changed circuits
+			LogicChains,			///< Propagation of changed LogicOuts
+			LogicGates,				///< Evaluation of compiled LogicGates
+			LogicBuses,				///< Settled LogicBus callbacks
+			SectionCount
+		};
+
+		/**
+		 * Histogram buckets for Newton-Raphson iterations; iteration counts
+		 * greater than or equal to the last bucket are added to the last.
+		 */
+		static const int NewtonIterationBuckets = 32;
+
+		/**
+		 * @return whether profiling is enabled and this is the GUI thread.
+		 */
+		static bool isEnabled() { return s_bEnabled && isGuiThread(); }
+		/**
+		 * Enables or disables profiling. The data recorded so far is kept,
+		 * but the achieved speed and load are measured again from the next
+		 * recorded step, so that the time spent disabled does not count.
+		 */
+		void setEnabled( bool enabled );
+		/**
+		 * Clears all recorded data.
+		 */
+		void reset();
+		/**
+		 * @return a timestamp in nanoseconds, to be passed to one of the add
+		 * functions after the work being timed has been done.
+		 */
+		qint64 timestamp() const { return m_timer.nsecsElapsed(); }
+
+		void addSectionTime( Section section, qint64 start );
+		void addComponentTime( const QString & type, qint64 start );
+		void addCircuitTime( const Circuit * circuit, int nodeCount, int branchCount, qint64 start );
+		/**
+		 * Forgets the time recorded for the circuit. Called by the Simulator
+		 * when the circuit is detached before being deleted, so that the
+		 * report does not list deleted circuits, and a new circuit allocated
+		 * at the same address starts from nothing.
+		 */
+		void removeCircuit( const Circuit * circuit ) { m_circuits.remove( circuit ); }
+		/**
+		 * Records the number of iterations taken by one nonlinear solve.
+		 */
+		void addNewtonIterations( int iterations );
+		/**
+		 * Records that a matrix has been LU decomposed.
+		 */
+		void addLUDecomposition() { m_luDecompositions++; }
+		/**
+		 * Records a lookup in the logic cache of a circuit.
+		 */
+		void addLogicCacheLookup( bool hit ) { if (hit) m_logicCacheHits++; else m_logicCacheMisses++; }
+		/**
+		 * Records one call of Simulator::step.
+		 * @param simulatedNanoseconds the simulated time that the step covered
+		 * @param start timestamp taken at the start of the step
+		 */
+		void addSimulatorStep( qint64 simulatedNanoseconds, qint64 start );
+
+		ProfileCounter section( Section section ) const { return m_sections[section]; }
+		QHash< QString, ProfileCounter > componentTypes() const { return m_componentTypes; }
+		QHash< const Circuit *, CircuitProfile > circuits() const { return m_circuits; }
+		QVector<quint64> newtonIterations() const { return m_newtonIterations; }
+		quint64 luDecompositions() const { return m_luDecompositions; }
+		quint64 logicCacheHits() const { return m_logicCacheHits; }
+		quint64 logicCacheMisses() const { return m_logicCacheMisses; }
+		/**
+		 * @return the ratio of simulated time to wall-clock time since the
+		 * profiler was reset (1.0 when simulated time passes as fast as real
+		 * time).
+		 */
+		double achievedSpeed() const;
+		/**
+		 * @return the fraction of wall-clock time spent inside
+		 * Simulator::step.
+		 */
+		double load() const;
+		/**
+		 * @return the number of calls to Simulator::step recorded.
+		 */
+		quint64 simulatorSteps() const { return m_simulatorSteps; }
+		/**
+		 * @return the section name, as used in the XML dump.
+		 */
+		static QString sectionName( Section section );
+
+		/**
+		 * @return all recorded data as an XML document.
+		 */
+		QString toXml() const;
+		/**
+		 * Writes toXml to the given file.
+		 * @return whether successful
+		 */
+		bool saveToFile( const QString & path ) const;
+
+	protected:
+		SimulationProfiler();
+
+		static bool isGuiThread();
+
+		static bool s_bEnabled;
+
+		QElapsedTimer m_timer;
+		ProfileCounter m_sections[SectionCount];
+		QHash< QString, ProfileCounter > m_componentTypes;
+		QHash< const Circuit *, CircuitProfile > m_circuits;
+		QVector<quint64> m_newtonIterations;
+		quint64 m_luDecompositions;
+		quint64 m_logicCacheHits;
+		quint64 m_logicCacheMisses;
+
+		quint64 m_simulatorSteps;
+		qint64 m_simulatedNanoseconds;
+		qint64 m_stepNanoseconds; // Time spent inside Simulator::step
+		qint64 m_firstStepStart; // -1 if no step has been recorded
+		qint64 m_lastStepEnd;
+};
+
+#endif
@@ -44,7 +44,13 @@ void VoltagePoint::add_initial_dc()
 	A_b( 0, 0 ) = -1;
 	A_c( 0, 0 ) = -1;
 	
-	b_v( 0 ) = m_voltage;
+	b_v( 0 ) = m_sourceScale * m_voltage;
+}
+
+void VoltagePoint::setSourceScale( double scale )
+{
+	m_sourceScale = scale;
+	add_initial_dc();
 }
 
 
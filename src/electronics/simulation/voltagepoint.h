@@ -26,6 +26,7 @@ public:
 	virtual Type type() const { return Element_VoltagePoint; }
 	void setVoltage( const double voltage );
 	double voltage() { return m_voltage; }
+	virtual void setSourceScale( double scale );
 protected:
 	virtual void updateCurrents();
 	virtual void add_initial_dc();
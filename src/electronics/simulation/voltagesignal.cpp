@@ -16,6 +16,7 @@ VoltageSignal::VoltageSignal( const double delta, const double voltage )
 	: Reactive::Reactive(delta)
 {
 	m_voltage = voltage;
+	m_signalVoltage = 0.0;
 	m_numCNodes = 2;
 	m_numCBranches = 1;
 }
@@ -46,7 +47,16 @@ void VoltageSignal::add_initial_dc()
 void VoltageSignal::time_step()
 {
 	if (!b_status) return;
-	b_v( 0 ) =  m_voltage*advance(m_delta);
+	m_signalVoltage = m_voltage*advance(m_delta);
+	b_v( 0 ) = m_sourceScale * m_signalVoltage;
+}
+
+
+void VoltageSignal::setSourceScale( double scale )
+{
+	m_sourceScale = scale;
+	if (!b_status) return;
+	b_v( 0 ) = m_sourceScale * m_signalVoltage;
 }
 
 
@@ -27,6 +27,7 @@ public:
 	virtual Element::Type type() const { return Element_VoltageSignal; }
 	void setVoltage( const double voltage );
 	double voltage() { return m_voltage; }
+	virtual void setSourceScale( double scale );
 	virtual void time_step();
 
 protected:
@@ -35,6 +36,7 @@ protected:
 	
 private:
 	double m_voltage; // Voltage
+	double m_signalVoltage; // Voltage at the current point of the signal
 };
 
 #endif
@@ -45,7 +45,13 @@ void VoltageSource::add_initial_dc()
 	A_b( 1, 0 ) = 1;
 	A_c( 0, 1 ) = 1;
 	
-	b_v( 0 ) = m_v;
+	b_v( 0 ) = m_sourceScale * m_v;
+}
+
+void VoltageSource::setSourceScale( double scale )
+{
+	m_sourceScale = scale;
+	add_initial_dc();
 }
 
 void VoltageSource::updateCurrents()
@@ -25,6 +25,8 @@ public:
 	
 	virtual Type type() const { return Element_VoltageSource; }
 	void setVoltage( const double v );
+	double voltage() const { return m_v; }
+	virtual void setSourceScale( double scale );
 
 protected:
 	virtual void updateCurrents();
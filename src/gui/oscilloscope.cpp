@@ -12,17 +12,21 @@
 #include "oscilloscopedata.h"
 #include "oscilloscopeview.h"
 #include "probe.h"
+#include "probedataexporter.h"
 #include "probepositioner.h"
 #include "simulator.h"
 #include "ktechlab.h"
 
+#include <algorithm>
 #include <cmath>
 #include <kcombobox.h>
 #include <kconfig.h>
 #include <kdebug.h>
+#include <kfiledialog.h>
 #include <kglobal.h>
 #include <kiconloader.h>
 #include <klocalizedstring.h>
+#include <kmessagebox.h>
 #include <knuminput.h>
 // #include <q3button.h>
 #include <qlabel.h>
@@ -76,6 +80,11 @@ Oscilloscope::Oscilloscope( KateMDI::ToolView * parent)
 	connect( resetBtn, SIGNAL(clicked()), this, SLOT(reset()));
 	connect( zoomSlider, SIGNAL(valueChanged(int)), this, SLOT(slotZoomSliderChanged(int)));
 	connect( horizontalScroll, SIGNAL(valueChanged(int)), this, SLOT(slotSliderValueChanged(int)));
+	connect( prevTriggerBtn, SIGNAL(clicked()), this, SLOT(slotPreviousTrigger()));
+	connect( nextTriggerBtn, SIGNAL(clicked()), this, SLOT(slotNextTrigger()));
+	connect( triggeredBtn, SIGNAL(toggled(bool)), this, SLOT(updateScrollbars()));
+	connect( exportBtn, SIGNAL(clicked()), this, SLOT(slotExport()));
+	connect( recordBtn, SIGNAL(toggled(bool)), this, SLOT(slotToggleRecording(bool)));
 	
 // 	connect( pauseBtn, SIGNAL(clicked()), this, SLOT(slotTogglePause()));
 	
@@ -89,11 +98,13 @@ Oscilloscope::Oscilloscope( KateMDI::ToolView * parent)
 	
 	connect( this, SIGNAL(probeRegistered(int, ProbeData *)), probePositioner, SLOT(slotProbeDataRegistered(int, ProbeData *)));
 	connect( this, SIGNAL(probeUnregistered(int)), probePositioner, SLOT(slotProbeDataUnregistered(int)));
+	connect( this, SIGNAL(probeUnregistered(int)), oscilloscopeView, SLOT(redrawView()));
 }
 
 
 Oscilloscope::~Oscilloscope()
 {
+	ProbeDataExporter::self()->stopStreaming();
     m_pSelf = NULL;
 }
 
@@ -261,7 +272,7 @@ void Oscilloscope::reset()
 	for( ProbeDataMap::iterator it = m_probeDataMap.begin(); it != end; ++it)
 		(*it)->eraseData();
 	
-	oscilloscopeView->updateView();
+	oscilloscopeView->redrawView();
 }
 
 
@@ -285,6 +296,18 @@ void Oscilloscope::updateScrollbars()
 	
 	horizontalScroll->setPageStep( uint64_t(oscilloscopeView->width()*sliderTicksPerSecond()/pps));
 	
+	if( triggeredBtn->isChecked())
+	{
+		// Keep the latest trigger at the center of the view, so that a
+		// repeating waveform stands still instead of scrolling past
+		const uint64_t trigger = lastTrigger();
+		if(trigger)
+		{
+			centerOn(trigger);
+			return;
+		}
+	}
+	
 	if(wasAtUpperEnd)
 	{
 		horizontalScroll->setValue( horizontalScroll->maximum());
@@ -319,6 +342,134 @@ int64_t Oscilloscope::scrollTime() const
 }
 
 
+void Oscilloscope::slotExport()
+{
+	// The exporter writes with QFile, so only local files can be offered
+	QString path = KFileDialog::getSaveFileName( KUrl(), ProbeDataExporter::fileFilter(), this, i18n("Export Probe Data"));
+	if( path.isEmpty())
+		return;
+	
+	if( !ProbeDataExporter::self()->exportData( m_probeDataMap.values(), path, ProbeDataExporter::formatForFile( path)))
+		KMessageBox::sorry( this, i18n("Could not write the probe data to \"%1\".", path));
+}
+
+
+void Oscilloscope::slotToggleRecording( bool record)
+{
+	ProbeDataExporter * exporter = ProbeDataExporter::self();
+	
+	if(!record)
+	{
+		exporter->stopStreaming();
+		
+		if( exporter->droppedSamples())
+			KMessageBox::sorry( this, i18n("%1 values could not be recorded, because writing the file could not keep up with the simulation.", exporter->droppedSamples()));
+		return;
+	}
+	
+	QString path = KFileDialog::getSaveFileName( KUrl(), ProbeDataExporter::fileFilter(), this, i18n("Record Probe Data"));
+	if( !path.isEmpty() && exporter->startStreaming( m_probeDataMap.values(), path, ProbeDataExporter::formatForFile( path)))
+		return;
+	
+	if( !path.isEmpty())
+		KMessageBox::sorry( this, i18n("Could not open \"%1\" for writing.", path));
+	
+	recordBtn->blockSignals(true);
+	recordBtn->setChecked(false);
+	recordBtn->blockSignals(false);
+}
+
+
+uint64_t Oscilloscope::centerTime() const
+{
+	return scrollTime() + uint64_t( oscilloscopeView->width() * LOGIC_UPDATE_RATE / pixelsPerSecond() / 2);
+}
+
+
+void Oscilloscope::centerOn( uint64_t time)
+{
+	if(!m_oldestProbe)
+		return;
+	
+	int pageLength = int(oscilloscopeView->width()*sliderTicksPerSecond()/pixelsPerSecond());
+	int64_t timeAsTicks = (int64_t(time) - int64_t(m_oldestProbe->resetTime()))*sliderTicksPerSecond()/LOGIC_UPDATE_RATE;
+	
+	horizontalScroll->setValue( int(timeAsTicks - (pageLength/2)));
+	oscilloscopeView->updateView();
+}
+
+
+bool Oscilloscope::nextTrigger( uint64_t time, uint64_t * next) const
+{
+	bool found = LogicProbeData::patternTriggerIndex().next( time, next);
+	
+	const ProbeDataMap::const_iterator end = m_probeDataMap.end();
+	for( ProbeDataMap::const_iterator it = m_probeDataMap.begin(); it != end; ++it)
+	{
+		uint64_t probeNext;
+		if( (*it)->triggerIndex().next( time, &probeNext) && (!found || probeNext < *next))
+		{
+			*next = probeNext;
+			found = true;
+		}
+	}
+	return found;
+}
+
+
+bool Oscilloscope::previousTrigger( uint64_t time, uint64_t * previous) const
+{
+	bool found = LogicProbeData::patternTriggerIndex().previous( time, previous);
+	
+	const ProbeDataMap::const_iterator end = m_probeDataMap.end();
+	for( ProbeDataMap::const_iterator it = m_probeDataMap.begin(); it != end; ++it)
+	{
+		uint64_t probePrevious;
+		if( (*it)->triggerIndex().previous( time, &probePrevious) && (!found || probePrevious > *previous))
+		{
+			*previous = probePrevious;
+			found = true;
+		}
+	}
+	return found;
+}
+
+
+uint64_t Oscilloscope::lastTrigger() const
+{
+	uint64_t last = LogicProbeData::patternTriggerIndex().last();
+	
+	const ProbeDataMap::const_iterator end = m_probeDataMap.end();
+	for( ProbeDataMap::const_iterator it = m_probeDataMap.begin(); it != end; ++it)
+		last = std::max( last, (*it)->triggerIndex().last());
+	
+	return last;
+}
+
+
+void Oscilloscope::slotNextTrigger()
+{
+	// The scrollbar can only center the view to within one of its ticks, so
+	// skip over the trigger that we may have centered on last time
+	const uint64_t tick = LOGIC_UPDATE_RATE / sliderTicksPerSecond();
+	
+	uint64_t trigger;
+	if( nextTrigger( centerTime() + tick, &trigger))
+		centerOn(trigger);
+}
+
+
+void Oscilloscope::slotPreviousTrigger()
+{
+	const uint64_t tick = LOGIC_UPDATE_RATE / sliderTicksPerSecond();
+	const uint64_t center = centerTime();
+	
+	uint64_t trigger;
+	if( center > tick && previousTrigger( center - tick, &trigger))
+		centerOn(trigger);
+}
+
+
 double Oscilloscope::pixelsPerSecond() const
 {
 	return 2 * MIN_BITS_PER_S * std::pow( 2.0, m_zoomLevel * MIN_MAX_LOG_2_DIFF);
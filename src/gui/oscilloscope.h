@@ -130,6 +130,21 @@ class Oscilloscope : public QWidget, public Ui::OscilloscopeWidget
 		 * @returns number of the probe with the given id, starting from 0, or -1 if no such probe
 		 */
 		int probeNumber( int id) const;
+		/**
+		 * Finds the first trigger of any probe after the given Simulator time.
+		 * @returns false if there is no such trigger
+		 */
+		bool nextTrigger( uint64_t time, uint64_t * next) const;
+		/**
+		 * Finds the last trigger of any probe before the given Simulator time.
+		 * @returns false if there is no such trigger
+		 */
+		bool previousTrigger( uint64_t time, uint64_t * previous) const;
+		/**
+		 * @returns the Simulator time of the latest trigger of any probe, or 0
+		 * if nothing has triggered.
+		 */
+		uint64_t lastTrigger() const;
 		
 	signals:
 		/**
@@ -158,9 +173,37 @@ class Oscilloscope : public QWidget, public Ui::OscilloscopeWidget
 		 * Pause the data capture (e.g. user clicked on pause button)
 		 */
 		void slotTogglePause();
+		/**
+		 * Scrolls the view to center on the next trigger after the one
+		 * currently at the center.
+		 */
+		void slotNextTrigger();
+		/**
+		 * Scrolls the view to center on the trigger before the one currently
+		 * at the center.
+		 */
+		void slotPreviousTrigger();
+		/**
+		 * Asks for a file, and saves the data currently held by the probes
+		 * to it.
+		 */
+		void slotExport();
+		/**
+		 * Starts (asking for a file) or stops streaming the probe data to a
+		 * file.
+		 */
+		void slotToggleRecording( bool record);
 	
 	protected:
 		void getOldestProbe();
+		/**
+		 * Scrolls the view so that the given Simulator time is at its center.
+		 */
+		void centerOn( uint64_t time);
+		/**
+		 * @returns the Simulator time at the center of the view.
+		 */
+		uint64_t centerTime() const;
 		
 		int m_nextId;
 		ProbeData * m_oldestProbe;
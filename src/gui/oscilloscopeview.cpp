@@ -25,13 +25,13 @@
 #include <qevent.h>
 #include <qlabel.h>
 #include <qpainter.h>
-#include <qpixmap.h>
 #include <qscrollbar.h>
 #include <qmenu.h>
 #include <qtimer.h>
 
 #include <algorithm>
 #include <cmath>
+#include <cstring>
 
 using namespace std;
 
@@ -44,7 +44,10 @@ inline uint64_t min( uint64_t a, uint64_t b)
 OscilloscopeView::OscilloscopeView( QWidget *parent, const char *name)
 	: QFrame( parent /*, name */ /*, Qt::WNoAutoErase */ ),
 	b_needRedraw(true),
-	m_pixmap(0),
+	b_needFullRedraw(true),
+	m_pixelsOffset(0),
+	m_pixelsPerSecond(0.0),
+	m_validWidth(0),
 	m_fps(10),
 	m_sliderValueAtClick(-1),
 	m_clickOffsetPos(-1),
@@ -66,7 +69,6 @@ OscilloscopeView::OscilloscopeView( QWidget *parent, const char *name)
 
 OscilloscopeView::~OscilloscopeView()
 {
-	delete m_pixmap;
 }
 
 void OscilloscopeView::updateView()
@@ -77,6 +79,12 @@ void OscilloscopeView::updateView()
 	m_updateViewTmr->start( 1000/m_fps /*, true */ );
 }
 
+void OscilloscopeView::redrawView()
+{
+	b_needFullRedraw = true;
+	updateView();
+}
+
 void OscilloscopeView::updateViewTimeout()
 {
 	b_needRedraw = true;
@@ -97,9 +105,9 @@ void OscilloscopeView::updateTimeLabel()
 
 void OscilloscopeView::resizeEvent( QResizeEvent *e)
 {
-	delete m_pixmap;
-	m_pixmap = new QPixmap( e->size());
+	m_image = QImage( e->size(), QImage::Format_RGB32);
 	b_needRedraw = true;
+	b_needFullRedraw = true;
 	QFrame::resizeEvent(e);
 }
 
@@ -200,86 +208,184 @@ static double lld_modulus( int64_t a, double b)
 }
 
 
-void OscilloscopeView::paintEvent( QPaintEvent *e)
+// Shifts the contents of the image right by dx pixels (left if dx is
+// negative); the columns that are exposed keep their old contents.
+static void scrollImage( QImage * image, int dx)
 {
-	QRect r = e->rect();
+	if( dx == 0) return;
+	
+	const int bytesPerPixel = image->depth() / 8;
+	const int shift = std::abs(dx) * bytesPerPixel;
+	const int length = (image->width() - std::abs(dx)) * bytesPerPixel;
 	
+	for( int y = 0; y < image->height(); ++y)
+	{
+		uchar * line = image->scanLine(y);
+		if( dx > 0)
+			memmove( line + shift, line, length);
+		else
+			memmove( line, line + shift, length);
+	}
+}
+
+
+void OscilloscopeView::paintEvent( QPaintEvent *e)
+{
 	if(b_needRedraw)
 	{
-		updateOutputHeight();
-		const double pixelsPerSecond = Oscilloscope::self()->pixelsPerSecond();
-		
-        if (!m_pixmap) {
-            qWarning() << Q_FUNC_INFO << " unexpected null m_pixmap in " << this;
-            return;
-        }
-
-		QPainter p;
-		//m_pixmap->fill( paletteBackgroundColor());
-        m_pixmap->fill( palette().color( backgroundRole() ));
-		const bool startSuccess = p.begin(m_pixmap);
-        if ((!startSuccess) || (!p.isActive())) {
-            qWarning() << Q_FUNC_INFO << " painter is not active";
-        }
-
-		p.setClipRegion(e->region());
-		
-		//BEGIN Draw vertical marker lines
-		const double divisions = 5.0;
-		const double min_sep = 10.0;
-		
-		double spacing = pixelsPerSecond/(std::pow( divisions, std::floor(std::log(pixelsPerSecond/min_sep)/std::log(divisions))));
-		
-		// Pixels offset is the number of pixels that the view is scrolled along
-		const int64_t pixelsOffset = int64_t(Oscilloscope::self()->scrollTime()*pixelsPerSecond/LOGIC_UPDATE_RATE);
-		double linesOffset = - lld_modulus( pixelsOffset, spacing);
-		
-		int blackness = 256 - int(184.0 * spacing / (min_sep*divisions*divisions));
-		p.setPen( QColor( blackness, blackness, blackness));
-		
-		for( double i = linesOffset; i <= frameRect().width(); i += spacing)
-			p.drawLine( int(i), 1, int(i), frameRect().height()-2);
-		
-		
-		
-		spacing *= divisions;
-		linesOffset = - lld_modulus( pixelsOffset, spacing);
-		
-		blackness = 256 - int(184.0 * spacing / (min_sep*divisions*divisions));
-		p.setPen( QColor( blackness, blackness, blackness));
-		
-		for( double i = linesOffset; i <= frameRect().width(); i += spacing)
-			p.drawLine( int(i), 1, int(i), frameRect().height()-2);
-		
-		
-		
-		spacing *= divisions;
-		linesOffset = - lld_modulus( pixelsOffset, spacing);
-		
-		blackness = 256 - int(184.0);
-		p.setPen( QColor( blackness, blackness, blackness));
-		
-		for( double i = linesOffset; i <= frameRect().width(); i += spacing)
-			p.drawLine( int(i), 1, int(i), frameRect().height()-2);
-		//END Draw vertical marker lines
-		
-		drawLogicData(p);
-		drawFloatingData(p);
-		
-		p.setPen(Qt::black);
-		p.drawRect( frameRect());
-		
+		updateImage();
 		b_needRedraw = false;
 	}
 	
-	//bitBlt( this, r.x(), r.y(), m_pixmap, r.x(), r.y(), r.width(), r.height()); // 2018.12.07
+	if( m_image.isNull()) return;
+	
+	QRect r = e->rect();
 	QPainter p;
     const bool paintStarted = p.begin(this);
     if (!paintStarted) {
         qWarning() << Q_FUNC_INFO << " failed to start painting ";
     }
-    p.drawImage(r, m_pixmap->toImage(), r);
+    p.drawImage(r, m_image, r);
+}
 
+
+void OscilloscopeView::updateImage()
+{
+	if( m_image.isNull()) {
+		qWarning() << Q_FUNC_INFO << " unexpected null m_image in " << this;
+		return;
+	}
+	
+	const int imageWidth = m_image.width();
+	const double pixelsPerSecond = Oscilloscope::self()->pixelsPerSecond();
+	const int64_t pixelsOffset = int64_t(Oscilloscope::self()->scrollTime()*pixelsPerSecond/LOGIC_UPDATE_RATE);
+	
+	// Columns [validFrom, validTo) can be kept after shifting the image.
+	// The frame is drawn again at the edges, so those columns are not kept.
+	int validFrom = imageWidth;
+	int validTo = imageWidth;
+	if( !b_needFullRedraw && pixelsPerSecond == m_pixelsPerSecond)
+	{
+		const int64_t shift = m_pixelsOffset - pixelsOffset;
+		if( shift > -imageWidth && shift < imageWidth)
+		{
+			scrollImage( &m_image, int(shift));
+			validFrom = std::max( 1, int(shift) + 1);
+			validTo = std::min( imageWidth - 1, m_validWidth + int(shift));
+		}
+	}
+	
+	m_pixelsOffset = pixelsOffset;
+	m_pixelsPerSecond = pixelsPerSecond;
+	b_needFullRedraw = false;
+	updateOutputHeight();
+	
+	QPainter p;
+	const bool startSuccess = p.begin(&m_image);
+	if ((!startSuccess) || (!p.isActive())) {
+		qWarning() << Q_FUNC_INFO << " painter is not active";
+	}
+	
+	if( validFrom >= validTo)
+		drawColumns( p, 0, imageWidth);
+	else
+	{
+		drawColumns( p, 0, validFrom);
+		if( validTo < imageWidth)
+			drawColumns( p, validTo, imageWidth);
+	}
+	
+	p.setClipping(false);
+	p.setPen(Qt::black);
+	p.setBrush(Qt::NoBrush);
+	p.drawRect( frameRect());
+	
+	m_validWidth = std::max( 0, std::min( imageWidth, recordedX()));
+}
+
+
+void OscilloscopeView::drawColumns( QPainter & p, int fromX, int toX)
+{
+	const QRect columns( fromX, 0, toX - fromX, m_image.height());
+	p.setClipRect( columns);
+	p.fillRect( columns, palette().color( backgroundRole()));
+	
+	drawGrid(p);
+	drawLogicData( p, fromX);
+	drawFloatingData( p, fromX);
+}
+
+
+void OscilloscopeView::drawGrid( QPainter & p)
+{
+	const double pixelsPerSecond = m_pixelsPerSecond;
+	
+	const double divisions = 5.0;
+	const double min_sep = 10.0;
+	
+	double spacing = pixelsPerSecond/(std::pow( divisions, std::floor(std::log(pixelsPerSecond/min_sep)/std::log(divisions))));
+	
+	double linesOffset = - lld_modulus( m_pixelsOffset, spacing);
+	
+	int blackness = 256 - int(184.0 * spacing / (min_sep*divisions*divisions));
+	p.setPen( QColor( blackness, blackness, blackness));
+	
+	for( double i = linesOffset; i <= frameRect().width(); i += spacing)
+		p.drawLine( int(i), 1, int(i), frameRect().height()-2);
+	
+	
+	
+	spacing *= divisions;
+	linesOffset = - lld_modulus( m_pixelsOffset, spacing);
+	
+	blackness = 256 - int(184.0 * spacing / (min_sep*divisions*divisions));
+	p.setPen( QColor( blackness, blackness, blackness));
+	
+	for( double i = linesOffset; i <= frameRect().width(); i += spacing)
+		p.drawLine( int(i), 1, int(i), frameRect().height()-2);
+	
+	
+	
+	spacing *= divisions;
+	linesOffset = - lld_modulus( m_pixelsOffset, spacing);
+	
+	blackness = 256 - int(184.0);
+	p.setPen( QColor( blackness, blackness, blackness));
+	
+	for( double i = linesOffset; i <= frameRect().width(); i += spacing)
+		p.drawLine( int(i), 1, int(i), frameRect().height()-2);
+}
+
+
+int OscilloscopeView::timeToX( int64_t time) const
+{
+	// Limited so that lines to points far outside the view stay in range
+	const double x = std::floor( double(time) * m_pixelsPerSecond / LOGIC_UPDATE_RATE - double(m_pixelsOffset));
+	return int( std::max( -1e7, std::min( 1e7, x)));
+}
+
+
+int64_t OscilloscopeView::xToTime( int x) const
+{
+	return int64_t( (double(m_pixelsOffset) + x) * LOGIC_UPDATE_RATE / m_pixelsPerSecond);
+}
+
+
+int OscilloscopeView::recordedX() const
+{
+	// Logic probes only record changes, so they are up to date with the
+	// simulator; floating probes record a value every linear step.
+	int64_t end = m_pSimulator->time();
+	
+	const FloatingProbeDataMap::iterator floatingEnd = Oscilloscope::self()->m_floatingProbeDataMap.end();
+	for( FloatingProbeDataMap::iterator it = Oscilloscope::self()->m_floatingProbeDataMap.begin(); it != floatingEnd; ++it)
+	{
+		FloatingProbeData * probe = it.value();
+		if( probe->isEmpty()) continue;
+		end = std::min( end, int64_t( probe->toTime( probe->m_data->size() - 1)));
+	}
+	
+	return timeToX(end);
 }
 
 
@@ -289,9 +395,12 @@ void OscilloscopeView::updateOutputHeight()
 }
 
 
-void OscilloscopeView::drawLogicData( QPainter & p)
+void OscilloscopeView::drawLogicData( QPainter & p, int fromX)
 {
-	const double pixelsPerSecond = Oscilloscope::self()->pixelsPerSecond();
+	const double pixelsPerSecond = m_pixelsPerSecond;
+	
+	// Start a pixel early, so that the lines join up with the columns before
+	const int64_t timeOffset = std::max( int64_t(0), xToTime( fromX - 1));
 	
 	const LogicProbeDataMap::iterator end = Oscilloscope::self()->m_logicProbeDataMap.end();
 	for( LogicProbeDataMap::iterator it = Oscilloscope::self()->m_logicProbeDataMap.begin(); it != end; ++it)
@@ -311,7 +420,6 @@ void OscilloscopeView::drawLogicData( QPainter & p)
 		if(!data->size()) continue;
 		
 		const int midHeight = Oscilloscope::self()->probePositioner->probePosition(probe);
-		const int64_t timeOffset = Oscilloscope::self()->scrollTime();
 		
 		// Draw the horizontal line indicating the midpoint of our output
 		p.setPen( QColor( 228, 228, 228));
@@ -326,7 +434,7 @@ void OscilloscopeView::drawLogicData( QPainter & p)
 		int64_t at = probe->findPos(timeOffset);
 		const int64_t maxAt = probe->m_data->size();
 		int64_t prevTime = (*data)[at].time;
-		int prevX = (at > 0) ? 0 : int((prevTime - timeOffset)*(pixelsPerSecond/LOGIC_UPDATE_RATE));
+		int prevX = std::max( fromX - 1, timeToX(prevTime));
 		bool prevHigh = (*data)[at].value;
 		int prevY = midHeight + int(prevHigh ? -m_halfOutputHeight : +m_halfOutputHeight);
 
@@ -366,7 +474,7 @@ void OscilloscopeView::drawLogicData( QPainter & p)
 			if( nextHigh == prevHigh) continue;
 
 			int64_t nextTime = (*data)[at].time;
-			int nextX = int((nextTime - timeOffset)*(pixelsPerSecond/LOGIC_UPDATE_RATE));
+			int nextX = timeToX(nextTime);
 			int nextY = midHeight + int(nextHigh ? -m_halfOutputHeight : +m_halfOutputHeight);
 			
 			p.drawLine( prevX, prevY, nextX, prevY);
@@ -389,9 +497,10 @@ void OscilloscopeView::drawLogicData( QPainter & p)
 
 #define v_to_y int(midHeight - (logarithmic ? ( (v>0) ? log(v/lowerAbsValue) : -log(-v/lowerAbsValue)) : v) * sf)
 
-void OscilloscopeView::drawFloatingData(QPainter &p)
+void OscilloscopeView::drawFloatingData(QPainter &p, int fromX)
 {
-	const double pixelsPerSecond = Oscilloscope::self()->pixelsPerSecond();
+	// Start a pixel early, so that the lines join up with the columns before
+	const int64_t timeOffset = std::max( int64_t(0), xToTime( fromX - 1));
 
 	const FloatingProbeDataMap::iterator end = Oscilloscope::self()->m_floatingProbeDataMap.end();
 	for(FloatingProbeDataMap::iterator it = Oscilloscope::self()->m_floatingProbeDataMap.begin(); it != end; ++it) {
@@ -405,7 +514,6 @@ void OscilloscopeView::drawFloatingData(QPainter &p)
 		double sf = m_halfOutputHeight / (logarithmic ? log(probe->upperAbsValue()/lowerAbsValue) : probe->upperAbsValue());
 
 		const int midHeight = Oscilloscope::self()->probePositioner->probePosition(probe);
-		const int64_t timeOffset = Oscilloscope::self()->scrollTime();
 
 		// Draw the horizontal line indicating the midpoint of our output
 		p.setPen( QColor( 228, 228, 228));
@@ -416,21 +524,21 @@ void OscilloscopeView::drawFloatingData(QPainter &p)
 
 		int64_t at = probe->findPos(timeOffset);
 		const int64_t maxAt = probe->m_data->size();
-		if(at > maxAt) at = maxAt;
+		if(at >= maxAt) at = maxAt - 1;
 		int64_t prevTime = probe->toTime(at);
 
-		double v = (*data)[(at>0)?at:0];
+		double v = (*data)[at];
 		int prevY = v_to_y;
-		int prevX = int((prevTime - timeOffset)*(pixelsPerSecond/LOGIC_UPDATE_RATE));
+		int prevX = timeToX(prevTime);
 
-		while ( at < maxAt) {
+		while ( at + 1 < maxAt) {
 			at++;
 
 			uint64_t nextTime = prevTime + uint64_t(LOGIC_UPDATE_RATE * LINEAR_UPDATE_PERIOD);
 
-			double v = (*data)[(at>0)?at:0];
+			double v = (*data)[at];
 			int nextY = v_to_y;
-			int nextX = int((nextTime - timeOffset)*(pixelsPerSecond/LOGIC_UPDATE_RATE));
+			int nextX = timeToX(nextTime);
 
 			p.drawLine( prevX, prevY, nextX, nextY);
 
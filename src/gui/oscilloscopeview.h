@@ -12,15 +12,23 @@
 #define OSCILLOSCOPEVIEW_H
 
 #include <qframe.h>
+#include <qimage.h>
+
+#include <stdint.h>
 
 class Oscilloscope;
 class Simulator;
 class QMouseEvent;
 class QPaintEvent;
-class QPixmap;
 class QTimer;
 
 /**
+Draws the probe traces into a backing image. While the simulation runs, the
+view only scrolls, so the image is shifted by the number of pixels that the
+view moved and only the columns that have been exposed (or that were drawn
+before their data had been recorded) are drawn again. Everything is redrawn
+after zooming, resizing or changes to the probes.
+
 @author David Saxton
 */
 class OscilloscopeView : public QFrame
@@ -35,6 +43,13 @@ class OscilloscopeView : public QFrame
 		 * Sets the needRedraw flag to true, and then class repaint
 		 */
 		void updateView();
+		/**
+		 * Discards the drawn traces, so that everything is drawn again on
+		 * the next update, and calls updateView. This should be called
+		 * when probes are added or removed, or when how they are drawn
+		 * changes.
+		 */
+		void redrawView();
 		void slotSetFrameRate( QAction * );
 		
 	protected slots:
@@ -47,13 +62,42 @@ class OscilloscopeView : public QFrame
 		virtual void paintEvent( QPaintEvent *event);
 		virtual void resizeEvent( QResizeEvent *event);
 		
-		void drawLogicData( QPainter & p);
-		void drawFloatingData( QPainter & p);
+		/**
+		 * Brings m_image up to date with the current scroll position.
+		 */
+		void updateImage();
+		/**
+		 * Draws the grid and the traces in the columns [fromX, toX) of
+		 * m_image.
+		 */
+		void drawColumns( QPainter & p, int fromX, int toX);
+		void drawGrid( QPainter & p);
+		void drawLogicData( QPainter & p, int fromX);
+		void drawFloatingData( QPainter & p, int fromX);
+		/**
+		 * @return the x coordinate of the given simulator time.
+		 */
+		int timeToX( int64_t time) const;
+		/**
+		 * @return the simulator time at the given x coordinate.
+		 */
+		int64_t xToTime( int x) const;
+		/**
+		 * @return the x coordinate up to which all probes have recorded data.
+		 */
+		int recordedX() const;
 		void updateOutputHeight();
 		void updateTimeLabel();
 		
 		bool b_needRedraw;
-		QPixmap *m_pixmap;
+		bool b_needFullRedraw;
+		QImage m_image;
+		/// Number of pixels that the view is scrolled along
+		int64_t m_pixelsOffset;
+		/// pixelsPerSecond of the oscilloscope when m_image was drawn
+		double m_pixelsPerSecond;
+		/// Columns of m_image before this will not change with more data
+		int m_validWidth;
 		QTimer *m_updateViewTmr;
 		int m_fps;
 		int m_sliderValueAtClick;
@@ -90,7 +90,7 @@ void ProbePositioner::setProbePosition( ProbeData *probeData, int position )
 	probeData->setDrawPosition( float(position - probeArrowHeight/2)/float(spacing) - probeNum );
 	
 	forceRepaint();
-	Oscilloscope::self()->oscilloscopeView->updateView();
+	Oscilloscope::self()->oscilloscopeView->redrawView();
 }
 
 
@@ -117,9 +117,9 @@ void ProbePositioner::slotProbeDataRegistered( int id, ProbeData *probe )
 	m_probeDataMap[id] = probe;
 	connect( probe, SIGNAL(displayAttributeChanged()), this, SLOT(forceRepaint()) );
 	// This connect doesn't really belong here, but it save a lot of code
-	connect( probe, SIGNAL(displayAttributeChanged()), Oscilloscope::self()->oscilloscopeView, SLOT(updateView()) );
+	connect( probe, SIGNAL(displayAttributeChanged()), Oscilloscope::self()->oscilloscopeView, SLOT(redrawView()) );
 	forceRepaint();
-	Oscilloscope::self()->oscilloscopeView->updateView();
+	Oscilloscope::self()->oscilloscopeView->redrawView();
 }
 
 
@@ -0,0 +1,232 @@
+/***************************************************************************
+ *   Copyright (C) 2026 by the KTechLab developers                         *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ ***************************************************************************/
+
+#include "katemdi.h"
+#include "simulationprofiler.h"
+#include "simulationprofilerwidget.h"
+
+#include <kdebug.h>
+#include <kfiledialog.h>
+#include <klocalizedstring.h>
+#include <kmessagebox.h>
+
+#include <qcheckbox.h>
+#include <qheaderview.h>
+#include <qlabel.h>
+#include <qlayout.h>
+#include <qpushbutton.h>
+#include <qtimer.h>
+#include <qtreewidget.h>
+
+#include <cassert>
+
+static const int NAME_COLUMN = 0;
+static const int CALLS_COLUMN = 1;
+static const int TIME_COLUMN = 2;
+static const int AVERAGE_COLUMN = 3;
+
+static const int REFRESH_INTERVAL_MS = 1000;
+
+
+static QString formatNanoseconds( double ns )
+{
+	if ( ns >= 1e9 )
+		return i18n("%1 s", QString::number( ns / 1e9, 'f', 3 ));
+	if ( ns >= 1e6 )
+		return i18n("%1 ms", QString::number( ns / 1e6, 'f', 3 ));
+	if ( ns >= 1e3 )
+		return i18n("%1 us", QString::number( ns / 1e3, 'f', 3 ));
+	return i18n("%1 ns", QString::number( ns, 'f', 0 ));
+}
+
+
+static void setCounterColumns( QTreeWidgetItem * item, const ProfileCounter & counter )
+{
+	item->setText( CALLS_COLUMN, QString::number( counter.calls ) );
+	item->setText( TIME_COLUMN, formatNanoseconds( counter.nanoseconds ) );
+	if ( counter.calls )
+		item->setText( AVERAGE_COLUMN, formatNanoseconds( double(counter.nanoseconds) / counter.calls ) );
+}
+
+
+SimulationProfilerWidget * SimulationProfilerWidget::m_pSelf = 0l;
+SimulationProfilerWidget * SimulationProfilerWidget::self( KateMDI::ToolView * parent )
+{
+	if (!m_pSelf)
+	{
+		assert(parent);
+		m_pSelf = new SimulationProfilerWidget(parent);
+	}
+	return m_pSelf;
+}
+
+
+SimulationProfilerWidget::SimulationProfilerWidget( KateMDI::ToolView * parent )
+	: QWidget( (QWidget*)parent )
+{
+	if (parent->layout()) {
+		parent->layout()->addWidget(this);
+	} else {
+		kWarning() << k_funcinfo << "unexpected null layout on parent " << parent;
+	}
+
+	QGridLayout * grid = new QGridLayout( this );
+	grid->setMargin(0);
+	grid->setSpacing(6);
+
+	m_pEnabledCheck = new QCheckBox( i18n("Enable profiling"), this );
+	m_pEnabledCheck->setChecked( SimulationProfiler::isEnabled() );
+	grid->addWidget( m_pEnabledCheck, 0, 0 );
+
+	m_pSpeedLabel = new QLabel( this );
+	grid->addWidget( m_pSpeedLabel, 0, 1 );
+	grid->setColumnStretch( 1, 1 );
+
+	m_pResetButton = new QPushButton( i18n("Reset"), this );
+	grid->addWidget( m_pResetButton, 0, 2 );
+
+	m_pSaveButton = new QPushButton( i18n("Save..."), this );
+	grid->addWidget( m_pSaveButton, 0, 3 );
+
+	m_pTree = new QTreeWidget( this );
+	m_pTree->setColumnCount(4);
+	QStringList headers;
+	headers << i18n("Name") << i18n("Calls") << i18n("Total Time") << i18n("Average");
+	m_pTree->setHeaderLabels( headers );
+	m_pTree->setFocusPolicy( Qt::NoFocus );
+	m_pTree->setRootIsDecorated( true );
+	m_pTree->header()->setResizeMode( NAME_COLUMN, QHeaderView::Stretch );
+	grid->addWidget( m_pTree, 1, 0, 1, 4 );
+
+	m_pRefreshTimer = new QTimer( this );
+
+	connect( m_pEnabledCheck, SIGNAL(toggled(bool)), this, SLOT(setProfilingEnabled(bool)) );
+	connect( m_pResetButton, SIGNAL(clicked()), this, SLOT(resetProfile()) );
+	connect( m_pSaveButton, SIGNAL(clicked()), this, SLOT(saveProfile()) );
+	connect( m_pRefreshTimer, SIGNAL(timeout()), this, SLOT(refresh()) );
+
+	refresh();
+}
+
+
+SimulationProfilerWidget::~SimulationProfilerWidget()
+{
+}
+
+
+void SimulationProfilerWidget::setProfilingEnabled( bool enabled )
+{
+	SimulationProfiler::self()->setEnabled( enabled );
+
+	// Only poll the profiler while there is something new to show
+	if ( enabled )
+		m_pRefreshTimer->start( REFRESH_INTERVAL_MS );
+	else
+		m_pRefreshTimer->stop();
+
+	refresh();
+}
+
+
+void SimulationProfilerWidget::resetProfile()
+{
+	SimulationProfiler::self()->reset();
+	refresh();
+}
+
+
+void SimulationProfilerWidget::saveProfile()
+{
+	KUrl url = KFileDialog::getSaveUrl( KUrl(), "*.xml|" + i18n("Simulation Profile (*.xml)"), this, i18n("Save Simulation Profile") );
+	if ( url.isEmpty() )
+		return;
+
+	if ( !SimulationProfiler::self()->saveToFile( url.path() ) )
+		KMessageBox::sorry( this, i18n("Could not write the simulation profile to \"%1\".", url.path()) );
+}
+
+
+QTreeWidgetItem * SimulationProfilerWidget::addTopLevel( const QString & name, const QString & value )
+{
+	QTreeWidgetItem * item = new QTreeWidgetItem( m_pTree );
+	item->setText( NAME_COLUMN, name );
+	if ( !value.isEmpty() )
+		item->setText( CALLS_COLUMN, value );
+	return item;
+}
+
+
+void SimulationProfilerWidget::refresh()
+{
+	const SimulationProfiler * profiler = SimulationProfiler::self();
+
+	m_pSpeedLabel->setText( i18n("Speed: %1% of real time, load: %2%",
+								 QString::number( profiler->achievedSpeed() * 100.0, 'f', 1 ),
+								 QString::number( profiler->load() * 100.0, 'f', 1 ) ) );
+
+	// Remember which groups were expanded, as the tree is rebuilt from scratch
+	QList<bool> expanded;
+	for ( int i = 0; i < m_pTree->topLevelItemCount(); ++i )
+		expanded << m_pTree->topLevelItem(i)->isExpanded();
+
+	m_pTree->clear();
+
+	QTreeWidgetItem * sections = addTopLevel( i18n("Simulator Sections") );
+	for ( int i = 0; i < SimulationProfiler::SectionCount; ++i )
+	{
+		SimulationProfiler::Section section = SimulationProfiler::Section(i);
+		QTreeWidgetItem * item = new QTreeWidgetItem( sections );
+		item->setText( NAME_COLUMN, SimulationProfiler::sectionName( section ) );
+		setCounterColumns( item, profiler->section( section ) );
+	}
+
+	QTreeWidgetItem * components = addTopLevel( i18n("Component Types") );
+	const QHash< QString, ProfileCounter > componentTypes = profiler->componentTypes();
+	QHash< QString, ProfileCounter >::const_iterator typesEnd = componentTypes.end();
+	for ( QHash< QString, ProfileCounter >::const_iterator it = componentTypes.begin(); it != typesEnd; ++it )
+	{
+		QTreeWidgetItem * item = new QTreeWidgetItem( components );
+		item->setText( NAME_COLUMN, it.key() );
+		setCounterColumns( item, it.value() );
+	}
+
+	QTreeWidgetItem * circuits = addTopLevel( i18n("Circuits") );
+	const QHash< const Circuit *, CircuitProfile > circuitProfiles = profiler->circuits();
+	QHash< const Circuit *, CircuitProfile >::const_iterator circuitsEnd = circuitProfiles.end();
+	for ( QHash< const Circuit *, CircuitProfile >::const_iterator it = circuitProfiles.begin(); it != circuitsEnd; ++it )
+	{
+		QTreeWidgetItem * item = new QTreeWidgetItem( circuits );
+		item->setText( NAME_COLUMN, i18n("%1 nodes, %2 branches", it.value().nodeCount, it.value().branchCount) );
+		setCounterColumns( item, it.value() );
+	}
+
+	QTreeWidgetItem * newton = addTopLevel( i18n("Newton-Raphson Iterations") );
+	const QVector<quint64> iterations = profiler->newtonIterations();
+	for ( int i = 0; i < iterations.size(); ++i )
+	{
+		if ( !iterations[i] )
+			continue;
+
+		QTreeWidgetItem * item = new QTreeWidgetItem( newton );
+		if ( i == SimulationProfiler::NewtonIterationBuckets - 1 )
+			item->setText( NAME_COLUMN, i18n("%1 or more", i) );
+		else
+			item->setText( NAME_COLUMN, QString::number(i) );
+		item->setText( CALLS_COLUMN, QString::number( iterations[i] ) );
+	}
+
+	addTopLevel( i18n("LU Decompositions"), QString::number( profiler->luDecompositions() ) );
+
+	quint64 lookups = profiler->logicCacheHits() + profiler->logicCacheMisses();
+	QString hitRate = lookups ? QString("%1%").arg( 100.0 * profiler->logicCacheHits() / lookups, 0, 'f', 1 ) : QString("-");
+	addTopLevel( i18n("Logic Cache Hit Rate"), hitRate );
+
+	for ( int i = 0; i < expanded.size() && i < m_pTree->topLevelItemCount(); ++i )
+		m_pTree->topLevelItem(i)->setExpanded( expanded[i] );
+}
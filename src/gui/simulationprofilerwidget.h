@@ -0,0 +1,63 @@
+/***************************************************************************
+ *   Copyright (C) 2026 by the KTechLab developers                         *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ ***************************************************************************/
+
+#ifndef SIMULATIONPROFILERWIDGET_H
+#define SIMULATIONPROFILERWIDGET_H
+
+#include <qwidget.h>
+
+class QCheckBox;
+class QLabel;
+class QPushButton;
+class QTimer;
+class QTreeWidget;
+class QTreeWidgetItem;
+namespace KateMDI { class ToolView; }
+
+/**
+Tool view showing the data recorded by the SimulationProfiler: time per
+simulator section, component type and circuit, the Newton-Raphson iteration
+histogram, matrix and logic cache statistics, and the achieved simulation
+speed. Profiling is only enabled while the checkbox in this view is ticked.
+*/
+class SimulationProfilerWidget : public QWidget
+{
+	Q_OBJECT
+	public:
+		static SimulationProfilerWidget * self( KateMDI::ToolView * parent = 0l );
+		static QString toolViewIdentifier() { return "SimulationProfiler"; }
+		~SimulationProfilerWidget();
+
+	public slots:
+		/**
+		 * Rebuilds the tree from the current profiler data.
+		 */
+		void refresh();
+
+	protected slots:
+		void setProfilingEnabled( bool enabled );
+		void resetProfile();
+		void saveProfile();
+
+	protected:
+		QTreeWidgetItem * addTopLevel( const QString & name, const QString & value = QString::null );
+
+		QCheckBox * m_pEnabledCheck;
+		QPushButton * m_pResetButton;
+		QPushButton * m_pSaveButton;
+		QLabel * m_pSpeedLabel;
+		QTreeWidget * m_pTree;
+		QTimer * m_pRefreshTimer;
+
+	private:
+		SimulationProfilerWidget( KateMDI::ToolView * parent );
+		static SimulationProfilerWidget * m_pSelf;
+};
+
+#endif
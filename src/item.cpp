@@ -113,7 +113,12 @@ void Item::setChanged()
 	if (b_deleted)
 		return;
 	
-	if (canvas())
+	if (!canvas())
+		return;
+	
+	if (isDynamic())
+		canvas()->setDynamicChanged(boundingRect());
+	else
 		canvas()->setChanged(boundingRect());
 }
 
@@ -196,7 +201,7 @@ ItemData Item::itemData() const
 			case Variant::Type::Int:
 			case Variant::Type::Double:
 			{
-				itemData.dataNumber[it.key()] = it.value()->value().toDouble();
+				itemData.dataNumber[it.key()] = it.value()->toDouble();
 				break;
 			}
 			case Variant::Type::Color:
@@ -206,7 +211,7 @@ ItemData Item::itemData() const
 			}
 			case Variant::Type::Bool:
 			{
-				itemData.dataBool[it.key()] = it.value()->value().toBool();
+				itemData.dataBool[it.key()] = it.value()->toBool();
 				break;
 			}
 			case Variant::Type::Raw:
@@ -249,36 +254,36 @@ void Item::restoreFromItemData( const ItemData &itemData )
 	const QStringMap::const_iterator stringEnd = itemData.dataString.end();
 	for ( QStringMap::const_iterator it = itemData.dataString.begin(); it != stringEnd; ++it )
 	{
-		if ( hasProperty(it.key()) )
-			property( it.key() )->setValue( it.value() );
+		if ( Property * p = m_variantData.value( it.key() ) )
+			p->setValue( it.value() );
 	}
 	
 	const DoubleMap::const_iterator numberEnd = itemData.dataNumber.end();
 	for ( DoubleMap::const_iterator it = itemData.dataNumber.begin(); it != numberEnd; ++it )
 	{
-		if ( hasProperty(it.key()) )
-			property( it.key() )->setValue( it.value() );
+		if ( Property * p = m_variantData.value( it.key() ) )
+			p->setValue( it.value() );
 	}
 	
 	const QColorMap::const_iterator colorEnd = itemData.dataColor.end();
 	for ( QColorMap::const_iterator it = itemData.dataColor.begin(); it != colorEnd; ++it )
 	{
-		if ( hasProperty(it.key()) )
-			property( it.key() )->setValue( it.value() );
+		if ( Property * p = m_variantData.value( it.key() ) )
+			p->setValue( it.value() );
 	}
 	
 	const BoolMap::const_iterator boolEnd = itemData.dataBool.end();
 	for ( BoolMap::const_iterator it = itemData.dataBool.begin(); it != boolEnd; ++it )
 	{
-		if ( hasProperty(it.key()) )
-			property( it.key() )->setValue( QVariant( it.value() /*, 0*/ ) );
+		if ( Property * p = m_variantData.value( it.key() ) )
+			p->setValue( QVariant( it.value() /*, 0*/ ) );
 	}
 	
 	const QBitArrayMap::const_iterator rawEnd = itemData.dataRaw.end();
 	for ( QBitArrayMap::const_iterator it = itemData.dataRaw.begin(); it != rawEnd; ++it )
 	{
-		if ( hasProperty(it.key()) )
-			property( it.key() )->setValue( it.value() );
+		if ( Property * p = m_variantData.value( it.key() ) )
+			p->setValue( it.value() );
 	}
 	//END Restore Data
 }
@@ -578,21 +583,21 @@ double Item::getMultiplier( const QString &_mag )
 double Item::dataDouble( const QString & id ) const
 {
 	Variant * variant = property(id);
-	return variant ? variant->value().toDouble() : 0.0;
+	return variant ? variant->toDouble() : 0.0;
 }
 
 
 int Item::dataInt( const QString & id ) const
 {
 	Variant * variant = property(id);
-	return variant ? variant->value().toInt() : 0;
+	return variant ? variant->toInt() : 0;
 }
 
 
 bool Item::dataBool( const QString & id ) const
 {
 	Variant * variant = property(id);
-	return variant ? variant->value().toBool() : false;
+	return variant ? variant->toBool() : false;
 }
 
 
@@ -624,11 +629,10 @@ Variant * Item::createProperty( const QString & id, Variant::Type::Value type )
 
 Variant * Item::property( const QString & id ) const
 {
-	if ( m_variantData.contains(id) )
-		return m_variantData[id];
-	
-	kError() << k_funcinfo << " No such property with id " << id << endl;
-	return 0l;
+	Variant * variant = m_variantData.value(id);
+	if (!variant)
+		kError() << k_funcinfo << " No such property with id " << id << endl;
+	return variant;
 }
 
 
@@ -650,6 +654,14 @@ void Item::propertyChangedInitial()
 	if ( !m_bDoneCreation )
 		return;
 	
+	if ( p_itemDocument && p_itemDocument->isEditingProperties() )
+	{
+		// dataChanged will be called when the transaction ends
+		m_pPropertyChangedTimer->stop();
+		p_itemDocument->addPropertyChangedItem(this);
+		return;
+	}
+	
     m_pPropertyChangedTimer->setSingleShot(true);
 	m_pPropertyChangedTimer->start( 0 /*, true */ );
 }
@@ -59,6 +59,13 @@ public:
 	QString dataString( const QString & id ) const;
 	QColor dataColor( const QString & id ) const;
 	
+	/**
+	 * Creates the property with the given id, if it does not already exist.
+	 * The returned Property stays valid for the lifetime of the item, so it
+	 * can be kept as a handle to the property; reading it with e.g.
+	 * Variant::toDouble avoids looking up the id and converting the value
+	 * each time, as dataDouble and friends do.
+	 */
 	virtual Property * createProperty( const QString & id, Variant::Type::Value type );
 	Property * property( const QString & id ) const;
 	bool hasProperty( const QString & id ) const;
@@ -78,7 +85,9 @@ public:
 	 * continously changes what is being displayed (such as a seven segment
 	 * display or a lamp), then set m_bDynamicContent to be true in the
 	 * constructor or reinherit this to return true when the contents of the
-	 * item have changed since this function was last called.
+	 * item have changed since this function was last called. Such items
+	 * should also call setDynamic(true), so that they are drawn over the
+	 * canvas' cached static layer instead of being part of it.
 	 */
 	virtual bool contentChanged() const { return m_bDynamicContent; }
 	/**
@@ -292,6 +301,7 @@ protected:
 	QTimer * m_pPropertyChangedTimer; ///< Single show timer for one a property changes
 	
 	friend class ItemLibrary;
+	friend class ItemDocument; // For calling dataChanged after a property edit transaction
 	
 	int m_baseZ;
 	bool m_bIsRaised;
@@ -69,6 +69,9 @@ ItemDocument::ItemDocument( const QString &caption, const char *name)
 	m_savedState = 0;
 	m_currentState = 0;
 	m_bIsLoading = false;
+	m_propertyEditDepth = 0;
+	m_bStateSavePending = false;
+	m_pendingStateSaveActionTicket = -1;
 	
 	m_canvas = new Canvas( this, "canvas" );
 	m_canvasTip = new CanvasTip(this,m_canvas);
@@ -310,6 +313,14 @@ void ItemDocument::requestStateSave( int actionTicket )
 {
 	if ( m_bIsLoading ) return;
 	
+	if ( isEditingProperties() )
+	{
+		// Saved once the transaction ends, with the ticket of the last request
+		m_bStateSavePending = true;
+		m_pendingStateSaveActionTicket = actionTicket;
+		return;
+	}
+	
 	cleanClearStack( m_redoStack );
 
 	if ( (actionTicket >= 0) && (actionTicket == m_currentActionTicket) )
@@ -708,6 +719,51 @@ void ItemDocument::requestCanvasResize()
 }
 
 
+void ItemDocument::beginPropertyEdit()
+{
+	m_propertyEditDepth++;
+}
+
+
+void ItemDocument::endPropertyEdit()
+{
+	if ( m_propertyEditDepth <= 0 )
+	{
+		kWarning() << k_funcinfo << "endPropertyEdit called without beginPropertyEdit" << endl;
+		return;
+	}
+	
+	if ( --m_propertyEditDepth > 0 )
+		return;
+	
+	// Copy it, as an item may change the properties of other items
+	const ItemList changedItems = m_propertyChangedItems;
+	m_propertyChangedItems.clear();
+	
+	const ItemList::const_iterator end = changedItems.end();
+	for ( ItemList::const_iterator it = changedItems.begin(); it != end; ++it )
+	{
+		if ( *it )
+			(*it)->dataChanged();
+	}
+	
+	propertyEditCommitted();
+	
+	if ( m_bStateSavePending )
+	{
+		m_bStateSavePending = false;
+		requestStateSave( m_pendingStateSaveActionTicket );
+	}
+}
+
+
+void ItemDocument::addPropertyChangedItem( Item * item )
+{
+	if ( item && !m_propertyChangedItems.contains(item) )
+		m_propertyChangedItems << item;
+}
+
+
 void ItemDocument::requestEvent( ItemDocumentEvent::type type )
 {
 	m_queuedEvents |= type;
@@ -214,6 +214,29 @@ class ItemDocument : public Document
 		 * @see getActionTicket
 		 */
 		void requestStateSave( int actionTicket = -1 );
+		/**
+		 * Starts a property edit transaction. Until the matching
+		 * endPropertyEdit, the dataChanged of items whose properties are
+		 * changed and any requested state saves are deferred, so that setting
+		 * a property on many selected items updates each item and saves the
+		 * document state only once. Transactions can be nested.
+		 */
+		void beginPropertyEdit();
+		/**
+		 * Ends a property edit transaction. Ending the outermost transaction
+		 * calls dataChanged on the changed items, then propertyEditCommitted,
+		 * and then does the deferred state save (if any).
+		 */
+		void endPropertyEdit();
+		/**
+		 * @return whether a property edit transaction is in progress.
+		 */
+		bool isEditingProperties() const { return m_propertyEditDepth > 0; }
+		/**
+		 * Called by Item when one of its properties has changed during a
+		 * property edit transaction.
+		 */
+		void addPropertyChangedItem( Item * item );
 
 		/**
 		 * Clears the undo / redo history
@@ -369,6 +392,12 @@ public slots:
 		 * request must be made with requestEvent.
 		 */
 		void resizeCanvasToItems();
+		/**
+		 * Called at the end of a property edit transaction, after the changed
+		 * items have been updated and before the state is saved. Reinherit
+		 * this to do work that was deferred during the transaction.
+		 */
+		virtual void propertyEditCommitted() {};
 	
 		Canvas		*m_canvas;
 
@@ -395,6 +424,11 @@ private:
 	int		  m_currentActionTicket;
 	bool		  m_bIsLoading;
 
+	int		  m_propertyEditDepth;
+	ItemList	  m_propertyChangedItems; // Items to call dataChanged on when the property edit ends
+	bool		  m_bStateSavePending;
+	int		  m_pendingStateSaveActionTicket;
+
 	ItemDocumentData *m_currentState;
 	ItemDocumentData *m_savedState; // Pointer to the document data that holds the state when it saved
 
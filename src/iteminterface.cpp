@@ -507,6 +507,29 @@ struct BoolLock {
     }
 };
 
+/**
+Groups the property changes made while in scope into one property edit
+transaction of the document.
+*/
+class PropertyEditTransaction
+{
+	public:
+		PropertyEditTransaction( ItemDocument * document )
+			: m_pDocument(document)
+		{
+			if (m_pDocument)
+				m_pDocument->beginPropertyEdit();
+		}
+		~PropertyEditTransaction()
+		{
+			if (m_pDocument)
+				m_pDocument->endPropertyEdit();
+		}
+	
+	private:
+		QPointer<ItemDocument> m_pDocument;
+};
+
 void ItemInterface::tbDataChanged()
 {
     qDebug() << Q_FUNC_INFO << "begin";
@@ -515,6 +538,8 @@ void ItemInterface::tbDataChanged()
         return;
     }
     BoolLock inTbChangedLock(&m_isInTbDataChanged);
+	// All of the widgets are applied in one go
+	PropertyEditTransaction transaction(p_cvb);
 	// Manual string values
 	const LineEditMap::iterator m_stringLineEditMapEnd = m_stringLineEditMap.end();
 	for ( LineEditMap::iterator leit = m_stringLineEditMap.begin(); leit != m_stringLineEditMapEnd; ++leit )
@@ -595,6 +620,9 @@ void ItemInterface::slotSetData( const QString &id, QVariant value )
 	}
 	qDebug() << Q_FUNC_INFO << "id=" << id << " value=" << value;
 	
+	// Update each item (and save the state) once, after every item has the new value
+	PropertyEditTransaction transaction(p_cvb);
+	
 	const ItemList itemList = p_itemGroup->items(true);
 	const ItemList::const_iterator end = itemList.end();
 	for ( ItemList::const_iterator it = itemList.begin(); it != end; ++it )
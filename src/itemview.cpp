@@ -204,6 +204,16 @@ QPoint ItemView::mousePosToCanvasPos( const QPoint & contentsClick ) const
 }
 
 
+QRect ItemView::visibleCanvasRect() const
+{
+	if ( !isVisible() )
+		return QRect();
+	
+	return QRect( mousePosToCanvasPos( QPoint( 0, 0 ) ),
+				  mousePosToCanvasPos( QPoint( m_CVBEditor->visibleWidth(), m_CVBEditor->visibleHeight() ) ) );
+}
+
+
 void ItemView::zoomIn( const QPoint & center )
 {
 	// NOTE The code in this function is nearly the same as that in zoomOut.
@@ -58,6 +58,11 @@ class ItemView : public View
 		 * associated position on the canvas.
 		 */
 		QPoint mousePosToCanvasPos( const QPoint & contentsClick ) const;
+		/**
+		 * @return the part of the canvas that is currently visible in the
+		 * view, or a null rect if the view is hidden.
+		 */
+		QRect visibleCanvasRect() const;
 
 	public slots:
 		void actualSize();
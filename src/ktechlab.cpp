@@ -33,6 +33,7 @@
 #include "recentfilesaction.h"
 #include "scopescreen.h"
 #include "settingsdlg.h"
+#include "simulationprofilerwidget.h"
 #include "subcircuits.h"
 #include "symbolviewer.h"
 #include "textdocument.h"
@@ -279,6 +280,13 @@ void KTechlab::setupToolDocks()
     tv->setObjectName("ScopeScreen-ToolView");
 	ScopeScreen::self( tv );
 #endif
+	
+	tv = createToolView( SimulationProfilerWidget::toolViewIdentifier(),
+						 KMultiTabBar::Bottom,
+						 loader->loadIcon( "office-chart-bar", KIconLoader::Small ),
+						 i18n("Simulation Profiler") );
+    tv->setObjectName("SimulationProfiler-ToolView");
+	SimulationProfilerWidget::self( tv );
 
 	updateSidebarMinimumSizes();
 }
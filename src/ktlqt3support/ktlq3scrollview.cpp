@@ -1741,12 +1741,24 @@ void KtlQ3ScrollView::viewportPaintEvent(QPaintEvent* pe)
                 ex, ey, ew, eh);
         }
     } else {
-        r &= d->viewport->rect();
-        int ex = r.x() + d->contentsX();
-        int ey = r.y() + d->contentsY();
-        int ew = r.width();
-        int eh = r.height();
-        drawContentsOffset(&p, d->contentsX(), d->contentsY(), ex, ey, ew, eh);
+        // Draw each rectangle of the damaged region on its own, so that small
+        // changes far apart don't repaint everything in between. Fall back to
+        // the bounding rectangle for very fragmented regions.
+        QVector<QRect> rects = pe->region().rects();
+        if (rects.size() > 16) {
+            rects.clear();
+            rects.append(r);
+        }
+        for (int i = 0; i < rects.size(); ++i) {
+            QRect rr = rects[i] & d->viewport->rect();
+            if (rr.isEmpty())
+                continue;
+            int ex = rr.x() + d->contentsX();
+            int ey = rr.y() + d->contentsY();
+            int ew = rr.width();
+            int eh = rr.height();
+            drawContentsOffset(&p, d->contentsX(), d->contentsY(), ex, ey, ew, eh);
+        }
     }
 }
 
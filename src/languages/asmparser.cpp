@@ -14,10 +14,89 @@
 
 #include <kdebug.h>
 
+#include <qcryptographichash.h>
 #include <qfile.h>
-#include <qregexp.h>
+#include <qhash.h>
+#include <qset.h>
 #include <qstringlist.h>
 
+/**
+The results of parsing a file, as cached by AsmParser.
+*/
+class AsmParserCacheEntry
+{
+	public:
+		QByteArray contentHash;
+		QString picID;
+		bool containsRadix;
+		AsmParser::Type type;
+};
+
+typedef QHash< QString, AsmParserCacheEntry > AsmParserCache;
+
+static AsmParserCache & asmParserCache()
+{
+	static AsmParserCache cache;
+	return cache;
+}
+
+
+/**
+ * Directives that are only found in relocatable code.
+ */
+static const QSet<QString> & nonAbsoluteOps()
+{
+	static QSet<QString> ops;
+	if ( ops.isEmpty() )
+	{
+		ops = QString( "code,.def,.dim,.direct,endw,extern,.file,global,idata,"
+				".ident,.line,.type,udata,udata_acs,udata_ovr,udata_shr" ).split(",").toSet();
+	}
+	return ops;
+}
+
+
+/**
+ * Matches "list", whitespace, "p", optional whitespace, "=" and optional
+ * whitespace (the keywords case insensitively) at the given position.
+ * @return the position after the match, or -1 if there is no match
+ */
+static int matchListP( const QString & line, int pos )
+{
+	const int length = line.length();
+	const QChar * data = line.unicode();
+	
+	static const char list[] = "list";
+	for ( int i = 0; i < 4; ++i, ++pos )
+	{
+		if ( pos >= length || data[pos].toLower() != QChar(list[i]) )
+			return -1;
+	}
+	
+	int start = pos;
+	while ( pos < length && data[pos].isSpace() )
+		++pos;
+	if ( pos == start )
+		return -1;
+	
+	if ( pos >= length || data[pos].toLower() != QChar('p') )
+		return -1;
+	++pos;
+	
+	while ( pos < length && data[pos].isSpace() )
+		++pos;
+	
+	if ( pos >= length || data[pos] != QChar('=') )
+		return -1;
+	++pos;
+	
+	while ( pos < length && data[pos].isSpace() )
+		++pos;
+	
+	return pos;
+}
+
+
 AsmParser::AsmParser( const QString &url )
 	: m_url(url)
 {
@@ -37,111 +116,183 @@ bool AsmParser::parse( GpsimDebugger * debugger )
 	if ( !file.open(QIODevice::ReadOnly) )
 		return false;
 	
-	QTextStream stream( &file );
+	const QByteArray data = file.readAll();
+	file.close();
 	
-	m_type = Absolute;
-	m_bContainsRadix = false;
-	m_picID = QString::null;
+	const QByteArray contentHash = QCryptographicHash::hash( data, QCryptographicHash::Md5 );
+	
+	AsmParserCache::const_iterator cached = asmParserCache().constFind( m_url );
+	bool useCache = (cached != asmParserCache().constEnd()) && (cached.value().contentHash == contentHash);
 	
-	//QStringList nonAbsoluteOps = QStringList::split( ",",
-	//		"code,.def,.dim,.direct,endw,extern,.file,global,idata,.ident,.line,.type,udata,udata_acs,udata_ovr,udata_shr" );
-    QStringList nonAbsoluteOps = QString(
-        "code,.def,.dim,.direct,endw,extern,.file,global,idata,.ident,.line,.type,udata,udata_acs,udata_ovr,udata_shr")
-        .split(",");
+	if ( useCache )
+	{
+		m_type = cached.value().type;
+		m_bContainsRadix = cached.value().containsRadix;
+		m_picID = cached.value().picID;
+		
+		// Nothing else to read from the file
+		if ( !debugger )
+			return true;
+	}
+	else
+	{
+		m_type = Absolute;
+		m_bContainsRadix = false;
+		m_picID = QString::null;
+	}
+	
+	const QString text = QString::fromLocal8Bit( data );
+	const int length = text.length();
 	
 	unsigned inputAtLine = 0;
-	while ( !stream.atEnd() ) {
-		const QString line = stream.readLine().trimmed();
-		if ( m_type != Relocatable ) {
-			QString col0 = line.section( QRegExp("[; ]"), 0, 0 );
-			col0 = col0.trimmed();
-			if ( nonAbsoluteOps.contains(col0) )
-				m_type = Relocatable;
-		}
+	int lineStart = 0;
+	
+	while ( lineStart < length )
+	{
+		int lineEnd = text.indexOf( '\n', lineStart );
+		if ( lineEnd == -1 )
+			lineEnd = length;
+		
+		const QString line = text.mid( lineStart, lineEnd - lineStart ).trimmed();
+		
+		if ( !useCache )
+			parseLine( line );
+		
+#ifndef NO_GPSIM
+		if ( debugger )
+			parseDebugLine( line, inputAtLine, debugger );
+#endif
+		
+		inputAtLine++;
+		lineStart = lineEnd + 1;
+	}
+	
+	if ( !useCache )
+	{
+		AsmParserCacheEntry entry;
+		entry.contentHash = contentHash;
+		entry.picID = m_picID;
+		entry.containsRadix = m_bContainsRadix;
+		entry.type = m_type;
+		asmParserCache()[ m_url ] = entry;
+	}
+	
+	return true;
+}
 
-		if ( !m_bContainsRadix ) {
-			if ( line.contains( QRegExp("^RADIX[\\s]*") ) || line.contains( QRegExp("^radix[\\s]*") ) )
-				m_bContainsRadix = true;
-		}
 
-		if ( m_picID.isEmpty() ) {
-			// We look for "list p = ", and "list p = picid ", and subtract the positions / lengths away from each other to get the picid text position
-			QRegExp fullRegExp("[lL][iI][sS][tT][\\s]+[pP][\\s]*=[\\s]*[\\d\\w]+");
-			QRegExp halfRegExp("[lL][iI][sS][tT][\\s]+[pP][\\s]*=[\\s]*");
+void AsmParser::parseLine( const QString & line )
+{
+	if ( m_type != Relocatable )
+	{
+		int col0End = 0;
+		const int length = line.length();
+		while ( col0End < length && line[col0End] != ';' && line[col0End] != ' ' )
+			++col0End;
+		
+		if ( nonAbsoluteOps().contains( line.left( col0End ).trimmed() ) )
+			m_type = Relocatable;
+	}
+	
+	if ( !m_bContainsRadix )
+	{
+		if ( line.startsWith("RADIX") || line.startsWith("radix") )
+			m_bContainsRadix = true;
+	}
+	
+	if ( m_picID.isEmpty() )
+	{
+		// We look for the first "list p = ", and take the word following it
+		// (if any) as the PIC ID.
+		const int length = line.length();
+		for ( int start = line.indexOf( "list", 0, Qt::CaseInsensitive ); start != -1; start = line.indexOf( "list", start + 1, Qt::CaseInsensitive ) )
+		{
+			int idStart = matchListP( line, start );
+			if ( idStart == -1 )
+				continue;
+			
+			int idEnd = idStart;
+			while ( idEnd < length && (line[idEnd].isLetterOrNumber() || line[idEnd] == '_') )
+				++idEnd;
 			
-			int startPos = fullRegExp.indexIn(line);
-			if ( (startPos != -1) && (startPos == halfRegExp.indexIn(line)) )
+			if ( idEnd > idStart )
 			{
-				m_picID = line.mid( startPos + halfRegExp.matchedLength(), fullRegExp.matchedLength() - halfRegExp.matchedLength() );
-				m_picID = m_picID.toUpper();
+				m_picID = line.mid( idStart, idEnd - idStart ).toUpper();
 				if ( !m_picID.startsWith("P") )
 					m_picID.prepend("P");
 			}
+			break;
 		}
+	}
+}
+
+
+void AsmParser::parseDebugLine( const QString & line, unsigned inputAtLine, GpsimDebugger * debugger )
+{
 #ifndef NO_GPSIM
-		if ( debugger && line.startsWith(";#CSRC\t") )
-		{
-			// Assembly file produced (by sdcc) from C, line is in format:
-			// ;#CSRC\t[file-name] [file-line]
-			// The filename can contain spaces.
-			int fileLineAt = line.lastIndexOf(" ");
+	if ( line.startsWith(";#CSRC\t") )
+	{
+		// Assembly file produced (by sdcc) from C, line is in format:
+		// ;#CSRC\t[file-name] [file-line]
+		// The filename can contain spaces.
+		int fileLineAt = line.lastIndexOf(" ");
+		
+		if ( fileLineAt == -1 )
+			kWarning() << k_funcinfo << "Syntax error in line \"" << line << "\" while looking for file-line" << endl;
+		else {
+			// 7 = length_of(";#CSRC\t")
+			QString fileName = line.mid( 7, fileLineAt-7 );
+			QString fileLineString = line.mid( fileLineAt+1, line.length() - fileLineAt - 1 );
+				
+			if ( fileName.startsWith("\"") ) {
+				// Newer versions of SDCC insert " around the filename
+				fileName.remove( 0, 1 ); // First "
+				fileName.remove( fileName.length()-1, 1 ); // Last "
+			}
 			
-			if ( fileLineAt == -1 )
-				kWarning() << k_funcinfo << "Syntax error in line \"" << line << "\" while looking for file-line" << endl;
+			bool ok;
+			int fileLine = fileLineString.toInt(&ok) - 1;
+			if ( ok && fileLine >= 0 )
+				debugger->associateLine( fileName, fileLine, m_url, inputAtLine );
+			else	kDebug() << k_funcinfo << "Not a valid line number: \"" << fileLineString << "\"" << endl;
+		}
+	}
+
+	if ( (line.startsWith(".line\t") || line.startsWith(";#MSRC") ) ) {
+		// Assembly file produced by either sdcc or microbe, line is in format:
+		// \t[".line"/"#MSRC"]\t[file-line]; [file-name]\t[c/microbe source code for that line]
+		// We're screwed if the file name contains tabs, but hopefully not many do...
+		//QStringList lineParts = QStringList::split( '\t', line ); // 2018.12.01
+            QStringList lineParts = line.split( '\t' , QString::SkipEmptyParts );
+		if ( lineParts.size() < 2 )
+			kWarning() << k_funcinfo << "Line is in wrong format for extracing source line and file: \""<<line<<"\""<<endl;
+		else {
+			const QString lineAndFile = lineParts[1];
+			int lineFileSplit = lineAndFile.indexOf("; ");
+			if ( lineFileSplit == -1 )
+				kDebug() << k_funcinfo << "Could not find file / line split in \""<<lineAndFile<<"\""<<endl;
 			else {
-				// 7 = length_of(";#CSRC\t")
-				QString fileName = line.mid( 7, fileLineAt-7 );
-				QString fileLineString = line.mid( fileLineAt+1, line.length() - fileLineAt - 1 );
-					
+				QString fileName = lineAndFile.mid( lineFileSplit + 2 );
+				QString fileLineString = lineAndFile.left( lineFileSplit );
+				
 				if ( fileName.startsWith("\"") ) {
 					// Newer versions of SDCC insert " around the filename
 					fileName.remove( 0, 1 ); // First "
 					fileName.remove( fileName.length()-1, 1 ); // Last "
 				}
-				
+			
 				bool ok;
 				int fileLine = fileLineString.toInt(&ok) - 1;
 				if ( ok && fileLine >= 0 )
 					debugger->associateLine( fileName, fileLine, m_url, inputAtLine );
-				else	kDebug() << k_funcinfo << "Not a valid line number: \"" << fileLineString << "\"" << endl;
-			}
-		}
-
-		if ( debugger && (line.startsWith(".line\t") || line.startsWith(";#MSRC") ) ) {
-			// Assembly file produced by either sdcc or microbe, line is in format:
-			// \t[".line"/"#MSRC"]\t[file-line]; [file-name]\t[c/microbe source code for that line]
-			// We're screwed if the file name contains tabs, but hopefully not many do...
-			//QStringList lineParts = QStringList::split( '\t', line ); // 2018.12.01
-            QStringList lineParts = line.split( '\t' , QString::SkipEmptyParts );
-			if ( lineParts.size() < 2 )
-				kWarning() << k_funcinfo << "Line is in wrong format for extracing source line and file: \""<<line<<"\""<<endl;
-			else {
-				const QString lineAndFile = lineParts[1];
-				int lineFileSplit = lineAndFile.indexOf("; ");
-				if ( lineFileSplit == -1 )
-					kDebug() << k_funcinfo << "Could not find file / line split in \""<<lineAndFile<<"\""<<endl;
-				else {
-					QString fileName = lineAndFile.mid( lineFileSplit + 2 );
-					QString fileLineString = lineAndFile.left( lineFileSplit );
-					
-					if ( fileName.startsWith("\"") ) {
-						// Newer versions of SDCC insert " around the filename
-						fileName.remove( 0, 1 ); // First "
-						fileName.remove( fileName.length()-1, 1 ); // Last "
-					}
-				
-					bool ok;
-					int fileLine = fileLineString.toInt(&ok) - 1;
-					if ( ok && fileLine >= 0 )
-						debugger->associateLine( fileName, fileLine, m_url, inputAtLine );
-					else kDebug() << k_funcinfo << "Not a valid line number: \"" << fileLineString << "\"" << endl;
-				}
+				else kDebug() << k_funcinfo << "Not a valid line number: \"" << fileLineString << "\"" << endl;
 			}
 		}
-#endif // !NO_GPSIM
-		inputAtLine++;
 	}
-	
-	return true;
+#else
+	Q_UNUSED(line);
+	Q_UNUSED(inputAtLine);
+	Q_UNUSED(debugger);
+#endif // !NO_GPSIM
 }
 
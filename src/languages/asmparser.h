@@ -19,6 +19,10 @@ class GpsimDebugger;
 Reads in an assembly file, and extracts useful information from it, such as the
 PIC ID
 
+The file is read into memory once and scanned in a single pass without regular
+expressions. The results are cached per file, keyed by a hash of the contents,
+so that unchanged files (such as device headers) are not scanned again.
+
 @author David Saxton
 */
 class AsmParser
@@ -52,6 +56,16 @@ class AsmParser
 		Type type() const { return m_type; }
 		
 	protected:
+		/**
+		 * Looks at one (trimmed) line for the relocatable directives, the
+		 * radix directive and the PIC ID.
+		 */
+		void parseLine( const QString & line );
+		/**
+		 * Passes any source-line markers in the (trimmed) line to the debugger.
+		 */
+		void parseDebugLine( const QString & line, unsigned inputAtLine, GpsimDebugger * debugger );
+		
 		const QString m_url;
 		QString m_picID;
 		bool m_bContainsRadix;
@@ -92,8 +92,10 @@ void FlowCode::setStartPart( FlowPart *startPart )
 
 void FlowCode::addCode( const QString& code )
 {
-	m_code += code;
-	if ( !m_code.endsWith("\n") ) m_code += '\n';
+	if ( code.endsWith('\n') )
+		m_fragments << Fragment( code );
+	else
+		m_fragments << Fragment( code + '\n' );
 }
 
 bool FlowCode::isValidBranch( FlowPart *flowPart )
@@ -113,18 +115,16 @@ void FlowCode::addCodeBranch( FlowPart * flowPart )
 	{
 		const QString labelName = genLabel(flowPart->id());
 		addCode( "goto "+labelName );
-		m_gotos.append(labelName);
+		m_gotos.insert(labelName);
 		return;
 	}
 	else
 	{
-		m_addedParts.append(flowPart);
+		m_addedParts.insert(flowPart);
 		int prevLevel = m_curLevel;
 		m_curLevel = flowPart->level();
 		
-		const QString labelName = genLabel(flowPart->id());
-		addCode(labelName+':');
-		m_labels.append(labelName);
+		m_fragments << Fragment( genLabel(flowPart->id()), true );
 		
 		flowPart->generateMicrobe(this);
 		m_curLevel = prevLevel;
@@ -150,9 +150,8 @@ void FlowCode::removeStopPart( FlowPart *part )
 	//FlowPartList::iterator it = m_stopParts.find(part);  // 2018.12.01
 	//if ( it != m_stopParts.end() ) m_stopParts.remove(it);
 	int foundIndex = m_stopParts.indexOf(part);
-	if ( -1 == foundIndex ) {
-        m_stopParts.removeAll(part);
-    }
+	if ( foundIndex != -1 )
+		m_stopParts.removeAt(foundIndex);
 }
 
 QString FlowCode::generateMicrobe( const ItemList &itemList, MicroSettings *settings )
@@ -205,7 +204,7 @@ QString FlowCode::generateMicrobe( const ItemList &itemList, MicroSettings *sett
 	m_addedParts.clear();
 	m_stopParts.clear();
 	m_gotos.clear();
-	m_labels.clear();
+	m_fragments.clear();
 	m_code = QString::null;
 	
 	// PIC type
@@ -218,10 +217,8 @@ QString FlowCode::generateMicrobe( const ItemList &itemList, MicroSettings *sett
 	{
 		QStringList vars = settings->variableNames();
 		
-		// If "inited" is true at the end, we comment at the insertion point
+		// The comment is only added before the first initialized variable
 		bool inited = false;
-		const QString codeString = "// Initial variable values:\n";
-		addCode(codeString);
 		
 		const QStringList::iterator end = vars.end();
 		for ( QStringList::iterator it = vars.begin(); it != end; ++it )
@@ -229,15 +226,14 @@ QString FlowCode::generateMicrobe( const ItemList &itemList, MicroSettings *sett
 			VariableInfo *info = settings->variableInfo(*it);
 			if ( info /*&& info->initAtStart*/ )
 			{
+				if (!inited)
+					addCode("// Initial variable values:\n");
 				inited = true;
 				addCode(*it+" = "+info->valueAsString());
 			}
 		}
-		if (!inited) {
-			m_code.remove(codeString);
-		} else {
+		if (inited)
 			addCode("\n");
-		}
 	}
 	
 	// Initial pin maps
@@ -322,18 +318,28 @@ QString FlowCode::generateMicrobe( const ItemList &itemList, MicroSettings *sett
 
 void FlowCode::tidyCode()
 {
-	// First, get rid of the unused labels
-	const QStringList::iterator end = m_labels.end();
-	for ( QStringList::iterator it = m_labels.begin(); it != end; ++it )
+	// First, join up the fragments, leaving out the unused labels
+	int codeLength = 0;
+	const QList<Fragment>::const_iterator end = m_fragments.end();
+	for ( QList<Fragment>::const_iterator it = m_fragments.begin(); it != end; ++it )
+		codeLength += (*it).code.length() + 2;
+	
+	m_code.reserve( codeLength );
+	for ( QList<Fragment>::const_iterator it = m_fragments.begin(); it != end; ++it )
 	{
-		if ( !m_gotos.contains(*it) ) m_code.remove(*it+':');
+		if ( !(*it).isLabel )
+			m_code += (*it).code;
+		else if ( m_gotos.contains( (*it).code ) )
+			m_code += (*it).code + ":\n";
 	}
+	m_fragments.clear();
 	
 	
 	// And now on to handling indentation :-)
 
 	if ( !m_code.endsWith("\n") ) m_code.append("\n");
 	QString newCode;
+	newCode.reserve( m_code.length() + m_code.length() / 4 );
 	bool multiLineComment = false; // For "/*"..."*/"
 	bool comment = false; // For "//"
 	bool asmEmbed = false;
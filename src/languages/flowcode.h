@@ -15,6 +15,7 @@
 
 #include <qpointer.h>
 #include <qobject.h>
+#include <qset.h>
 #include <qstring.h>
 #include <qstringlist.h>
 #include <qlist.h>
@@ -89,14 +90,29 @@ public:
 	
 protected:
 	/**
-	 * Performs indenting, removal of unnecessary labels, etc.
+	 * A piece of generated code. Labels are kept in their own fragments, so
+	 * that the unused ones can be left out when the fragments are joined.
+	 */
+	class Fragment
+	{
+		public:
+			Fragment( const QString & code = QString::null, bool isLabel = false )
+				: code(code), isLabel(isLabel) {}
+			
+			QString code; // The label name (without the colon) for labels
+			bool isLabel;
+	};
+	
+	/**
+	 * Joins the fragments into m_code (leaving out unused labels), and then
+	 * performs indenting.
 	 */
 	void tidyCode();
 
-	QStringList m_gotos; // Gotos used
-	QStringList m_labels; // Labels used
+	QSet<QString> m_gotos; // Labels that are jumped to
+	QList<Fragment> m_fragments;
 	FlowPartList m_subroutines;
-	FlowPartList m_addedParts;
+	QSet<FlowPart*> m_addedParts;
 	FlowPartList m_stopParts;
 	FlowPart *p_startPart;
 	QString m_code;
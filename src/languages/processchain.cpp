@@ -31,7 +31,10 @@
 #include <kdebug.h>
 #include <klocalizedstring.h>
 #include <ktemporaryfile.h>
+#include <qdir.h>
 #include <qfile.h>
+#include <qfileinfo.h>
+#include <qthread.h>
 #include <qtimer.h>
 
 #include <ktlconfig.h>
@@ -299,34 +302,162 @@ ProcessListChain::ProcessListChain( ProcessOptionsList pol, const char * name )
 {
     setObjectName( name );
 	m_processOptionsList = pol;
+	m_doneCount = 0;
+	m_bFailed = false;
+	m_bFinished = false;
+	
+	initDependencies();
 	
 	// Start us off...
-	slotProcessChainSuccessful();
+	startReadyJobs();
 }
 
 
-void ProcessListChain::slotProcessChainSuccessful()
+int ProcessListChain::maxJobs()
+{
+	int jobs = KTLConfig::maxParallelBuildJobs();
+	if ( jobs <= 0 )
+		jobs = QThread::idealThreadCount();
+	return (jobs > 0) ? jobs : 1;
+}
+
+
+/**
+ * @return the path in a form that does not depend on how it was spelled, for
+ * matching input files against target files. Symbolic links are resolved
+ * when the file exists already; targets that have not been built yet are
+ * only made absolute and cleaned.
+ */
+static QString normalisedPath( const QString & path )
+{
+	QFileInfo info( path );
+	QString canonical = info.canonicalFilePath();
+	if ( !canonical.isEmpty() )
+		return canonical;
+	
+	// Resolve links in the directory at least, which usually exists
+	QString dir = QFileInfo( info.absolutePath() ).canonicalFilePath();
+	if ( dir.isEmpty() )
+		return QDir::cleanPath( info.absoluteFilePath() );
+	return QDir::cleanPath( dir + '/' + info.fileName() );
+}
+
+
+void ProcessListChain::initDependencies()
 {
-	if ( m_processOptionsList.isEmpty() )
+	const int count = m_processOptionsList.size();
+	
+	m_dependencies.clear();
+	m_jobStates.clear();
+	
+	// ProjectItem::build appends an item only after everything it uses, so
+	// the dependencies of an entry are always found earlier in the list.
+	QMap< QString, int > targetToIndex;
+	
+	for ( int i = 0; i < count; ++i )
 	{
-		emit successful();
+		const ProcessOptions & po = m_processOptionsList[i];
+		
+		QStringList used = po.inputFiles() + po.m_linkLibraries;
+		QList<int> dependencies;
+		
+		QStringList::const_iterator end = used.constEnd();
+		for ( QStringList::const_iterator it = used.constBegin(); it != end; ++it )
+		{
+			QMap< QString, int >::const_iterator dep = targetToIndex.constFind( normalisedPath( *it ) );
+			if ( dep != targetToIndex.constEnd() && !dependencies.contains( dep.value() ) )
+				dependencies << dep.value();
+		}
+		
+		m_dependencies << dependencies;
+		m_jobStates << Waiting;
+		
+		if ( !po.targetFile().isEmpty() )
+			targetToIndex[ normalisedPath( po.targetFile() ) ] = i;
+	}
+}
+
+
+void ProcessListChain::startReadyJobs()
+{
+	if ( m_bFinished )
 		return;
+	
+	const int count = m_processOptionsList.size();
+	const int max = maxJobs();
+	
+	for ( int i = 0; !m_bFailed && i < count && m_runningJobs.size() < max; ++i )
+	{
+		if ( m_jobStates[i] != Waiting )
+			continue;
+		
+		bool ready = true;
+		QList<int>::const_iterator end = m_dependencies[i].constEnd();
+		for ( QList<int>::const_iterator it = m_dependencies[i].constBegin(); ready && it != end; ++it )
+			ready = (m_jobStates[*it] == Done);
+		
+		if ( !ready )
+			continue;
+		
+		m_jobStates[i] = Running;
+		
+		ProcessChain * pc = LanguageManager::self()->compile( m_processOptionsList[i] );
+		m_runningJobs[pc] = i;
+		
+		connect( pc, SIGNAL(successful()), this, SLOT(slotProcessChainSuccessful()) );
+		connect( pc, SIGNAL(failed()), this, SLOT(slotProcessChainFailed()) );
 	}
 	
-	ProcessOptionsList::iterator it = m_processOptionsList.begin();
-	ProcessOptions po = *it;
-	m_processOptionsList.erase(it);
+	if ( !m_runningJobs.isEmpty() )
+		return;
+	
+	// Nothing is running any more, so either everything has been built, or
+	// a failure stopped us from starting anything new.
+	m_bFinished = true;
 	
-	ProcessChain * pc = LanguageManager::self()->compile(po);
+	if ( m_bFailed || m_doneCount < count )
+		emit failed();
+	else
+		emit successful();
 	
-	connect( pc, SIGNAL(successful()), this, SLOT(slotProcessChainSuccessful()) );
-	connect( pc, SIGNAL(failed()), this, SLOT(slotProcessChainFailed()) );
+	deleteLater();
+}
+
+
+void ProcessListChain::jobFinished( bool successful )
+{
+	ProcessChain * pc = static_cast<ProcessChain*>( sender() );
+	
+	QMap< ProcessChain*, int >::iterator it = m_runningJobs.find( pc );
+	if ( it == m_runningJobs.end() )
+		return;
+	
+	int index = it.value();
+	m_runningJobs.erase( it );
+	pc->disconnect( this );
+	pc->deleteLater();
+	
+	if ( successful )
+	{
+		m_jobStates[index] = Done;
+		m_doneCount++;
+	}
+	else
+		m_bFailed = true;
+	
+	startReadyJobs();
+}
+
+
+void ProcessListChain::slotProcessChainSuccessful()
+{
+	jobFinished( true );
 }
 
 
 void ProcessListChain::slotProcessChainFailed()
 {
-	emit failed();
+	jobFinished( false );
 }
 //END class ProcessListChain
 
@@ -14,6 +14,7 @@
 #include "language.h"
 #include <qobject.h>
 #include <qlist.h>
+#include <qmap.h>
 
 class FlowCode;
 class Gpasm;
@@ -97,6 +98,15 @@ class ProcessChain : public QObject
 };
 
 
+/**
+Builds a list of ProcessOptions, as flattened by ProjectItem::build. The list
+is treated as a dependency graph: an entry depends on every earlier entry whose
+target file it takes as an input file or links against. Entries whose
+dependencies have all been built are started as soon as a slot is free, with at
+most maxJobs() external processes running at once. On the first failure, no
+further entries are started and failed() is emitted once the running entries
+have finished.
+*/
 class ProcessListChain : public QObject
 {
 	Q_OBJECT
@@ -104,6 +114,11 @@ class ProcessListChain : public QObject
 	public:
 		ProcessListChain( ProcessOptionsList pol, const char *name = 0l );
 		
+		/**
+		 * @return the maximum number of process chains that are run at once.
+		 */
+		static int maxJobs();
+		
 	signals:
 		/**
 		 * Emitted if successful
@@ -119,7 +134,36 @@ class ProcessListChain : public QObject
 		void slotProcessChainFailed();
 		
 	protected:
+		/**
+		 * Works out m_dependencies from the input files and link libraries of
+		 * each entry in m_processOptionsList.
+		 */
+		void initDependencies();
+		/**
+		 * Starts as many ready entries as there are free job slots, and emits
+		 * successful() or failed() once there is nothing left to do.
+		 */
+		void startReadyJobs();
+		/**
+		 * Called when the process chain that was started for the given entry
+		 * has finished.
+		 */
+		void jobFinished( bool successful );
+		
+		enum JobState
+		{
+			Waiting,
+			Running,
+			Done
+		};
+		
 		ProcessOptionsList m_processOptionsList;
+		QList< QList<int> > m_dependencies;
+		QList<JobState> m_jobStates;
+		QMap< ProcessChain*, int > m_runningJobs;
+		int m_doneCount;
+		bool m_bFailed;
+		bool m_bFinished;
 };
 
 #endif
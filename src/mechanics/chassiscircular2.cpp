@@ -11,6 +11,8 @@
 #include "chassiscircular2.h"
 
 #include "libraryitem.h"
+#include "mechanicsdocument.h"
+#include "mechanicssimulation.h"
 
 #include <klocalizedstring.h>
 #include <qpainter.h>
@@ -47,6 +49,22 @@ ChassisCircular2::ChassisCircular2( MechanicsDocument *mechanicsDocument, bool n
 	
 	m_theta1 = 0.0;
 	m_theta2 = 0.0;
+	m_speed1 = 0.0;
+	m_speed2 = 0.0;
+	
+	createProperty( "speed1", Variant::Type::Double );
+	property("speed1")->setCaption( i18n("Left Wheel Speed") );
+	property("speed1")->setUnit("px/s");
+	property("speed1")->setValue(0.0);
+	property("speed1")->setMinValue(-1e3);
+	property("speed1")->setMaxValue(1e3);
+	
+	createProperty( "speed2", Variant::Type::Double );
+	property("speed2")->setCaption( i18n("Right Wheel Speed") );
+	property("speed2")->setUnit("px/s");
+	property("speed2")->setValue(0.0);
+	property("speed2")->setMinValue(-1e3);
+	property("speed2")->setMaxValue(1e3);
 	
 	//Q3PointArray pa;    // 2018.08.14 - ported to PainterPath
 	//pa.makeEllipse( -25, -25, 50, 50 );
@@ -78,25 +96,37 @@ void ChassisCircular2::itemResized()
 }
 
 
-void ChassisCircular2::advance( int phase )
+void ChassisCircular2::dataChanged()
 {
-	if ( phase != 1 )
+	MechanicsItem::dataChanged();
+	
+	const double speed1 = dataDouble("speed1");
+	const double speed2 = dataDouble("speed2");
+	if ( speed1 == m_speed1 && speed2 == m_speed2 )
 		return;
 	
-	double speed1 = 60.; // pixels per second
-	double speed2 = 160.; // pixels per second
+	m_speed1 = speed1;
+	m_speed2 = speed2;
+	
+	// The body may have gone to sleep while the wheels were stopped
+	if ( MechanicsSimulation *simulation = p_mechanicsDocument->mechanicsSimulation() )
+		simulation->wakeUp(this);
+}
+
+
+void ChassisCircular2::applyForces( RigidBody *body, double delta )
+{
+	if ( m_speed1 == 0. && m_speed2 == 0. )
+		return;
 	
-	m_theta1 = normalizeAngle( m_theta1 + (speed1/1000.)/m_wheel1Pos.width() );
-	m_theta2 = normalizeAngle( m_theta2 + (speed2/1000.)/m_wheel2Pos.width() );
+	m_theta1 = normalizeAngle( m_theta1 + (m_speed1*delta)/m_wheel1Pos.width() );
+	m_theta2 = normalizeAngle( m_theta2 + (m_speed2*delta)/m_wheel2Pos.width() );
 	
-	const double d1 = speed1/1000.;
-	const double d2 = speed2/1000.;
+	// The wheels don't slip, so they set the velocity of the chassis
 	const double sep = m_wheel2Pos.center().y()-m_wheel1Pos.center().y();
-	
-	double dtheta = std::atan( (d2-d1)/sep ); // Change in orientation of chassis
-	double moveAngle = absolutePosition().angle()+dtheta/2;
-	rotateBy(dtheta);
-	moveBy( ((d1+d2)/2.)*std::cos(moveAngle), ((d1+d2)/2.)*std::sin(moveAngle) );
+	const double angle = absolutePosition().angle();
+	body->setVelocity( Vector2D( ((m_speed1+m_speed2)/2.)*std::cos(angle), ((m_speed1+m_speed2)/2.)*std::sin(angle) ) );
+	body->setAngularVelocity( (m_speed2-m_speed1)/sep );
 }
 
 
@@ -26,14 +26,21 @@ public:
 	static Item* construct( ItemDocument *itemDocument, bool newItem, const char *id );
 	static LibraryItem *libraryItem();
 	
-	virtual void advance( int phase );
+	/**
+	 * Sets the velocity of the body from the wheel speeds. Does nothing while
+	 * both wheels are stopped, so that the body can come to rest and sleep.
+	 */
+	virtual void applyForces( RigidBody *body, double delta );
 	
 protected:
 	virtual void itemResized();
+	virtual void dataChanged();
 	void drawShape( QPainter &p );
 	
 	double m_theta1; // Angle of rotation of wheel 1 (used for drawing)
 	double m_theta2; // Angle of rotation of wheel 1 (used for drawing)
+	double m_speed1; // Speed of wheel 1 in pixels per second
+	double m_speed2; // Speed of wheel 2 in pixels per second
 	
 	QRect m_wheel1Pos; // Position of first wheel, with respect to top left of item
 	QRect m_wheel2Pos; // Position of second wheel, with respect to top left of item
@@ -49,6 +49,7 @@ MechanicsDocument::~MechanicsDocument()
 	selectAll();
 	deleteSelection();
 	delete m_mechanicsSimulation;
+	m_mechanicsSimulation = 0l;
 }
 
 View *MechanicsDocument::createView( ViewContainer *viewContainer, uint viewAreaId, const char *name )
@@ -132,7 +133,12 @@ void MechanicsDocument::deleteSelection()
 
 bool MechanicsDocument::registerItem( KtlQCanvasItem *qcanvasItem )
 {
-	return ItemDocument::registerItem(qcanvasItem);
+	if ( !ItemDocument::registerItem(qcanvasItem) )
+		return false;
+	
+	if ( m_mechanicsSimulation && dynamic_cast<MechanicsItem*>(qcanvasItem) )
+		m_mechanicsSimulation->bodiesChanged();
+	return true;
 }
 
 
@@ -148,6 +154,8 @@ void MechanicsDocument::appendDeleteList( KtlQCanvasItem *qcanvasItem )
 	
 	disconnect( mechItem, SIGNAL(selectionChanged()), this, SIGNAL(selectionChanged()) );
 	
+	if (m_mechanicsSimulation)
+		m_mechanicsSimulation->itemRemoved(mechItem);
 	mechItem->removeItem();
 }
 
@@ -56,6 +56,10 @@ public:
 	 * Register an item with the ICNDocument.
 	 */
 	virtual bool registerItem( KtlQCanvasItem *qcanvasItem );
+	/**
+	 * Returns the simulation that moves the items of this document.
+	 */
+	MechanicsSimulation *mechanicsSimulation() const { return m_mechanicsSimulation; }
 
 protected:
 	MechanicsGroup *m_selectList;
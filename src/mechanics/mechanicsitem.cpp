@@ -11,6 +11,7 @@
 #include "itemdocumentdata.h"
 #include "mechanicsitem.h"
 #include "mechanicsdocument.h"
+#include "mechanicssimulation.h"
 
 #include <kdebug.h>
 #include <klocalizedstring.h>
@@ -123,6 +124,8 @@ void MechanicsItem::reparented( Item *oldItem, Item *newItem )
 	}
 	
 	updateCanvasPoints();
+	if ( MechanicsSimulation *simulation = p_mechanicsDocument->mechanicsSimulation() )
+		simulation->bodiesChanged();
 }
 
 
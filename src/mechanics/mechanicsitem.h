@@ -18,6 +18,7 @@ class LibraryItem;
 class MechanicsItem;
 // class MechanicsItemOverlayItem;
 class MechanicsDocument;
+class RigidBody;
 typedef QList<MechanicsItem*> MechanicsItemList;
 
 /**
@@ -167,6 +168,13 @@ public:
 	 * whether this item is allowed to be distorted, inverted, resized, etc.
 	 */
 	QRect maxInnerRectangle( const QRect &outerRect ) const;
+	/**
+	 * Called at the start of each step of the mechanics simulation while the
+	 * rigid body containing this item is awake. Reinherit this function to
+	 * apply forces to the body, or to drive it by setting its velocity.
+	 * @param delta length of the step in seconds
+	 */
+	virtual void applyForces( RigidBody *body, double delta ) { Q_UNUSED(body); Q_UNUSED(delta); }
 	
 	virtual ItemData itemData() const;
 	
@@ -11,29 +11,319 @@
 #include "mechanicsdocument.h"
 #include "mechanicsitem.h"
 #include "mechanicssimulation.h"
+#include "simulator.h"
 
+#include <algorithm>
 #include <cmath>
+#include <kdebug.h>
+#include <qhash.h>
+#include <qset.h>
 #include <qtimer.h>
+#include <qvector.h>
+
+const double RigidBody::linearDamping = 2.0;
+const double RigidBody::angularDamping = 4.0;
+const double RigidBody::restitution = 0.5;
+
+/// Bodies slower than these (pixels and radians per second) are at rest
+static const double restSpeed = 0.5;
+static const double restAngularSpeed = 0.005;
+/// Number of steps a body has to be at rest for before it is put to sleep
+static const int sleepSteps = MECHANICS_UPDATE_RATE / 10;
+
+static const long long ticksPerStep = LOGIC_UPDATE_RATE / MECHANICS_UPDATE_RATE;
+
+/// @returns the start of the step containing the given time
+static long long stepStart( long long time )
+{
+	return time - (time % ticksPerStep);
+}
+
 
 MechanicsSimulation::MechanicsSimulation( MechanicsDocument *mechanicsDocument )
 	: QObject(mechanicsDocument)
 {
 	p_mechanicsDocument = mechanicsDocument;
+	m_bBodiesChanged = false;
+	m_time = stepStart( Simulator::self()->time() );
+	m_droppedTime = 0;
+	
 	m_advanceTmr = new QTimer(this);
 	connect( m_advanceTmr, SIGNAL(timeout()), this, SLOT(slotAdvance()) );
-	m_advanceTmr->start(20); // it is not implemented anyway, so don't hog the CPU
+	connect( Simulator::self(), SIGNAL(simulatingStateChanged(bool)), this, SLOT(updateTimer()) );
 }
 
 
 MechanicsSimulation::~MechanicsSimulation()
 {
+	qDeleteAll(m_rigidBodies);
 }
 
 
 void MechanicsSimulation::slotAdvance()
 {
-// 	if ( p_mechanicsDocument && p_mechanicsDocument->canvas() )
-// 		p_mechanicsDocument->canvas()->advance();
+	advanceTo( Simulator::self()->time() );
+	updateTimer();
+}
+
+
+void MechanicsSimulation::updateTimer()
+{
+	const bool run = !Simulator::isDestroyedSim() && Simulator::self()->isSimulating() && hasAwakeBodies();
+	
+	if ( run && !m_advanceTmr->isActive() )
+		m_advanceTmr->start(SIMULATOR_STEP_INTERVAL_MS);
+	else if ( !run && m_advanceTmr->isActive() )
+		m_advanceTmr->stop();
+}
+
+
+bool MechanicsSimulation::hasAwakeBodies() const
+{
+	if (m_bBodiesChanged)
+		return true;
+	
+	const RigidBodyList::const_iterator end = m_rigidBodies.end();
+	for ( RigidBodyList::const_iterator it = m_rigidBodies.begin(); it != end; ++it )
+	{
+		if ( (*it)->isAwake() )
+			return true;
+	}
+	return false;
+}
+
+
+void MechanicsSimulation::advanceTo( long long time )
+{
+	if ( !hasAwakeBodies() )
+	{
+		// Sleeping bodies are not behind
+		m_time = stepStart(time);
+		return;
+	}
+	
+	// If we have fallen far behind (e.g. the GUI was blocked), then drop the
+	// backlog instead of blocking the GUI even longer to catch up with it
+	const long long maxLag = LOGIC_UPDATE_RATE / 4;
+	if ( time - m_time > maxLag )
+	{
+		const long long resume = stepStart( time - maxLag );
+		m_droppedTime += resume - m_time;
+		kWarning() << k_funcinfo << "Fell behind; skipped " << (resume - m_time) * 1000 / LOGIC_UPDATE_RATE << " ms" << endl;
+		m_time = resume;
+	}
+	
+	while ( m_time + ticksPerStep <= time )
+	{
+		if ( !hasAwakeBodies() )
+		{
+			// Nothing to integrate until a body is woken up again
+			m_time = stepStart(time);
+			return;
+		}
+		
+		step();
+		m_time += ticksPerStep;
+	}
+}
+
+
+void MechanicsSimulation::step()
+{
+	if (m_bBodiesChanged)
+		rebuildBodies();
+	
+	const RigidBodyList::iterator end = m_rigidBodies.end();
+	for ( RigidBodyList::iterator it = m_rigidBodies.begin(); it != end; ++it )
+	{
+		if ( (*it)->isAwake() )
+			(*it)->applyForces(MECHANICS_UPDATE_PERIOD);
+	}
+	
+	collideBodies();
+	
+	for ( RigidBodyList::iterator it = m_rigidBodies.begin(); it != end; ++it )
+	{
+		if ( (*it)->isAwake() )
+			(*it)->integrate(MECHANICS_UPDATE_PERIOD);
+	}
+}
+
+
+void MechanicsSimulation::collide( RigidBody *a, const QRect &rectA, RigidBody *b, const QRect &rectB )
+{
+	const QPointF ca = QRectF(rectA).center();
+	const QPointF cb = QRectF(rectB).center();
+	
+	double nx = cb.x() - ca.x();
+	double ny = cb.y() - ca.y();
+	const double dist = std::sqrt( nx*nx + ny*ny );
+	const double radii = 0.5 * (std::max( rectA.width(), rectA.height() ) + std::max( rectB.width(), rectB.height() ));
+	if ( dist >= radii || dist == 0. || a->mass() <= 0. || b->mass() <= 0. )
+		return;
+	
+	nx /= dist;
+	ny /= dist;
+	
+	const Vector2D va = a->velocity();
+	const Vector2D vb = b->velocity();
+	const double vn = (vb.x - va.x)*nx + (vb.y - va.y)*ny;
+	if ( vn >= 0. )
+		// Already moving apart
+		return;
+	
+	const double j = -(1. + RigidBody::restitution) * vn / (1./a->mass() + 1./b->mass());
+	a->applyImpulse( Vector2D( -j*nx, -j*ny ) );
+	b->applyImpulse( Vector2D( j*nx, j*ny ) );
+}
+
+
+/// Key in the spatial hash for the chunk (i,j)
+static inline qint64 chunkKey( int i, int j )
+{
+	return (qint64(i) << 32) | quint32(j);
+}
+
+
+void MechanicsSimulation::collideBodies()
+{
+	const int n = m_rigidBodies.size();
+	if ( !p_mechanicsDocument || n < 2 )
+		return;
+	
+	const double chunkSize = p_mechanicsDocument->canvas()->chunkSize();
+	
+	QVector<QRect> rects(n);
+	QVector<QRect> chunks(n); // Range of chunks covered by each body
+	QHash< qint64, QList<int> > chunkBodies;
+	
+	for ( int i = 0; i < n; ++i )
+	{
+		rects[i] = m_rigidBodies[i]->boundingRect();
+		chunks[i] = QRect( QPoint( int(std::floor( rects[i].left() / chunkSize )), int(std::floor( rects[i].top() / chunkSize )) ),
+						   QPoint( int(std::floor( rects[i].right() / chunkSize )), int(std::floor( rects[i].bottom() / chunkSize )) ) );
+		
+		for ( int x = chunks[i].left(); x <= chunks[i].right(); ++x )
+		{
+			for ( int y = chunks[i].top(); y <= chunks[i].bottom(); ++y )
+				chunkBodies[ chunkKey( x, y ) ].append(i);
+		}
+	}
+	
+	for ( int i = 0; i < n; ++i )
+	{
+		if ( !m_rigidBodies[i]->isAwake() )
+			continue;
+		
+		QSet<int> tested;
+		for ( int x = chunks[i].left(); x <= chunks[i].right(); ++x )
+		{
+			for ( int y = chunks[i].top(); y <= chunks[i].bottom(); ++y )
+			{
+				const QList<int> others = chunkBodies.value( chunkKey( x, y ) );
+				const QList<int>::const_iterator othersEnd = others.end();
+				for ( QList<int>::const_iterator it = others.begin(); it != othersEnd; ++it )
+				{
+					const int j = *it;
+					
+					// Pairs of awake bodies are only tested from the lower index
+					if ( j == i || (j < i && m_rigidBodies[j]->isAwake()) || tested.contains(j) )
+						continue;
+					
+					tested.insert(j);
+					if ( rects[i].intersects(rects[j]) )
+						collide( m_rigidBodies[i], rects[i], m_rigidBodies[j], rects[j] );
+				}
+			}
+		}
+	}
+}
+
+
+void MechanicsSimulation::wakeUp( MechanicsItem *item )
+{
+	if ( !hasAwakeBodies() && !Simulator::isDestroyedSim() )
+		// The bodies were not integrated while asleep, so catch up with the
+		// simulator from now on
+		m_time = stepStart( Simulator::self()->time() );
+	
+	const RigidBodyList::iterator end = m_rigidBodies.end();
+	for ( RigidBodyList::iterator it = m_rigidBodies.begin(); it != end; ++it )
+	{
+		if ( !item || (*it)->contains(item) )
+			(*it)->setAwake(true);
+	}
+	
+	updateTimer();
+}
+
+
+void MechanicsSimulation::bodiesChanged()
+{
+	wakeUp();
+	m_bBodiesChanged = true;
+	updateTimer();
+}
+
+
+void MechanicsSimulation::itemRemoved( MechanicsItem *item )
+{
+	RigidBodyList::iterator it = m_rigidBodies.begin();
+	while ( it != m_rigidBodies.end() )
+	{
+		if ( (*it)->contains(item) )
+		{
+			delete *it;
+			it = m_rigidBodies.erase(it);
+		}
+		else
+			++it;
+	}
+	
+	m_bBodiesChanged = true;
+	updateTimer();
+}
+
+
+void MechanicsSimulation::rebuildBodies()
+{
+	m_bBodiesChanged = false;
+	
+	QHash< MechanicsItem*, RigidBody* > oldBodies;
+	const RigidBodyList::iterator bodiesEnd = m_rigidBodies.end();
+	for ( RigidBodyList::iterator it = m_rigidBodies.begin(); it != bodiesEnd; ++it )
+		oldBodies[ (*it)->overallParent() ] = *it;
+	m_rigidBodies.clear();
+	
+	if (!p_mechanicsDocument)
+	{
+		qDeleteAll(oldBodies);
+		return;
+	}
+	
+	const ItemList items = p_mechanicsDocument->itemList();
+	const ItemList::const_iterator end = items.end();
+	for ( ItemList::const_iterator it = items.begin(); it != end; ++it )
+	{
+		MechanicsItem *mechItem = dynamic_cast<MechanicsItem*>((Item*)*it);
+		if ( !mechItem || dynamic_cast<MechanicsItem*>(mechItem->parentItem()) )
+			continue;
+		
+		RigidBody *body = new RigidBody(p_mechanicsDocument);
+		body->addMechanicsItem(mechItem);
+		
+		const ItemList children = mechItem->children(true);
+		const ItemList::const_iterator childrenEnd = children.end();
+		for ( ItemList::const_iterator child = children.begin(); child != childrenEnd; ++child )
+			body->addMechanicsItem( dynamic_cast<MechanicsItem*>((Item*)*child) );
+		
+		if ( RigidBody *oldBody = oldBodies.value(mechItem) )
+			body->setState( oldBody->state() );
+		
+		m_rigidBodies.append(body);
+	}
+	
+	qDeleteAll(oldBodies);
 }
 
 
@@ -41,6 +331,11 @@ RigidBody::RigidBody( MechanicsDocument *mechanicsDocument )
 {
 	p_mechanicsDocument = mechanicsDocument;
 	p_overallParent = 0l;
+	m_mass = 0.;
+	m_momentOfInertia = 0.;
+	m_torque = 0.;
+	m_bAwake = true;
+	m_restSteps = 0;
 }
 
 
@@ -60,6 +355,132 @@ bool RigidBody::addMechanicsItem( MechanicsItem *item )
 }
 
 
+void RigidBody::applyForces( double delta )
+{
+	updateRigidBodyInfo();
+	
+	const MechanicsItemList::iterator end = m_mechanicsItemList.end();
+	for ( MechanicsItemList::iterator it = m_mechanicsItemList.begin(); it != end; ++it )
+		(*it)->applyForces( this, delta );
+}
+
+
+void RigidBody::integrate( double delta )
+{
+	if ( !p_overallParent || m_mass <= 0. || m_momentOfInertia <= 0. )
+	{
+		setAwake(false);
+		return;
+	}
+	
+	// Semi-implicit Euler: the momenta are updated first, and the position is
+	// then moved with the new velocity
+	m_rigidBodyState.linearMomentum.x += m_force.x * delta;
+	m_rigidBodyState.linearMomentum.y += m_force.y * delta;
+	m_rigidBodyState.angularMomentum += m_torque * delta;
+	
+	const double dx = m_rigidBodyState.linearMomentum.x / m_mass * delta;
+	const double dy = m_rigidBodyState.linearMomentum.y / m_mass * delta;
+	const double dtheta = m_rigidBodyState.angularMomentum / m_momentOfInertia * delta;
+	
+	if ( dx != 0. || dy != 0. )
+		moveBy( dx, dy );
+	if ( dtheta != 0. )
+		rotateBy(dtheta);
+	
+	// Friction with the floor. This is applied after moving, so that bodies
+	// whose velocity is set by their items move at exactly that velocity.
+	const double linearFactor = 1. / (1. + linearDamping * delta);
+	m_rigidBodyState.linearMomentum.x *= linearFactor;
+	m_rigidBodyState.linearMomentum.y *= linearFactor;
+	m_rigidBodyState.angularMomentum /= 1. + angularDamping * delta;
+	
+	const bool atRest = m_force.x == 0. && m_force.y == 0. && m_torque == 0.
+			&& velocity().lengthSquared() < restSpeed * restSpeed
+			&& std::abs( angularVelocity() ) < restAngularSpeed;
+	
+	m_force = Vector2D();
+	m_torque = 0.;
+	
+	if (!atRest)
+		m_restSteps = 0;
+	else if ( ++m_restSteps >= sleepSteps )
+		setAwake(false);
+}
+
+
+void RigidBody::applyForce( const Vector2D &force, const Vector2D &offset )
+{
+	m_force.x += force.x;
+	m_force.y += force.y;
+	m_torque += offset.x * force.y - offset.y * force.x;
+}
+
+
+void RigidBody::applyImpulse( const Vector2D &impulse )
+{
+	m_rigidBodyState.linearMomentum.x += impulse.x;
+	m_rigidBodyState.linearMomentum.y += impulse.y;
+	setAwake(true);
+}
+
+
+Vector2D RigidBody::velocity() const
+{
+	if ( m_mass <= 0. )
+		return Vector2D();
+	
+	return Vector2D( m_rigidBodyState.linearMomentum.x / m_mass, m_rigidBodyState.linearMomentum.y / m_mass );
+}
+
+
+double RigidBody::angularVelocity() const
+{
+	if ( m_momentOfInertia <= 0. )
+		return 0.;
+	
+	return m_rigidBodyState.angularMomentum / m_momentOfInertia;
+}
+
+
+void RigidBody::setVelocity( const Vector2D &velocity )
+{
+	m_rigidBodyState.linearMomentum.x = velocity.x * m_mass;
+	m_rigidBodyState.linearMomentum.y = velocity.y * m_mass;
+}
+
+
+void RigidBody::setAngularVelocity( double angularVelocity )
+{
+	m_rigidBodyState.angularMomentum = angularVelocity * m_momentOfInertia;
+}
+
+
+void RigidBody::setAwake( bool awake )
+{
+	m_restSteps = 0;
+	if ( awake == m_bAwake )
+		return;
+	
+	m_bAwake = awake;
+	if (!awake)
+	{
+		m_rigidBodyState.linearMomentum = Vector2D();
+		m_rigidBodyState.angularMomentum = 0.;
+	}
+}
+
+
+QRect RigidBody::boundingRect() const
+{
+	QRect rect;
+	const MechanicsItemList::const_iterator end = m_mechanicsItemList.end();
+	for ( MechanicsItemList::const_iterator it = m_mechanicsItemList.begin(); it != end; ++it )
+		rect |= (*it)->boundingRect();
+	return rect;
+}
+
+
 void RigidBody::moveBy( double dx, double dy )
 {
 	if (overallParent())
@@ -124,6 +545,12 @@ Vector2D::Vector2D()
 	y = 0.;
 }
 
+Vector2D::Vector2D( double x, double y )
+{
+	this->x = x;
+	this->y = y;
+}
+
 double Vector2D::length() const
 {
 	return std::sqrt( x*x + y*y );
@@ -14,10 +14,21 @@
 #include <qpointer.h>
 #include <qobject.h>
 #include <qlist.h>
+#include <qrect.h>
 
 class MechanicsItem;
 class MechanicsDocument;
+class QTimer;
+class RigidBody;
 typedef QList<MechanicsItem*> MechanicsItemList;
+typedef QList<RigidBody*> RigidBodyList;
+
+/**
+This is the number of times a second that the rigid bodies are integrated. It
+should divide LOGIC_UPDATE_RATE.
+*/
+const int MECHANICS_UPDATE_RATE = 1000;
+const double MECHANICS_UPDATE_PERIOD = 1.0 / MECHANICS_UPDATE_RATE;
 
 
 /**
@@ -28,6 +39,7 @@ class Vector2D
 {
 public:
 	Vector2D();
+	Vector2D( double x, double y );
 	
 	double length() const;
 	double lengthSquared() const { return x*x + y*y; }
@@ -53,6 +65,11 @@ public:
 		
 
 /**
+Integrates the rigid bodies of a MechanicsDocument with a fixed step of
+MECHANICS_UPDATE_PERIOD. The steps are taken in lockstep with
+Simulator::time(), so the mechanics pause with the simulator and motion driven
+by components stays in sync with the circuit. Bodies that have been at rest for
+a while are put to sleep, and the timer is stopped while no body is awake.
 @author David Saxton
 */
 class MechanicsSimulation : public QObject
@@ -63,13 +80,83 @@ public:
     ~MechanicsSimulation();
 	
 	MechanicsDocument* mechanicsDocument() const { return p_mechanicsDocument; }
+	/**
+	 * Integrates the awake bodies by one step of MECHANICS_UPDATE_PERIOD. The
+	 * result only depends on the state of the bodies, and not on when or how
+	 * often this is called.
+	 */
+	void step();
+	/**
+	 * Takes as many steps as fit before the given time. At most a quarter of
+	 * a second is caught up with in one call; if the bodies are further
+	 * behind than that (e.g. because the GUI was blocked), the rest is
+	 * skipped rather than integrated, and added to droppedTime. The steps
+	 * themselves are always of MECHANICS_UPDATE_PERIOD.
+	 * @param time in units of 1/LOGIC_UPDATE_RATE, as Simulator::time()
+	 */
+	void advanceTo( long long time );
+	/**
+	 * @returns the total time, in units of 1/LOGIC_UPDATE_RATE, that
+	 * advanceTo has skipped because the bodies had fallen too far behind.
+	 */
+	long long droppedTime() const { return m_droppedTime; }
+	/**
+	 * @returns the time up to which the bodies have been integrated, in units
+	 * of 1/LOGIC_UPDATE_RATE.
+	 */
+	long long time() const { return m_time; }
+	/**
+	 * Wakes the body containing the given item, or all bodies if item is
+	 * null. Items that are driven from outside the mechanics simulation
+	 * should call this when their drive changes.
+	 */
+	void wakeUp( MechanicsItem *item = 0l );
+	/**
+	 * Called when items are added or reparented; the rigid bodies are
+	 * rebuilt before the next step.
+	 */
+	void bodiesChanged();
+	/**
+	 * Called when an item is about to be deleted. Bodies containing the item
+	 * are discarded immediately.
+	 */
+	void itemRemoved( MechanicsItem *item );
+	/**
+	 * Resolves a collision between the bounding circles of the two bodies,
+	 * given their bounding rectangles, with an impulse along the line
+	 * between their centers. Nothing is done if the circles do not overlap
+	 * or the bodies are already moving apart.
+	 */
+	static void collide( RigidBody *a, const QRect &rectA, RigidBody *b, const QRect &rectB );
 
 protected slots:
 	void slotAdvance();
+	/**
+	 * Runs the timer if the simulator is running and a body is awake, and
+	 * stops it otherwise.
+	 */
+	void updateTimer();
 	
 protected:
+	/**
+	 * Creates a rigid body for every MechanicsItem without a MechanicsItem
+	 * parent, keeping the state of bodies that already existed.
+	 */
+	void rebuildBodies();
+	/**
+	 * Broad phase: the bodies are bucketed by the canvas chunks that their
+	 * bounding rectangles cover, and each awake body is only tested against
+	 * bodies sharing a chunk with it.
+	 */
+	void collideBodies();
+	bool hasAwakeBodies() const;
+	
 	QPointer<MechanicsDocument> p_mechanicsDocument;
 	QTimer *m_advanceTmr;
+	RigidBodyList m_rigidBodies;
+	bool m_bBodiesChanged;
+	long long m_time;
+	long long m_droppedTime;
 };
 
 
@@ -86,10 +173,56 @@ public:
 	RigidBody( MechanicsDocument *mechanicsDocument );
 	~RigidBody();
 	
+	/// Rate (per second) at which friction with the floor damps the linear momentum
+	static const double linearDamping;
+	/// Rate (per second) at which friction with the floor damps the angular momentum
+	static const double angularDamping;
+	/// Coefficient of restitution for collisions between bodies
+	static const double restitution;
+	
+	/**
+	 * Lets the items apply their forces for the coming step. Called at the
+	 * start of each step while the body is awake.
+	 * @param delta length of the step in seconds
+	 */
+	void applyForces( double delta );
+	/**
+	 * Integrates the momenta and the position by one step (semi-implicit
+	 * Euler), and puts the body to sleep if it has been at rest for long
+	 * enough.
+	 * @param delta length of the step in seconds
+	 */
+	void integrate( double delta );
+	/**
+	 * Adds the force, acting at the given offset from the center of mass, to
+	 * the forces for the current step.
+	 */
+	void applyForce( const Vector2D &force, const Vector2D &offset );
+	void applyTorque( double torque ) { m_torque += torque; }
+	/**
+	 * Changes the linear momentum immediately (and wakes the body).
+	 */
+	void applyImpulse( const Vector2D &impulse );
+	Vector2D velocity() const;
+	double angularVelocity() const;
+	/**
+	 * Sets the velocity of the body, for items that drive it directly.
+	 */
+	void setVelocity( const Vector2D &velocity );
+	void setAngularVelocity( double angularVelocity );
+	double mass() const { return m_mass; }
+	const RigidBodyState & state() const { return m_rigidBodyState; }
+	void setState( const RigidBodyState &state ) { m_rigidBodyState = state; }
+	bool isAwake() const { return m_bAwake; }
+	void setAwake( bool awake );
+	/**
+	 * @returns whether the item is one of the items of this body.
+	 */
+	bool contains( MechanicsItem *item ) const { return m_mechanicsItemList.contains(item); }
 	/**
-	 * 
+	 * @returns the union of the bounding rectangles of the items.
 	 */
-	void advance( int phase, double delta );
+	QRect boundingRect() const;
 	/**
 	 * Add the MechanicsItem to the entity.
 	 * @returns true iff successful in adding
@@ -128,6 +261,10 @@ protected:
 	RigidBodyState m_rigidBodyState;
 	double m_mass;
 	double m_momentOfInertia;
+	Vector2D m_force; // Force accumulated for the current step
+	double m_torque; // Torque accumulated for the current step
+	bool m_bAwake;
+	int m_restSteps; // Number of consecutive steps that the body has been at rest
 };
 
 #endif
@@ -10,9 +10,45 @@
 
 #include "oscilloscopedata.h"
 #include "oscilloscope.h"
+#include "probedataexporter.h"
+
+#include <algorithm>
 
 using namespace std;
 
+//BEGIN class TriggerIndex
+void TriggerIndex::add( uint64_t time)
+{
+	if( m_times.size() >= MAX_PROBE_DATA_SIZE) return;
+
+	if( m_times.empty() || m_times.back() <= time) {
+		m_times.push_back(time);
+		return;
+	}
+
+	m_times.insert( upper_bound( m_times.begin(), m_times.end(), time), time);
+}
+
+bool TriggerIndex::next( uint64_t time, uint64_t * next) const
+{
+	vector<uint64_t>::const_iterator it = upper_bound( m_times.begin(), m_times.end(), time);
+	if( it == m_times.end()) return false;
+
+	*next = *it;
+	return true;
+}
+
+bool TriggerIndex::previous( uint64_t time, uint64_t * previous) const
+{
+	vector<uint64_t>::const_iterator it = lower_bound( m_times.begin(), m_times.end(), time);
+	if( it == m_times.begin()) return false;
+
+	*previous = *(--it);
+	return true;
+}
+//END class TriggerIndex
+
+
 //BEGIN class ProbeData
 ProbeData::ProbeData( int id)
 	: m_id(id), m_drawPosition(0.5),
@@ -33,16 +69,114 @@ void ProbeData::setColor( QColor color)
 
 
 //BEGIN class LogicProbeData
+TriggerIndex LogicProbeData::s_patternTriggerIndex;
+int LogicProbeData::s_patternProbes = 0;
+int LogicProbeData::s_patternMismatches = 0;
+
 LogicProbeData::LogicProbeData( int id)
 	: ProbeData(id)
 {
 	m_data = new vector<LogicDataPoint>;
+	m_trigger = NoTrigger;
+	m_minPulseWidth = 0;
+	m_maxPulseWidth = 0;
+	m_patternBit = DontCare;
+	m_lastValue = false;
+	m_hasLastValue = false;
+	m_lastEdgeTime = m_resetTime;
+}
+
+LogicProbeData::~LogicProbeData()
+{
+	setPatternBit(DontCare);
+	delete m_data;
 }
 
 void LogicProbeData::addDataPoint( LogicDataPoint data) {
-    if (m_data->size() < MAX_PROBE_DATA_SIZE) {
-        m_data->push_back(data);
-    }
+	if( ProbeDataExporter::isStreaming())
+		ProbeDataExporter::self()->addSample( m_id, data.time, data.value ? 1.f : 0.f);
+
+	if( m_data->size() >= MAX_PROBE_DATA_SIZE) return;
+
+	m_data->push_back(data);
+
+	const bool value = data.value;
+	const uint64_t time = data.time;
+	const bool isEdge = m_hasLastValue && (value != m_lastValue);
+	const bool matchedBefore = matchesPattern();
+
+	m_lastValue = value;
+	m_hasLastValue = true;
+
+	if( m_patternBit != DontCare && updatePattern(matchedBefore))
+		s_patternTriggerIndex.add(time);
+
+	if(!isEdge) return;
+
+	switch(m_trigger) {
+		case NoTrigger:
+			break;
+		case RisingEdge:
+			if(value) m_triggerIndex.add(time);
+			break;
+		case FallingEdge:
+			if(!value) m_triggerIndex.add(time);
+			break;
+		case AnyEdge:
+			m_triggerIndex.add(time);
+			break;
+		case HighPulse:
+		case LowPulse:
+		{
+			// Fire at the edge that ends the pulse, once its width is known
+			const bool pulseEnded = (m_trigger == HighPulse) ? !value : value;
+			const uint64_t width = time - m_lastEdgeTime;
+			if( pulseEnded && width >= m_minPulseWidth && (m_maxPulseWidth == 0 || width <= m_maxPulseWidth))
+				m_triggerIndex.add(time);
+			break;
+		}
+	}
+
+	m_lastEdgeTime = time;
+}
+
+void LogicProbeData::setTrigger( Trigger trigger, uint64_t minWidth, uint64_t maxWidth)
+{
+	m_trigger = trigger;
+	m_minPulseWidth = minWidth;
+	m_maxPulseWidth = maxWidth;
+}
+
+void LogicProbeData::setPatternBit( PatternBit bit)
+{
+	if( bit == m_patternBit) return;
+
+	const bool matchedBefore = matchesPattern();
+
+	if( m_patternBit == DontCare) s_patternProbes++;
+	else if( bit == DontCare) s_patternProbes--;
+
+	m_patternBit = bit;
+
+	// Changing the pattern is not an event in the recorded data, so it does
+	// not trigger
+	updatePattern(matchedBefore);
+}
+
+bool LogicProbeData::matchesPattern() const
+{
+	if( m_patternBit == DontCare) return true;
+
+	return m_hasLastValue && (m_lastValue == (m_patternBit == PatternHigh));
+}
+
+bool LogicProbeData::updatePattern( bool matchedBefore)
+{
+	const bool matches = matchesPattern();
+	if( matches == matchedBefore) return false;
+
+	s_patternMismatches += matches ? -1 : 1;
+	return matches && s_patternMismatches == 0 && s_patternProbes > 0;
 }
 
 void LogicProbeData::eraseData()
@@ -59,6 +193,9 @@ void LogicProbeData::eraseData()
 	m_data = new vector<LogicDataPoint>;
 
 	m_resetTime = Simulator::self()->time();
+	m_lastEdgeTime = m_resetTime;
+	m_triggerIndex.clear();
+	s_patternTriggerIndex.clear();
 
 	if(hasLastValue) addDataPoint( LogicDataPoint( lastValue, m_resetTime));
 }
@@ -109,20 +246,45 @@ FloatingProbeData::FloatingProbeData( int id)
 	m_scaling = Linear;
 	m_upperAbsValue = 10.0;
 	m_lowerAbsValue = 0.1;
+	m_pointCount = 0;
+	m_trigger = NoTrigger;
+	m_triggerLevel = 0.0;
 }
 
 void FloatingProbeData::addDataPoint( float data) {
-    if (m_data->size() < MAX_PROBE_DATA_SIZE) {
-        m_data->push_back(data);
-    }
+	// Streamed points have the same times as exported ones
+	const uint64_t time = toTime( m_pointCount++);
+	if( ProbeDataExporter::isStreaming())
+		ProbeDataExporter::self()->addSample( m_id, time, data);
+
+	if( m_data->size() >= MAX_PROBE_DATA_SIZE) return;
+
+	if( m_trigger != NoTrigger && !m_data->empty()) {
+		const float previous = m_data->back();
+		const bool rising = previous < m_triggerLevel && data >= m_triggerLevel;
+		const bool falling = previous > m_triggerLevel && data <= m_triggerLevel;
+
+		if( (rising && m_trigger != FallingLevel) || (falling && m_trigger != RisingLevel))
+			m_triggerIndex.add( toTime( m_data->size()));
+	}
+
+	m_data->push_back(data);
+}
+
+void FloatingProbeData::setTrigger( Trigger trigger, double level)
+{
+	m_trigger = trigger;
+	m_triggerLevel = level;
 }
 
 void FloatingProbeData::eraseData()
 {
 	delete m_data;
 	m_data = new vector<float>;
+	m_pointCount = 0;
 
 	m_resetTime = Simulator::self()->time();
+	m_triggerIndex.clear();
 }
 
 uint64_t FloatingProbeData::findPos( uint64_t time) const
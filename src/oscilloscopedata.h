@@ -46,6 +46,41 @@ class LogicDataPoint
 		uint64_t time	: 63;
 };
 
+/**
+The times (in Simulator time) at which the trigger condition of a probe was
+met, in increasing order. The triggers around a given time are found with a
+binary search, so navigating between them does not depend on the length of the
+capture.
+ */
+class TriggerIndex
+{
+	public:
+		/**
+		 * Records a trigger at the given time. Triggers are normally found in
+		 * order, so this is an append.
+		 */
+		void add( uint64_t time);
+		void clear() { m_times.clear(); }
+		bool isEmpty() const { return m_times.empty(); }
+		/**
+		 * Finds the first trigger after the given time.
+		 * @returns false if there is no such trigger
+		 */
+		bool next( uint64_t time, uint64_t * next) const;
+		/**
+		 * Finds the last trigger before the given time.
+		 * @returns false if there is no such trigger
+		 */
+		bool previous( uint64_t time, uint64_t * previous) const;
+		/**
+		 * @returns the time of the latest trigger, or 0 if there are none.
+		 */
+		uint64_t last() const { return m_times.empty() ? 0 : m_times.back(); }
+
+	protected:
+		std::vector<uint64_t> m_times;
+};
+
 /**
 @author David Saxton
  */
@@ -102,6 +137,11 @@ class ProbeData : public QObject
 		 * yet.
 		 */
 		virtual uint64_t findPos( uint64_t time) const = 0;
+		/**
+		 * @returns the times at which the trigger condition of this probe was
+		 * met since the last reset.
+		 */
+		const TriggerIndex & triggerIndex() const { return m_triggerIndex; }
 
 	signals:
 		/**
@@ -115,6 +155,7 @@ class ProbeData : public QObject
 		float m_drawPosition;
 		uint64_t m_resetTime;
 		QColor m_color;
+		TriggerIndex m_triggerIndex;
 };
 
 
@@ -124,11 +165,19 @@ class ProbeData : public QObject
 class LogicProbeData : public ProbeData
 {
 	public:
+		enum Trigger { NoTrigger, RisingEdge, FallingEdge, AnyEdge, HighPulse, LowPulse };
+		/**
+		 * The state that this probe must be in for the pattern trigger, which
+		 * is shared by all logic probes, to match.
+		 */
+		enum PatternBit { DontCare, PatternLow, PatternHigh };
+		
 		LogicProbeData( int id);
-		~LogicProbeData() { delete m_data; }
+		~LogicProbeData();
 
 		/**
-		 * Appends the data point to the set of data.
+		 * Appends the data point to the set of data, and evaluates the
+		 * triggers for it.
 		 */
 		void addDataPoint( LogicDataPoint data); /* {
 			m_data->push_back(data);
@@ -138,10 +187,49 @@ class LogicProbeData : public ProbeData
 		virtual uint64_t findPos( uint64_t time) const;
 
 		bool isEmpty() const { return m_data->size() == 0; }
+		/**
+		 * Sets the trigger condition of this probe. The pulse triggers fire at
+		 * the end of a pulse whose width (in Simulator time) is at least
+		 * minWidth and, unless maxWidth is 0, at most maxWidth.
+		 */
+		void setTrigger( Trigger trigger, uint64_t minWidth = 0, uint64_t maxWidth = 0);
+		void setPatternBit( PatternBit bit);
+		/**
+		 * @returns the times at which the pattern formed by the pattern bits
+		 * of all logic probes started to match.
+		 */
+		static const TriggerIndex & patternTriggerIndex() { return s_patternTriggerIndex; }
 
 	protected:
+		/**
+		 * @returns whether the current value matches the pattern bit.
+		 */
+		bool matchesPattern() const;
+		/**
+		 * Updates the number of probes that don't match the pattern, after the
+		 * value or the pattern bit of this probe has changed.
+		 * @param matchedBefore whether this probe matched before the change
+		 * @returns whether the pattern as a whole has started to match
+		 */
+		bool updatePattern( bool matchedBefore);
+
 		std::vector<LogicDataPoint> *m_data;
+		Trigger m_trigger;
+		uint64_t m_minPulseWidth;
+		uint64_t m_maxPulseWidth;
+		PatternBit m_patternBit;
+		bool m_lastValue;
+		bool m_hasLastValue;
+		uint64_t m_lastEdgeTime;
+
+		static TriggerIndex s_patternTriggerIndex;
+		/// Number of probes with a pattern bit
+		static int s_patternProbes;
+		/// Number of probes with a pattern bit that does not match
+		static int s_patternMismatches;
+
 		friend class OscilloscopeView;
+		friend class ProbeDataExporter;
 };
 
 /**
@@ -151,11 +239,13 @@ class FloatingProbeData : public ProbeData
 {
 	public:
 		enum Scaling { Linear, Logarithmic };
+		enum Trigger { NoTrigger, RisingLevel, FallingLevel, AnyLevel };
 		
 		FloatingProbeData( int id);
 		
 		/**
-		 * Appends the data point to the set of data.
+		 * Appends the data point to the set of data, and evaluates the
+		 * trigger for it.
 		 */
 		void addDataPoint( float data) ; // { m_data->push_back(data); } // 2016.05.06 - moved to cpp
 		/**
@@ -188,6 +278,11 @@ class FloatingProbeData : public ProbeData
 		 * only used with logarithmic scaling).
 		 */
 		double lowerAbsValue() const { return m_lowerAbsValue; }
+		/**
+		 * Sets the trigger condition of this probe, which fires when the
+		 * value crosses the given level in the given direction.
+		 */
+		void setTrigger( Trigger trigger, double level);
 		
 		virtual void eraseData();
 		virtual uint64_t findPos( uint64_t time) const;
@@ -199,7 +294,13 @@ class FloatingProbeData : public ProbeData
 		double m_upperAbsValue;
 		double m_lowerAbsValue;
 		std::vector<float> *m_data;
+		/// Number of points added since the data was erased, including those
+		/// beyond MAX_PROBE_DATA_SIZE; the time of the next point is toTime of it
+		uint64_t m_pointCount;
+		Trigger m_trigger;
+		double m_triggerLevel;
 		friend class OscilloscopeView;
+		friend class ProbeDataExporter;
 };
 
 #endif
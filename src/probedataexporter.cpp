@@ -0,0 +1,597 @@
+/***************************************************************************
+ *   Copyright (C) 2026 by the KTechLab developers                         *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ ***************************************************************************/
+
+#include "oscilloscopedata.h"
+#include "probedataexporter.h"
+#include "simulator.h"
+
+#include <kdebug.h>
+#include <klocalizedstring.h>
+
+#include <qdatastream.h>
+#include <qdatetime.h>
+#include <qfile.h>
+#include <qhash.h>
+#include <qset.h>
+#include <qtextstream.h>
+#include <qthread.h>
+
+#include <algorithm>
+
+/// Number of values that can be queued for the writer thread
+static const int QUEUE_CAPACITY = 1 << 16;
+/// How long the writer thread sleeps when there is nothing to write
+static const int WRITER_IDLE_MS = 10;
+
+
+//BEGIN class ProbeSampleQueue
+ProbeSampleQueue::ProbeSampleQueue( int capacity )
+	: m_head(0), m_tail(0)
+{
+	int size = 2;
+	while ( size < capacity )
+		size <<= 1;
+
+	m_samples.resize( size );
+	m_mask = size - 1;
+}
+
+
+bool ProbeSampleQueue::push( const ProbeSample & sample )
+{
+	// One slot is always left free, so that a full queue can be told apart
+	// from an empty one
+	const int head = m_head.fetchAndAddRelaxed(0);
+	const int next = (head + 1) & m_mask;
+	if ( next == m_tail.fetchAndAddAcquire(0) )
+		return false;
+
+	m_samples[head] = sample;
+	m_head.fetchAndStoreRelease( next );
+	return true;
+}
+
+
+bool ProbeSampleQueue::pop( ProbeSample * sample )
+{
+	const int tail = m_tail.fetchAndAddRelaxed(0);
+	if ( tail == m_head.fetchAndAddAcquire(0) )
+		return false;
+
+	*sample = m_samples[tail];
+	m_tail.fetchAndStoreRelease( (tail + 1) & m_mask );
+	return true;
+}
+//END class ProbeSampleQueue
+
+
+
+//BEGIN Writers
+/**
+Writes probe samples in one of the export formats. Samples must be passed in
+order of time.
+*/
+class ProbeDataWriter
+{
+	public:
+		virtual ~ProbeDataWriter() {}
+
+		static ProbeDataWriter * create( ProbeDataExporter::Format format, QIODevice * device );
+
+		virtual void writeHeader( const QList<ProbeInfo> & probes ) = 0;
+		virtual void writeSample( const ProbeSample & sample ) = 0;
+		/**
+		 * Notes that the given number of values were dropped from the stream
+		 * here. Only Value Change Dumps record this, as only they need every
+		 * value to show the right data.
+		 */
+		virtual void writeDropped( quint64 count ) { Q_UNUSED(count); }
+		/**
+		 * Writes whatever the format needs at the end, and flushes.
+		 */
+		virtual void writeFooter() = 0;
+};
+
+
+static QString probeName( int id )
+{
+	return QString("probe%1").arg(id);
+}
+
+
+/**
+@return the VCD timescale for the Simulator time unit of 1/LOGIC_UPDATE_RATE
+seconds.
+*/
+static QString vcdTimescale()
+{
+	const char * units[] = { "s", "ms", "us", "ns", "ps", "fs" };
+
+	uint64_t perSecond = 1; // Number of the unit in one second
+	for ( int i = 0; i < 6; ++i, perSecond *= 1000 )
+	{
+		for ( uint64_t multiple = 1; multiple <= 100; multiple *= 10 )
+		{
+			if ( perSecond == uint64_t(LOGIC_UPDATE_RATE) * multiple )
+				return QString("%1 %2").arg( quint64(multiple) ).arg( units[i] );
+		}
+	}
+
+	kWarning() << k_funcinfo << "LOGIC_UPDATE_RATE has no VCD timescale" << endl;
+	return "1 us";
+}
+
+
+class VcdWriter : public ProbeDataWriter
+{
+	public:
+		VcdWriter( QIODevice * device ) : m_stream(device), m_bHasTime(false), m_time(0), m_dropped(0) {}
+
+		virtual void writeHeader( const QList<ProbeInfo> & probes )
+		{
+			m_stream << "$date " << QDateTime::currentDateTime().toString() << " $end\n";
+			m_stream << "$version KTechLab $end\n";
+			m_stream << "$timescale " << vcdTimescale() << " $end\n";
+			m_stream << "$scope module probes $end\n";
+
+			for ( int i = 0; i < probes.size(); ++i )
+			{
+				Variable variable;
+				variable.code = identifier(i);
+				variable.isLogic = probes[i].isLogic;
+				m_variables[ probes[i].id ] = variable;
+
+				m_stream << "$var " << (variable.isLogic ? "wire 1 " : "real 64 ")
+					<< variable.code << ' ' << probeName( probes[i].id ) << " $end\n";
+			}
+
+			m_stream << "$upscope $end\n";
+			m_stream << "$enddefinitions $end\n";
+		}
+
+		virtual void writeSample( const ProbeSample & sample )
+		{
+			QHash<int, Variable>::iterator it = m_variables.find( sample.probe );
+			if ( it == m_variables.end() )
+				// From a probe that was created after the header was written
+				return;
+
+			// Only changes are dumped
+			if ( it->hasValue && it->value == sample.value )
+				return;
+			it->hasValue = true;
+			it->value = sample.value;
+
+			// Times in a VCD file may not decrease, so a sample that arrives
+			// late is dumped at the current time
+			if ( !m_bHasTime || sample.time > m_time )
+			{
+				m_bHasTime = true;
+				m_time = sample.time;
+				m_stream << '#' << quint64(m_time) << '\n';
+			}
+
+			if ( it->isLogic )
+				m_stream << (sample.value ? '1' : '0') << it->code << '\n';
+			else
+				m_stream << 'r' << QString::number( sample.value, 'g', 9 ) << ' ' << it->code << '\n';
+		}
+
+		virtual void writeDropped( quint64 count )
+		{
+			m_dropped += count;
+			m_stream << "$comment " << count << " values dropped $end\n";
+		}
+
+		virtual void writeFooter()
+		{
+			if ( m_dropped )
+				m_stream << "$comment " << m_dropped << " values dropped in total $end\n";
+			m_stream.flush();
+		}
+
+	protected:
+		class Variable
+		{
+			public:
+				Variable() : isLogic(false), hasValue(false), value(0.f) {}
+
+				QString code;
+				bool isLogic;
+				bool hasValue;
+				float value;
+		};
+
+		/**
+		 * @return the short VCD identifier for the i-th variable, made from
+		 * the printable ASCII characters.
+		 */
+		static QString identifier( int i )
+		{
+			QString code;
+			do
+			{
+				code += QChar( '!' + (i % 94) );
+				i /= 94;
+			} while ( i > 0 );
+			return code;
+		}
+
+		QTextStream m_stream;
+		QHash<int, Variable> m_variables;
+		bool m_bHasTime;
+		uint64_t m_time;
+		quint64 m_dropped;
+};
+
+
+class CsvWriter : public ProbeDataWriter
+{
+	public:
+		CsvWriter( QIODevice * device ) : m_stream(device) {}
+
+		virtual void writeHeader( const QList<ProbeInfo> & probes )
+		{
+			for ( int i = 0; i < probes.size(); ++i )
+				m_probes.insert( probes[i].id, probeName( probes[i].id ) );
+
+			m_stream << "time,probe,value\n";
+		}
+
+		virtual void writeSample( const ProbeSample & sample )
+		{
+			QHash<int, QString>::const_iterator it = m_probes.constFind( sample.probe );
+			if ( it == m_probes.constEnd() )
+				return;
+
+			// Simulator time has a resolution of 1/LOGIC_UPDATE_RATE seconds
+			m_stream << QString::number( double(sample.time) / LOGIC_UPDATE_RATE, 'f', 6 ) << ','
+				<< it.value() << ','
+				<< QString::number( sample.value, 'g', 9 ) << '\n';
+		}
+
+		virtual void writeFooter()
+		{
+			m_stream.flush();
+		}
+
+	protected:
+		QTextStream m_stream;
+		QHash<int, QString> m_probes;
+};
+
+
+/**
+Little endian. The header is the magic "KTLPROBE", then the quint32 format
+version, the quint32 number of Simulator time units per second, the quint32
+number of probes and for each probe its qint32 id and a quint8 that is 1 for
+logic probes. Then the samples follow, each as its quint64 Simulator time,
+qint32 probe id and 32-bit float value.
+*/
+class BinaryWriter : public ProbeDataWriter
+{
+	public:
+		BinaryWriter( QIODevice * device ) : m_stream(device)
+		{
+			m_stream.setByteOrder( QDataStream::LittleEndian );
+			m_stream.setFloatingPointPrecision( QDataStream::SinglePrecision );
+		}
+
+		virtual void writeHeader( const QList<ProbeInfo> & probes )
+		{
+			m_stream.writeRawData( "KTLPROBE", 8 );
+			m_stream << quint32(1) << quint32(LOGIC_UPDATE_RATE) << quint32( probes.size() );
+
+			for ( int i = 0; i < probes.size(); ++i )
+			{
+				m_probes.insert( probes[i].id );
+				m_stream << qint32( probes[i].id ) << quint8( probes[i].isLogic ? 1 : 0 );
+			}
+		}
+
+		virtual void writeSample( const ProbeSample & sample )
+		{
+			if ( !m_probes.contains( sample.probe ) )
+				return;
+
+			m_stream << quint64( sample.time ) << qint32( sample.probe ) << sample.value;
+		}
+
+		virtual void writeFooter()
+		{
+			// QDataStream writes straight to the device
+		}
+
+	protected:
+		QDataStream m_stream;
+		QSet<int> m_probes;
+};
+
+
+ProbeDataWriter * ProbeDataWriter::create( ProbeDataExporter::Format format, QIODevice * device )
+{
+	switch ( format )
+	{
+		case ProbeDataExporter::Vcd:
+			return new VcdWriter( device );
+		case ProbeDataExporter::Csv:
+			return new CsvWriter( device );
+		case ProbeDataExporter::Binary:
+			return new BinaryWriter( device );
+	}
+	return 0l;
+}
+//END Writers
+
+
+
+//BEGIN class ProbeDataWriterThread
+/**
+Drains the sample queue of a stream into its file.
+*/
+class ProbeDataWriterThread : public QThread
+{
+	public:
+		/**
+		 * Takes ownership of the file and writer.
+		 */
+		ProbeDataWriterThread( QFile * file, ProbeDataWriter * writer )
+			: m_queue( QUEUE_CAPACITY ), m_stop(0), m_pFile(file), m_pWriter(writer) {}
+
+		~ProbeDataWriterThread()
+		{
+			delete m_pWriter;
+			delete m_pFile;
+		}
+
+		ProbeSampleQueue & queue() { return m_queue; }
+		/**
+		 * Writes what is left in the queue, finishes the file, and returns
+		 * once the thread has finished.
+		 */
+		void stop()
+		{
+			m_stop.fetchAndStoreRelease(1);
+			wait();
+		}
+
+	protected:
+		virtual void run()
+		{
+			ProbeSample sample;
+			while (true)
+			{
+				// Check for stop before draining, so that all the samples that
+				// were queued before stop was called get written
+				const bool stopping = m_stop.fetchAndAddAcquire(0);
+
+				bool wrote = false;
+				while ( m_queue.pop( &sample ) )
+				{
+					if ( sample.probe == ProbeSample::DroppedMarker )
+						m_pWriter->writeDropped( quint64( sample.value ) );
+					else
+						m_pWriter->writeSample( sample );
+					wrote = true;
+				}
+
+				if (stopping)
+					break;
+
+				if (!wrote)
+					msleep( WRITER_IDLE_MS );
+			}
+
+			m_pWriter->writeFooter();
+			m_pFile->flush();
+		}
+
+		ProbeSampleQueue m_queue;
+		QAtomicInt m_stop;
+		QFile * m_pFile;
+		ProbeDataWriter * m_pWriter;
+};
+//END class ProbeDataWriterThread
+
+
+
+//BEGIN class ProbeDataExporter
+bool ProbeDataExporter::s_bStreaming = false;
+
+
+ProbeDataExporter * ProbeDataExporter::self()
+{
+	static ProbeDataExporter exporter;
+	return &exporter;
+}
+
+
+ProbeDataExporter::ProbeDataExporter()
+{
+	m_pWriterThread = 0l;
+	m_droppedSamples = 0;
+	m_unmarkedDrops = 0;
+	m_lastTime = 0;
+}
+
+
+ProbeDataExporter::~ProbeDataExporter()
+{
+	stopStreaming();
+}
+
+
+ProbeDataExporter::Format ProbeDataExporter::formatForFile( const QString & path )
+{
+	if ( path.endsWith( ".vcd", Qt::CaseInsensitive ) )
+		return Vcd;
+	if ( path.endsWith( ".ktlprobe", Qt::CaseInsensitive ) )
+		return Binary;
+	return Csv;
+}
+
+
+QString ProbeDataExporter::fileFilter()
+{
+	return QString("*.vcd|%1\n*.csv|%2\n*.ktlprobe|%3")
+		.arg( i18n("Value Change Dump (*.vcd)") )
+		.arg( i18n("Comma Separated Values (*.csv)") )
+		.arg( i18n("KTechLab Probe Data (*.ktlprobe)") );
+}
+
+
+static QList<ProbeInfo> probeInfo( const QList<ProbeData*> & probes )
+{
+	QList<ProbeInfo> info;
+
+	const QList<ProbeData*>::const_iterator end = probes.end();
+	for ( QList<ProbeData*>::const_iterator it = probes.begin(); it != end; ++it )
+		info << ProbeInfo( (*it)->id(), dynamic_cast<LogicProbeData*>(*it) != 0l );
+
+	return info;
+}
+
+
+static bool sampleTimeLessThan( const ProbeSample & a, const ProbeSample & b )
+{
+	return a.time < b.time;
+}
+
+
+bool ProbeDataExporter::exportData( const QList<ProbeData*> & probes, const QString & path, Format format ) const
+{
+	QFile file( path );
+	if ( !file.open( QIODevice::WriteOnly ) )
+		return false;
+
+	// Merge the data of all probes into time order
+	std::vector<ProbeSample> samples;
+
+	const QList<ProbeData*>::const_iterator end = probes.end();
+	for ( QList<ProbeData*>::const_iterator it = probes.begin(); it != end; ++it )
+	{
+		if ( LogicProbeData * logicData = dynamic_cast<LogicProbeData*>(*it) )
+		{
+			const std::vector<LogicDataPoint> & data = *logicData->m_data;
+			for ( size_t i = 0; i < data.size(); ++i )
+				samples.push_back( ProbeSample( data[i].time, logicData->id(), data[i].value ? 1.f : 0.f ) );
+		}
+		else if ( FloatingProbeData * floatingData = dynamic_cast<FloatingProbeData*>(*it) )
+		{
+			const std::vector<float> & data = *floatingData->m_data;
+			for ( size_t i = 0; i < data.size(); ++i )
+				samples.push_back( ProbeSample( floatingData->toTime(i), floatingData->id(), data[i] ) );
+		}
+	}
+
+	std::stable_sort( samples.begin(), samples.end(), sampleTimeLessThan );
+
+	ProbeDataWriter * writer = ProbeDataWriter::create( format, &file );
+	writer->writeHeader( probeInfo( probes ) );
+	for ( size_t i = 0; i < samples.size(); ++i )
+		writer->writeSample( samples[i] );
+	writer->writeFooter();
+	delete writer;
+
+	file.close();
+	return true;
+}
+
+
+bool ProbeDataExporter::startStreaming( const QList<ProbeData*> & probes, const QString & path, Format format )
+{
+	stopStreaming();
+
+	QFile * file = new QFile( path );
+	if ( !file->open( QIODevice::WriteOnly ) )
+	{
+		delete file;
+		return false;
+	}
+
+	ProbeDataWriter * writer = ProbeDataWriter::create( format, file );
+	writer->writeHeader( probeInfo( probes ) );
+
+	m_droppedSamples = 0;
+	m_unmarkedDrops = 0;
+	m_pendingSamples.clear();
+	m_pWriterThread = new ProbeDataWriterThread( file, writer );
+	m_pWriterThread->start( QThread::LowPriority );
+	s_bStreaming = true;
+	return true;
+}
+
+
+void ProbeDataExporter::stopStreaming()
+{
+	if (!m_pWriterThread)
+		return;
+
+	s_bStreaming = false;
+
+	// The writer is still draining the queue, so this makes room eventually
+	while ( !queuePending( m_lastTime ) )
+		QThread::yieldCurrentThread();
+
+	m_pWriterThread->stop();
+	delete m_pWriterThread;
+	m_pWriterThread = 0l;
+}
+
+
+void ProbeDataExporter::addSample( int probe, uint64_t time, float value )
+{
+	if ( !m_pWriterThread )
+	{
+		m_droppedSamples++;
+		return;
+	}
+
+	m_lastTime = time;
+	const ProbeSample sample( time, probe, value );
+
+	// A value that was kept back is lost once the probe has a newer one
+	QHash<int, ProbeSample>::iterator pending = m_pendingSamples.find( probe );
+	if ( pending != m_pendingSamples.end() )
+	{
+		m_pendingSamples.erase( pending );
+		m_droppedSamples++;
+		m_unmarkedDrops++;
+	}
+
+	// Everything kept back has to be queued first, to keep the order
+	if ( queuePending( time ) && m_pWriterThread->queue().push( sample ) )
+		return;
+
+	m_pendingSamples.insert( probe, sample );
+}
+
+
+bool ProbeDataExporter::queuePending( uint64_t time )
+{
+	ProbeSampleQueue & queue = m_pWriterThread->queue();
+
+	if ( m_unmarkedDrops )
+	{
+		if ( !queue.push( ProbeSample( time, ProbeSample::DroppedMarker, float( m_unmarkedDrops ) ) ) )
+			return false;
+		m_unmarkedDrops = 0;
+	}
+
+	QHash<int, ProbeSample>::iterator it = m_pendingSamples.begin();
+	while ( it != m_pendingSamples.end() )
+	{
+		if ( !queue.push( it.value() ) )
+			return false;
+		it = m_pendingSamples.erase( it );
+	}
+
+	return true;
+}
+//END class ProbeDataExporter
@@ -0,0 +1,188 @@
+/***************************************************************************
+ *   Copyright (C) 2026 by the KTechLab developers                         *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ ***************************************************************************/
+
+#ifndef PROBEDATAEXPORTER_H
+#define PROBEDATAEXPORTER_H
+
+#include <qatomic.h>
+#include <qhash.h>
+#include <qlist.h>
+#include <qstring.h>
+
+#include <stdint.h>
+#include <vector>
+
+class ProbeData;
+class ProbeDataWriterThread;
+
+/**
+One value recorded by a probe, as passed from the simulation to the writer.
+Logic probes record 0 or 1.
+*/
+class ProbeSample
+{
+	public:
+		ProbeSample() : time(0), probe(0), value(0.f) {}
+		ProbeSample( uint64_t t, int p, float v ) : time(t), probe(p), value(v) {}
+
+		/**
+		 * Probe of the samples that mark where values were dropped from a
+		 * stream; their value is the number dropped since the last marker.
+		 */
+		static const int DroppedMarker = -1;
+
+		uint64_t time;
+		int probe;
+		float value;
+};
+
+
+/**
+Describes a probe to the writers, which cannot look at the ProbeData itself
+from the writer thread.
+*/
+class ProbeInfo
+{
+	public:
+		ProbeInfo() : id(0), isLogic(false) {}
+		ProbeInfo( int i, bool logic ) : id(i), isLogic(logic) {}
+
+		int id;
+		bool isLogic;
+};
+
+
+/**
+Queue of fixed capacity between exactly one producer thread and one consumer
+thread. Neither side ever waits for the other: push fails when the queue is
+full, and pop fails when it is empty.
+*/
+class ProbeSampleQueue
+{
+	public:
+		/**
+		 * @param capacity is rounded up to a power of two
+		 */
+		ProbeSampleQueue( int capacity );
+
+		/**
+		 * Called from the producer thread only.
+		 * @return false if the queue is full
+		 */
+		bool push( const ProbeSample & sample );
+		/**
+		 * Called from the consumer thread only.
+		 * @return false if the queue is empty
+		 */
+		bool pop( ProbeSample * sample );
+
+	protected:
+		std::vector<ProbeSample> m_samples;
+		int m_mask;
+		QAtomicInt m_head; // Next slot to write to; only changed by the producer
+		QAtomicInt m_tail; // Next slot to read from; only changed by the consumer
+};
+
+
+/**
+Writes the data recorded by probes to files, either once from what the probes
+currently hold, or continuously while the simulation runs. Logic probes are
+written to Value Change Dump files as wires and floating probes as reals; CSV
+and the binary format hold both kinds.
+
+While streaming, the probes pass every value to addSample. The values are
+queued without locking and written to disk by a separate thread, so the
+simulation never waits for the disk, and the data is neither limited by
+MAX_PROBE_DATA_SIZE nor lost when the oscilloscope is reset.
+
+If the writer falls behind, values are dropped and counted rather than
+blocking the simulation. The latest value of each probe is kept back and
+queued once there is room again, so that a file only lacks the values in
+between, rather than e.g. a Value Change Dump showing the wrong level from
+then on. Value Change Dumps note the number of values dropped in a $comment
+where they were dropped.
+*/
+class ProbeDataExporter
+{
+	public:
+		static ProbeDataExporter * self();
+		~ProbeDataExporter();
+
+		enum Format
+		{
+			Vcd,	///< Value Change Dump (*.vcd)
+			Csv,	///< Comma separated values (*.csv)
+			Binary	///< Binary records (*.ktlprobe)
+		};
+
+		/**
+		 * @return the format to use for the given file name, from its
+		 * extension. Defaults to Csv.
+		 */
+		static Format formatForFile( const QString & path );
+		/**
+		 * @return the filter for file dialogs listing the supported formats.
+		 */
+		static QString fileFilter();
+
+		/**
+		 * Writes the data that the probes currently hold to the file.
+		 * @return whether successful
+		 */
+		bool exportData( const QList<ProbeData*> & probes, const QString & path, Format format ) const;
+		/**
+		 * Starts writing every value subsequently recorded by the given probes
+		 * to the file, until stopStreaming is called. Any stream already
+		 * running is stopped first.
+		 * @return whether the file could be opened
+		 */
+		bool startStreaming( const QList<ProbeData*> & probes, const QString & path, Format format );
+		/**
+		 * Stops streaming, and waits for the queued values to be written.
+		 */
+		void stopStreaming();
+		/**
+		 * @return whether a stream is running. The probes check this (a single
+		 * static flag) before calling addSample.
+		 */
+		static bool isStreaming() { return s_bStreaming; }
+		/**
+		 * Queues the value for the stream. Called from the simulation; never
+		 * blocks.
+		 */
+		void addSample( int probe, uint64_t time, float value );
+		/**
+		 * @return the number of values that were dropped since streaming was
+		 * started, because the writer could not keep up.
+		 */
+		quint64 droppedSamples() const { return m_droppedSamples; }
+
+	protected:
+		ProbeDataExporter();
+
+		/**
+		 * Queues the marker for the values dropped since the last one, and
+		 * the values that were kept back.
+		 * @return false if the queue filled up before everything was queued
+		 */
+		bool queuePending( uint64_t time );
+
+		static bool s_bStreaming;
+
+		ProbeDataWriterThread * m_pWriterThread;
+		quint64 m_droppedSamples;
+		/// Dropped values that have not been marked in the stream yet
+		quint64 m_unmarkedDrops;
+		/// The latest value of each probe that could not be queued
+		QHash<int, ProbeSample> m_pendingSamples;
+		/// Time of the latest value passed to addSample
+		uint64_t m_lastTime;
+};
+
+#endif
@@ -512,10 +512,15 @@ bool ProjectItem::build( ProcessOptionsList * pol )
 	po.m_linkerScript = linkerScript();
 	po.m_linkOther = linkerOther();
 	
-	// Link against libraries	
+	// Link against libraries. Internal libraries are named by the target
+	// file of their own build entry, which ProcessListChain relies on to
+	// build them first.
 	QStringList::iterator lend = m_linkedInternal.end();
 	for ( QStringList::iterator it = m_linkedInternal.begin(); it != lend; ++it )
-		po.m_linkLibraries += projectInfo->directory() + *it;
+	{
+		ProjectItem * lib = projectInfo->findItem( projectInfo->directory() + *it );
+		po.m_linkLibraries += lib ? lib->outputURL().path() : projectInfo->directory() + *it;
+	}
 	lend = m_linkedExternal.end();
 	for ( QStringList::iterator it = m_linkedExternal.begin(); it != lend; ++it )
 		po.m_linkLibraries += *it;
@@ -11,6 +11,7 @@
 #include "component.h"
 #include "gpsimprocessor.h"
 #include "pin.h"
+#include "simulationprofiler.h"
 #include "simulator.h"
 #include "switch.h"
 
@@ -64,6 +65,8 @@ Simulator::Simulator()
 	m_pChangedCircuitStart = new Circuit;
 	m_pChangedCircuitLast  = m_pChangedCircuitStart;
 
+	m_pChangedGates = 0;
+
 	m_stepTimer = new QTimer(this);
 	connect(m_stepTimer, SIGNAL(timeout()), this, SLOT(step()));
 
@@ -88,6 +91,14 @@ long long Simulator::time() const {
 void Simulator::step() {
 	if (!m_bIsSimulating) return;
 
+	// Profiling is opt-in; when disabled, this is the only extra work apart
+	// from a branch for each section below.
+	const bool profiling = SimulationProfiler::isEnabled();
+	SimulationProfiler *profiler = profiling ? SimulationProfiler::self() : 0;
+	const qint64 stepStart = profiling ? profiler->timestamp() : 0;
+	const long long firstStepNumber = m_stepNumber;
+	qint64 sectionStart = 0;
+
 	// We are called a thousand times a second (the maximum allowed by QTimer),
 	// so divide the LINEAR_UPDATE_RATE by 1e3 for the number of loops we need
 	// to do.
@@ -96,22 +107,42 @@ void Simulator::step() {
 	for (unsigned i = 0; i < maxSteps; ++i) {
         // here starts 1 linear step
 		m_stepNumber++;
+		// Otherwise time() would be a step ahead until the logic loop below
+		m_llNumber = 0;
 
 		// Update the non-logic parts of the simulation
 		{
+			if (profiling) sectionStart = profiler->timestamp();
+
 			list<Component*>::iterator components_end = m_components->end();
 
 			for (list<Component*>::iterator component = m_components->begin(); component != components_end; component++) {
-				(*component)->stepNonLogic();
+				if (profiling) {
+					qint64 start = profiler->timestamp();
+					(*component)->stepNonLogic();
+					profiler->addComponentTime((*component)->type(), start);
+				} else
+					(*component)->stepNonLogic();
 			}
+
+			if (profiling) profiler->addSectionTime(SimulationProfiler::ComponentStepNonLogic, sectionStart);
 		}
 
 		{
+			if (profiling) sectionStart = profiler->timestamp();
+
 			list<Circuit*>::iterator circuits_end = m_ordinaryCircuits->end();
 
 			for (list<Circuit*>::iterator circuit = m_ordinaryCircuits->begin(); circuit != circuits_end; circuit++) {
-				(*circuit)->doNonLogic();
+				if (profiling) {
+					qint64 start = profiler->timestamp();
+					(*circuit)->doNonLogic();
+					profiler->addCircuitTime(*circuit, (*circuit)->cnodeCount(), (*circuit)->branchCount(), start);
+				} else
+					(*circuit)->doNonLogic();
 			}
+
+			if (profiling) profiler->addSectionTime(SimulationProfiler::CircuitNonLogic, sectionStart);
 		}
 
 		// Update the logic parts of our simulation
@@ -121,6 +152,8 @@ void Simulator::step() {
             // here starts 1 logic update
 			// Update the logic components
 			{
+				if (profiling) sectionStart = profiler->timestamp();
+
 				list<ComponentCallback>::iterator callbacks_end = m_componentCallbacks->end();
 
 				for (list<ComponentCallback>::iterator callback = m_componentCallbacks->begin(); callback != callbacks_end; callback++) {
@@ -140,14 +173,20 @@ void Simulator::step() {
 			delete m_pStartStepCallback[m_llNumber];
 			m_pStartStepCallback[m_llNumber] = 0;
 
+			if (profiling) profiler->addSectionTime(SimulationProfiler::LogicCallbacks, sectionStart);
+
 #ifndef NO_GPSIM
 			// Update the gpsim processors
 			{
+				if (profiling) sectionStart = profiler->timestamp();
+
 				list<GpsimProcessor*>::iterator processors_end = m_gpsimProcessors->end();
 
 				for (list<GpsimProcessor*>::iterator processor = m_gpsimProcessors->begin(); processor != processors_end; processor++) {
 					(*processor)->executeNext();
 				}
+
+				if (profiling) profiler->addSectionTime(SimulationProfiler::GpsimExecution, sectionStart);
 			}
 #endif
 
@@ -157,6 +196,8 @@ void Simulator::step() {
 
 			// Update the non-logic circuits
 			if (Circuit *changed = m_pChangedCircuitStart->nextChanged(prevChain)) {
+				if (profiling) sectionStart = profiler->timestamp();
+
                 QSet<Circuit*> canAddChangedSet;
 				for (   Circuit *circuit = changed;
                         circuit && (!canAddChangedSet.contains(circuit));
@@ -174,10 +215,14 @@ void Simulator::step() {
 					changed->doLogic();
 					changed = next;
 				} while (changed);
+
+				if (profiling) profiler->addSectionTime(SimulationProfiler::CircuitLogic, sectionStart);
 			}
 
 			// Call the logic callbacks
 			if (LogicOut *changed = m_pChangedLogicStart->nextChanged(prevChain)) {
+				if (profiling) sectionStart = profiler->timestamp();
+
 				for (LogicOut *out = changed; out; out = out->nextChanged(prevChain))
 					out->setCanAddChanged(true);
 
@@ -204,9 +249,48 @@ void Simulator::step() {
 
 					changed = next;
 				} while (changed);
+
+				if (profiling) profiler->addSectionTime(SimulationProfiler::LogicChains, sectionStart);
+			}
+
+			// Evaluate the compiled gates whose inputs changed above
+			if (m_pChangedGates) {
+				if (profiling) sectionStart = profiler->timestamp();
+
+				while (LogicGate *gate = m_pChangedGates) {
+					m_pChangedGates = gate->nextChanged();
+					gate->setNextChanged(0);
+					gate->evaluate();
+				}
+
+				if (profiling) profiler->addSectionTime(SimulationProfiler::LogicGates, sectionStart);
+			}
+
+			// Evaluate the multi-bit inputs that changed, now that all of
+			// their bits have settled for this update
+			if (!m_changedBuses.isEmpty()) {
+				if (profiling) sectionStart = profiler->timestamp();
+
+				while (!m_changedBuses.isEmpty())
+					m_changedBuses.takeFirst()->settle();
+
+				if (profiling) profiler->addSectionTime(SimulationProfiler::LogicBuses, sectionStart);
 			}
 		}
 	}
+
+	if (profiling)
+		profiler->addSimulatorStep(qint64(m_stepNumber - firstStepNumber) * (1000000000 / LINEAR_UPDATE_RATE), stepStart);
+}
+
+void Simulator::runSteps(int count) {
+	const bool wasSimulating = m_bIsSimulating;
+	m_bIsSimulating = true;
+
+	for (int i = 0; i < count; ++i)
+		step();
+
+	m_bIsSimulating = wasSimulating;
 }
 
 void Simulator::slotSetSimulating(bool simulate) {
@@ -308,6 +392,22 @@ void Simulator::attachCircuit(Circuit *circuit) {
 //	}
 }
 
+void Simulator::removeChangedGate(LogicGate *gate) {
+	if (m_pChangedGates == gate) {
+		m_pChangedGates = gate->nextChanged();
+		gate->setNextChanged(0);
+		return;
+	}
+
+	for (LogicGate *previous = m_pChangedGates; previous; previous = previous->nextChanged()) {
+		if (previous->nextChanged() == gate) {
+			previous->setNextChanged(gate->nextChanged());
+			gate->setNextChanged(0);
+			return;
+		}
+	}
+}
+
 void Simulator::removeLogicInReferences(LogicIn *logicIn) {
 	if (!logicIn) return;
 
@@ -358,6 +458,7 @@ void Simulator::detachCircuit(Circuit *circuit) {
 	if (!circuit) return;
 
 	m_ordinaryCircuits->remove(circuit);
+	SimulationProfiler::self()->removeCircuit(circuit);
 
 	// Any changes to the code below will probably also apply to Simulator::removeLogicOutReferences
 
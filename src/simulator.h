@@ -126,6 +126,31 @@ public:
 	 * currently marked as changed.
 	 */
 	void removeLogicInReferences(LogicIn *logic);
+	/**
+	 * Queues the given LogicGate to be evaluated at the end of the current
+	 * logic update.
+	 */
+	void addChangedGate(LogicGate *gate) {
+		gate->setNextChanged(m_pChangedGates);
+		m_pChangedGates = gate;
+	}
+	/**
+	 * Removes the given LogicGate from the queue, called when it is deleted.
+	 */
+	void removeChangedGate(LogicGate *gate);
+	/**
+	 * Queues the given LogicBus to be settled at the end of the current
+	 * logic update, once all of its inputs have changed.
+	 */
+	void addChangedBus(LogicBus *bus) {
+		m_changedBuses << bus;
+	}
+	/**
+	 * Removes the given LogicBus from the queue, called when it is deleted.
+	 */
+	void removeChangedBus(LogicBus *bus) {
+		m_changedBuses.removeAll(bus);
+	}
 	/**
 	 * Adds the given Circuit to the list of changed Circuits
 	 */
@@ -187,6 +212,13 @@ public:
 	bool isSimulating() const {
 		return m_bIsSimulating;
 	}
+	/**
+	 * Runs the given number of steps straight away, as if the step timer had
+	 * fired that many times, whether or not we are simulating. This is for
+	 * driving the simulation independently of the event loop, e.g. from a
+	 * benchmark; use slotSetSimulating(false) to stop the timer first.
+	 */
+	void runSteps(int count);
 
 signals:
 	/**
@@ -232,6 +264,12 @@ private:
 	LogicOut *m_pChangedLogicStart;
 	LogicOut *m_pChangedLogicLast;
 
+	///LogicGates with inputs that changed in the current logic update
+	LogicGate *m_pChangedGates;
+
+	///LogicBuses with inputs that changed in the current logic update
+	QList<LogicBus*> m_changedBuses;
+
 public:
 	Simulator();
 private:
@@ -33,6 +33,7 @@ Variant::Variant( const QString & id, Type::Value type )
 		m_defaultValue = "#f62a2a";
 		m_value = "#f62a2a";
 	}
+	updateConvertedValues();
 }
 
 
@@ -86,6 +87,14 @@ void Variant::setMaxValue( double value )
 	}
 }
 
+void Variant::updateConvertedValues()
+{
+	m_doubleValue = m_value.toDouble();
+	m_intValue = m_value.toInt();
+	m_boolValue = m_value.toBool();
+}
+
+
 QString Variant::displayString() const
 {
 	switch(type())
@@ -142,6 +151,7 @@ void Variant::setValue( QVariant val )
 	
 	const QVariant old = m_value;
 	m_value = val;
+	updateConvertedValues();
 	emit( valueChanged( val, old ) );
 	
 	switch ( type() )
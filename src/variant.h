@@ -161,6 +161,14 @@ public:
 	bool changed() const;
 	QVariant value() const { return m_value; }
 	void setValue( QVariant val );
+	/**
+	 * The value converted to a double, int or bool. These are converted once
+	 * when the value is set rather than on every call, so they are cheap to
+	 * use from code that reads the value often.
+	 */
+	double toDouble() const { return m_doubleValue; }
+	int toInt() const { return m_intValue; }
+	bool toBool() const { return m_boolValue; }
 	
 signals:
 	/**
@@ -198,7 +206,15 @@ signals:
 	void valueChanged( bool newValue );
 
 private:
+	/**
+	 * Updates the converted values from m_value.
+	 */
+	void updateConvertedValues();
+	
 	QVariant m_value; // the actual data
+	double m_doubleValue;
+	int m_intValue;
+	bool m_boolValue;
 	QVariant m_defaultValue;
 	QString m_unit;
 	const QString m_id;
@@ -0,0 +1,504 @@
+/*
+ * KTechLab: An IDE for microcontrollers and electronics
+ * Copyright 2026  The KTechLab developers
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of
+ * the License or (at your option) version 3 or any later version
+ * accepted by the membership of KDE e.V. (or its successor approved
+ * by the membership of KDE e.V.), which shall act as a proxy
+ * defined in Section 14 of version 3 of the license.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+/*
+ * Simulation benchmarks.
+ *
+ * Every circuit in examples/ and a set of generated, scaled circuits (RC
+ * ladders, LED matrices and counters) are loaded and simulated for a fixed
+ * number of Simulator::step() calls, driven directly rather than by the
+ * simulator timer so that runs are repeatable.
+ *
+ * Environment variables:
+ *   KTL_BENCHMARK_STEPS      number of Simulator::step() calls (default 200)
+ *   KTL_BENCHMARK_OUTPUT     file to write the results to; setting this
+ *                            records a new baseline, so benchmarks missing
+ *                            from the current one do not fail
+ *   KTL_BENCHMARK_BASELINE   results of an earlier run to compare against
+ *                            (default: tests/data/benchmark-baseline.tsv)
+ *   KTL_BENCHMARK_TOLERANCE  allowed relative regression (default 0.2)
+ *
+ * Results are tab-separated, one benchmark per line, in the same format as
+ * the baseline; so the output of one run can be used as the baseline for the
+ * next. The results table is the only output. Unless recording, a benchmark
+ * that is missing from the baseline fails.
+ */
+
+#include "../src/ktechlab.h"
+#include "config.h"
+#include "docmanager.h"
+#include "electronics/circuitdocument.h"
+#include "simulationprofiler.h"
+#include "simulator.h"
+
+#include <kaboutdata.h>
+#include <kapplication.h>
+#include <kcmdlineargs.h>
+#include <klocalizedstring.h>
+#include <ktempdir.h>
+
+#include <qdebug.h>
+#include <qdir.h>
+#include <qdiriterator.h>
+#include <qelapsedtimer.h>
+#include <qfile.h>
+#include <qmap.h>
+#include <qtest.h>
+#include <qtextstream.h>
+#include <qtimer.h>
+
+#include <unistd.h>
+
+static const char description[] =
+    I18N_NOOP("An IDE for microcontrollers and electronics");
+
+static const char resultHeader[] =
+    "# name\tsteps\tsteps_per_second\tnewton_iterations\tlu_decompositions\tmemory_kb";
+
+
+/**
+ * Writes a circuit document. Connections between pins go through junction
+ * nodes where more than two pins meet, like the documents saved by KTechLab.
+ */
+class CircuitWriter {
+public:
+    CircuitWriter() : m_connectorCount(0) {}
+
+    void addItem(const QString &type, const QString &id, int x, int y, const QString &data = QString()) {
+        m_body += QString(" <item x=\"%1\" y=\"%2\" z=\"0\" type=\"%3\" id=\"%4\" flip=\"0\" angle=\"0\" >\n")
+            .arg(x).arg(y).arg(type).arg(id);
+        m_body += data;
+        m_body += " </item>\n";
+    }
+
+    static QString numberData(const QString &id, double value) {
+        return QString("  <data value=\"%1\" type=\"number\" id=\"%2\" />\n").arg(value).arg(id);
+    }
+
+    void addNode(const QString &id, int x, int y) {
+        m_body += QString(" <node x=\"%1\" y=\"%2\" id=\"%3\" />\n").arg(x).arg(y).arg(id);
+    }
+
+    void connectPins(const QString &parent1, const QString &cid1, const QString &parent2, const QString &cid2) {
+        m_body += QString(" <connector start-node-is-child=\"1\" manual-route=\"0\" start-node-parent=\"%1\" start-node-cid=\"%2\""
+                          " end-node-is-child=\"1\" end-node-parent=\"%3\" end-node-cid=\"%4\" route=\"\" id=\"%5\" />\n")
+            .arg(parent1).arg(cid1).arg(parent2).arg(cid2).arg(nextConnectorId());
+    }
+
+    void connectPinToNode(const QString &parent, const QString &cid, const QString &node) {
+        m_body += QString(" <connector start-node-is-child=\"1\" manual-route=\"0\" start-node-parent=\"%1\" start-node-cid=\"%2\""
+                          " end-node-is-child=\"0\" end-node-id=\"%3\" route=\"\" id=\"%4\" />\n")
+            .arg(parent).arg(cid).arg(node).arg(nextConnectorId());
+    }
+
+    QString toString() const {
+        return "<!DOCTYPE KTechlab>\n<document type=\"circuit\" >\n" + m_body + "</document>\n";
+    }
+
+    bool save(const QString &fileName) const {
+        QFile file(fileName);
+        if (!file.open(QIODevice::WriteOnly)) {
+            return false;
+        }
+        QTextStream stream(&file);
+        stream << toString();
+        return true;
+    }
+
+private:
+    QString nextConnectorId() {
+        return QString("connector__%1").arg(m_connectorCount++);
+    }
+
+    QString m_body;
+    int m_connectorCount;
+};
+
+
+/** A 5V source driving N series resistors, each followed by a capacitor to ground. */
+static CircuitWriter rcLadder(int stages) {
+    CircuitWriter w;
+    w.addItem("ec/fixed_voltage", "source", 0, 0, CircuitWriter::numberData("voltage", 5));
+    QString prevParent = "source";
+    QString prevNode;
+    for (int i = 0; i < stages; ++i) {
+        QString r = QString("r%1").arg(i);
+        QString c = QString("c%1").arg(i);
+        QString g = QString("g%1").arg(i);
+        QString n = QString("n%1").arg(i);
+        int x = 64 + 64 * i;
+        w.addItem("ec/resistor", r, x, 0, CircuitWriter::numberData("resistance", 1000));
+        w.addItem("ec/capacitor", c, x + 32, 48, CircuitWriter::numberData("Capacitance", 1e-6));
+        w.addItem("ec/ground", g, x + 32, 96);
+        w.addNode(n, x + 32, 0);
+        if (prevNode.isEmpty()) {
+            w.connectPins(prevParent, "p1", r, "p1");
+        } else {
+            w.connectPinToNode(r, "p1", prevNode);
+        }
+        w.connectPinToNode(r, "n1", n);
+        w.connectPinToNode(c, "p1", n);
+        w.connectPins(c, "n1", g, "p1");
+        prevNode = n;
+    }
+    return w;
+}
+
+/** Rows driven through resistors from 5V, columns grounded, an LED at every crossing. */
+static CircuitWriter ledMatrix(int rows, int columns) {
+    CircuitWriter w;
+    for (int i = 0; i < rows; ++i) {
+        QString v = QString("v%1").arg(i);
+        QString r = QString("r%1").arg(i);
+        QString row = QString("row%1").arg(i);
+        w.addItem("ec/fixed_voltage", v, 0, 64 * i, CircuitWriter::numberData("voltage", 5));
+        w.addItem("ec/resistor", r, 48, 64 * i, CircuitWriter::numberData("resistance", 220));
+        w.addNode(row, 96, 64 * i);
+        w.connectPins(v, "p1", r, "p1");
+        w.connectPinToNode(r, "n1", row);
+    }
+    for (int j = 0; j < columns; ++j) {
+        QString g = QString("g%1").arg(j);
+        QString column = QString("column%1").arg(j);
+        w.addItem("ec/ground", g, 128 + 64 * j, 64 * rows);
+        w.addNode(column, 128 + 64 * j, 64 * rows - 32);
+        w.connectPinToNode(g, "p1", column);
+    }
+    for (int i = 0; i < rows; ++i) {
+        for (int j = 0; j < columns; ++j) {
+            QString led = QString("led%1_%2").arg(i).arg(j);
+            w.addItem("ec/led", led, 128 + 64 * j, 64 * i + 32);
+            w.connectPinToNode(led, "n1", QString("row%1").arg(i));
+            w.connectPinToNode(led, "p1", QString("column%1").arg(j));
+        }
+    }
+    return w;
+}
+
+/** A clock driving a ripple counter of D flip-flops, each wired to toggle. */
+static CircuitWriter rippleCounter(int bits) {
+    CircuitWriter w;
+    w.addItem("ec/clock_input", "clock", 0, 0);
+    QString prevParent = "clock";
+    QString prevCid = "p1";
+    for (int i = 0; i < bits; ++i) {
+        QString ff = QString("ff%1").arg(i);
+        QString qbar = QString("qbar%1").arg(i);
+        w.addItem("ec/d_flipflop", ff, 96 + 96 * i, 0);
+        w.addNode(qbar, 144 + 96 * i, 48);
+        w.connectPins(prevParent, prevCid, ff, "n2");
+        w.connectPinToNode(ff, "p2", qbar);
+        w.connectPinToNode(ff, "n1", qbar);
+        prevParent = ff;
+        prevCid = "p1";
+    }
+    return w;
+}
+
+/** A clock driving cascaded 8-bit binary counters, enabled from a 5V source. */
+static CircuitWriter binaryCounter(int bits) {
+    const int bitsPerCounter = 8;
+    CircuitWriter w;
+    w.addItem("ec/clock_input", "clock", 0, 0);
+    w.addItem("ec/fixed_voltage", "enable", 0, 96, CircuitWriter::numberData("voltage", 5));
+    w.addNode("en", 48, 96);
+    w.connectPinToNode("enable", "p1", "en");
+    QString prevParent = "clock";
+    QString prevCid = "p1";
+    for (int i = 0; bits > 0; ++i) {
+        int counterBits = qMin(bits, bitsPerCounter);
+        bits -= counterBits;
+        QString counter = QString("counter%1").arg(i);
+        w.addItem("ec/binary_counter", counter, 96 + 128 * i, 0,
+                  QString("  <data value=\"%1\" type=\"number\" id=\"bitcount\" />\n").arg(counterBits));
+        w.connectPins(prevParent, prevCid, counter, ">");
+        w.connectPinToNode(counter, "en", "en");
+        w.connectPinToNode(counter, "u/d", "en");
+        prevParent = counter;
+        prevCid = QChar('A' + counterBits - 1);
+    }
+    return w;
+}
+
+
+class BenchmarkResult {
+public:
+    BenchmarkResult() : steps(0), stepsPerSecond(0.0), newtonIterations(0), luDecompositions(0), memoryKb(0) {}
+
+    QString toLine(const QString &name) const {
+        return QString("%1\t%2\t%3\t%4\t%5\t%6")
+            .arg(name).arg(steps).arg(stepsPerSecond, 0, 'f', 2)
+            .arg(newtonIterations).arg(luDecompositions).arg(memoryKb);
+    }
+
+    static bool fromLine(const QString &line, QString *name, BenchmarkResult *result) {
+        QStringList fields = line.split('\t');
+        if (line.startsWith('#') || fields.size() < 6) {
+            return false;
+        }
+        *name = fields[0];
+        result->steps = fields[1].toInt();
+        result->stepsPerSecond = fields[2].toDouble();
+        result->newtonIterations = fields[3].toULongLong();
+        result->luDecompositions = fields[4].toULongLong();
+        result->memoryKb = fields[5].toLong();
+        return true;
+    }
+
+    int steps;
+    double stepsPerSecond;
+    quint64 newtonIterations;
+    quint64 luDecompositions;
+    /// Growth of the resident memory while loading and simulating the circuit
+    long memoryKb;
+};
+
+
+class KtlSimBenchmarkFixture : public QObject {
+    Q_OBJECT
+
+public:
+    KApplication *app;
+    KTechlab *ktechlab;
+    KTempDir *generatedDir;
+    int stepCount;
+    double tolerance;
+    bool recording;
+    QString baselineError;
+    QMap<QString, BenchmarkResult> baseline;
+    QMap<QString, BenchmarkResult> results;
+
+private:
+    /** @return the resident memory of the process, or -1 if unknown */
+    static long residentMemoryKb() {
+        QFile statm("/proc/self/statm");
+        if (!statm.open(QIODevice::ReadOnly)) {
+            return -1;
+        }
+        const QList<QByteArray> fields = statm.readAll().split(' ');
+        if (fields.size() < 2) {
+            return -1;
+        }
+        return fields[1].toLong() * (sysconf(_SC_PAGESIZE) / 1024);
+    }
+
+    void loadBaseline(const QString &fileName) {
+        QFile file(fileName);
+        if (!file.open(QIODevice::ReadOnly)) {
+            baselineError = "could not read benchmark baseline " + fileName;
+            return;
+        }
+        QTextStream stream(&file);
+        while (!stream.atEnd()) {
+            QString name;
+            BenchmarkResult result;
+            if (BenchmarkResult::fromLine(stream.readLine(), &name, &result)) {
+                baseline[name] = result;
+            }
+        }
+    }
+
+    void addGenerated(const QString &name, const CircuitWriter &writer) {
+        QString fileName = generatedDir->name() + name + ".circuit";
+        QVERIFY(writer.save(fileName));
+        QTest::newRow(name.toLatin1().constData()) << fileName;
+    }
+
+    BenchmarkResult simulate(const QString &fileName) {
+        BenchmarkResult result;
+
+        DocManager::self()->closeAll();
+        const long memoryBefore = residentMemoryKb();
+        Document *doc = DocManager::self()->openURL(KUrl(fileName), NULL);
+        CircuitDocument *circDoc = dynamic_cast<CircuitDocument*>(doc);
+        if (!circDoc) {
+            return result;
+        }
+
+        // Build the circuits now rather than waiting for the document's timer
+        QMetaObject::invokeMethod(circDoc, "assignCircuits");
+
+        // Drive the simulator ourselves, so that the number of steps doesn't
+        // depend on how fast the event loop runs.
+        Simulator *simulator = Simulator::self();
+        simulator->slotSetSimulating(false);
+
+        SimulationProfiler *profiler = SimulationProfiler::self();
+        profiler->reset();
+        profiler->setEnabled(true);
+
+        QElapsedTimer timer;
+        timer.start();
+        simulator->runSteps(stepCount);
+        qint64 elapsed = timer.nsecsElapsed();
+
+        profiler->setEnabled(false);
+
+        result.steps = stepCount;
+        result.stepsPerSecond = elapsed > 0 ? stepCount * 1e9 / elapsed : 0.0;
+        const QVector<quint64> iterations = profiler->newtonIterations();
+        for (int i = 0; i < iterations.size(); ++i) {
+            result.newtonIterations += i * iterations[i];
+        }
+        result.luDecompositions = profiler->luDecompositions();
+        const long memoryAfter = residentMemoryKb();
+        result.memoryKb = (memoryBefore < 0 || memoryAfter < 0) ? -1 : memoryAfter - memoryBefore;
+
+        DocManager::self()->closeAll();
+        return result;
+    }
+
+private slots:
+    void initTestCase() {
+        int argc = 1;
+        char argv0[] = "benchmark_sim";
+        char *argv[] = { argv0, NULL };
+
+        KAboutData about(QByteArray("ktechlab"), QByteArray("ktechlab"), ki18n("KTechLab"), VERSION, ki18n(description),
+                    KAboutData::License_GPL, ki18n("(C) 2003-2017, The KTechLab developers"),
+                    KLocalizedString(), "https://userbase.kde.org/KTechlab", "ktechlab-devel@kde.org" );
+        KCmdLineArgs::init(argc, argv, &about);
+        app = new KApplication;
+        ktechlab = new KTechlab;
+        generatedDir = new KTempDir;
+
+        bool ok = false;
+        stepCount = qgetenv("KTL_BENCHMARK_STEPS").toInt(&ok);
+        if (!ok || stepCount <= 0) {
+            stepCount = 200;
+        }
+        tolerance = qgetenv("KTL_BENCHMARK_TOLERANCE").toDouble(&ok);
+        if (!ok || tolerance < 0) {
+            tolerance = 0.2;
+        }
+
+        recording = !qgetenv("KTL_BENCHMARK_OUTPUT").isEmpty();
+
+        QString baselineFile = QString::fromLocal8Bit(qgetenv("KTL_BENCHMARK_BASELINE"));
+        if (baselineFile.isEmpty()) {
+            baselineFile = SRC_TESTS_DATA_DIR "benchmark-baseline.tsv";
+        }
+        loadBaseline(baselineFile);
+    }
+
+    void cleanupTestCase() {
+        QString output;
+        QTextStream stream(&output);
+        stream << resultHeader << "\n";
+        for (QMap<QString, BenchmarkResult>::const_iterator it = results.begin(); it != results.end(); ++it) {
+            stream << it.value().toLine(it.key()) << "\n";
+        }
+        stream.flush();
+
+        // Always print the results, so that they can be picked up from the log
+        QTextStream(stdout) << output;
+
+        QString outputFile = QString::fromLocal8Bit(qgetenv("KTL_BENCHMARK_OUTPUT"));
+        if (!outputFile.isEmpty()) {
+            QFile file(outputFile);
+            if (file.open(QIODevice::WriteOnly)) {
+                file.write(output.toLocal8Bit());
+            } else {
+                qWarning() << "could not write benchmark results to" << outputFile;
+            }
+        }
+
+        delete generatedDir;
+        generatedDir = NULL;
+        delete ktechlab;
+        ktechlab = NULL;
+        //delete app; // this crashes apparently
+        app = NULL;
+    }
+
+    void benchmarkCircuit_data() {
+        QTest::addColumn<QString>("fileName");
+
+        QStringList examples;
+        QDirIterator it(SRC_EXAMPLES_DIR, QStringList("*.circuit"), QDir::Files, QDirIterator::Subdirectories);
+        while (it.hasNext()) {
+            examples << it.next();
+        }
+        examples.sort();
+        const QDir examplesDir(SRC_EXAMPLES_DIR);
+        foreach (const QString &fileName, examples) {
+            QString name = "examples/" + examplesDir.relativeFilePath(fileName);
+            QTest::newRow(name.toLatin1().constData()) << fileName;
+        }
+
+        const int ladderStages[] = { 10, 100, 1000 };
+        for (unsigned i = 0; i < sizeof(ladderStages) / sizeof(ladderStages[0]); ++i) {
+            addGenerated(QString("rc_ladder_%1").arg(ladderStages[i]), rcLadder(ladderStages[i]));
+        }
+
+        const int matrixSizes[] = { 4, 8, 16 };
+        for (unsigned i = 0; i < sizeof(matrixSizes) / sizeof(matrixSizes[0]); ++i) {
+            int n = matrixSizes[i];
+            addGenerated(QString("led_matrix_%1x%2").arg(n).arg(n), ledMatrix(n, n));
+        }
+
+        const int counterBits[] = { 4, 16, 64 };
+        for (unsigned i = 0; i < sizeof(counterBits) / sizeof(counterBits[0]); ++i) {
+            addGenerated(QString("ripple_counter_%1").arg(counterBits[i]), rippleCounter(counterBits[i]));
+            addGenerated(QString("binary_counter_%1").arg(counterBits[i]), binaryCounter(counterBits[i]));
+        }
+    }
+
+    void benchmarkCircuit() {
+        QFETCH(QString, fileName);
+        const QString name = QTest::currentDataTag();
+
+        BenchmarkResult result = simulate(fileName);
+        QVERIFY2(result.steps == stepCount, qPrintable("could not open " + fileName));
+        results[name] = result;
+
+        if (!recording) {
+            QVERIFY2(baselineError.isEmpty(), qPrintable(baselineError));
+        }
+        if (!baseline.contains(name)) {
+            // Nothing to compare against yet; the result is still printed
+            // and recorded
+            if (!recording) {
+                QSKIP(qPrintable("no baseline for " + name
+                      + "; record one by running with KTL_BENCHMARK_OUTPUT set"), SkipSingle);
+            }
+            return;
+        }
+        const BenchmarkResult &expected = baseline[name];
+
+        // Speed is compared relative to steps/s, as the baseline may have been
+        // recorded with a different step count.
+        QVERIFY2(result.stepsPerSecond >= expected.stepsPerSecond * (1.0 - tolerance),
+                 qPrintable(QString("%1 steps/s, baseline %2").arg(result.stepsPerSecond).arg(expected.stepsPerSecond)));
+
+        // The solver work is deterministic, so only compare it for the same step count
+        if (expected.steps == result.steps) {
+            QVERIFY2(result.newtonIterations <= expected.newtonIterations * (1.0 + tolerance),
+                     qPrintable(QString("%1 Newton iterations, baseline %2").arg(result.newtonIterations).arg(expected.newtonIterations)));
+            QVERIFY2(result.luDecompositions <= expected.luDecompositions * (1.0 + tolerance),
+                     qPrintable(QString("%1 LU decompositions, baseline %2").arg(result.luDecompositions).arg(expected.luDecompositions)));
+        }
+    }
+};
+
+QTEST_MAIN(KtlSimBenchmarkFixture)
+#include "benchmark_sim.moc"
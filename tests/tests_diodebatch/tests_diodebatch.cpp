@@ -0,0 +1,106 @@
+/*
+ * KTechLab: An IDE for microcontrollers and electronics
+ * Copyright 2026  The KTechLab developers
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of
+ * the License or (at your option) version 3 or any later version
+ * accepted by the membership of KDE e.V. (or its successor approved
+ * by the membership of KDE e.V.), which shall act as a proxy
+ * defined in Section 14 of version 3 of the license.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "electronics/simulation/diodebatch.h"
+
+#include <qnumeric.h>
+#include <qtest.h>
+
+#include <cmath>
+#include <vector>
+
+static const double EXP_MIN = -708.;
+static const double EXP_MAX = 709.;
+static const double MAX_RELATIVE_ERROR = 1e-15;
+
+class KtlTestsDiodeBatchFixture : public QObject {
+    Q_OBJECT
+
+private:
+    static double relativeError(double value, double expected) {
+        return std::abs(value - expected) / expected;
+    }
+
+private slots:
+    /**
+     * Both the vectorized path (used for pairs of values) and the scalar
+     * path agree with std::exp over the whole clamped range.
+     */
+    void testAccuracy() {
+        // An even count, so that every value goes through the pairs when
+        // SSE2 is available
+        const int count = 200000;
+        std::vector<double> x(count);
+        std::vector<double> y(count);
+        for (int i = 0; i < count; ++i) {
+            x[i] = EXP_MIN + (EXP_MAX - EXP_MIN) * i / (count - 1);
+        }
+
+        DiodeBatch::exp(&x[0], &y[0], count);
+
+        double maxBatchError = 0.;
+        double maxScalarError = 0.;
+        for (int i = 0; i < count; ++i) {
+            const double expected = std::exp(x[i]);
+            maxBatchError = qMax(maxBatchError, relativeError(y[i], expected));
+            maxScalarError = qMax(maxScalarError, relativeError(DiodeBatch::exp(x[i]), expected));
+        }
+        QVERIFY2(maxBatchError < MAX_RELATIVE_ERROR, QByteArray::number(maxBatchError));
+        QVERIFY2(maxScalarError < MAX_RELATIVE_ERROR, QByteArray::number(maxScalarError));
+    }
+
+    /** An odd count leaves the last value to the scalar path. */
+    void testOddCount() {
+        double x[3] = { -1., 0.5, 2. };
+        double y[3];
+        DiodeBatch::exp(x, y, 3);
+        for (int i = 0; i < 3; ++i) {
+            QVERIFY(relativeError(y[i], std::exp(x[i])) < MAX_RELATIVE_ERROR);
+        }
+        QCOMPARE(y[2], DiodeBatch::exp(x[2]));
+    }
+
+    /**
+     * Values outside the range give the exponential of the nearest end of
+     * it, rather than inf or zero as std::exp would.
+     */
+    void testClamping() {
+        double x[4] = { 750., -750., 1e10, -1e10 };
+        double y[4];
+        DiodeBatch::exp(x, y, 4);
+
+        const double expMax = std::exp(EXP_MAX);
+        const double expMin = std::exp(EXP_MIN);
+        QVERIFY(relativeError(y[0], expMax) < MAX_RELATIVE_ERROR);
+        QVERIFY(relativeError(y[1], expMin) < MAX_RELATIVE_ERROR);
+        QCOMPARE(y[2], y[0]);
+        QCOMPARE(y[3], y[1]);
+
+        QCOMPARE(DiodeBatch::exp(750.), DiodeBatch::exp(EXP_MAX));
+        QCOMPARE(DiodeBatch::exp(-750.), DiodeBatch::exp(EXP_MIN));
+        QVERIFY(relativeError(DiodeBatch::exp(750.), expMax) < MAX_RELATIVE_ERROR);
+        QVERIFY(!qIsInf(DiodeBatch::exp(1e10)));
+    }
+};
+
+QTEST_APPLESS_MAIN(KtlTestsDiodeBatchFixture)
+#include "tests_diodebatch.moc"
@@ -0,0 +1,216 @@
+/*
+ * KTechLab: An IDE for microcontrollers and electronics
+ * Copyright 2026  The KTechLab developers
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of
+ * the License or (at your option) version 3 or any later version
+ * accepted by the membership of KDE e.V. (or its successor approved
+ * by the membership of KDE e.V.), which shall act as a proxy
+ * defined in Section 14 of version 3 of the license.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "../src/ktechlab.h"
+#include "config.h"
+#include "docmanager.h"
+#include "mechanics/mechanicsdocument.h"
+#include "mechanics/mechanicsitem.h"
+#include "mechanics/mechanicssimulation.h"
+#include "simulator.h"
+
+#include <kaboutdata.h>
+#include <kapplication.h>
+#include <kcmdlineargs.h>
+#include <klocalizedstring.h>
+
+#include <qtest.h>
+
+#include <cmath>
+
+static const char description[] =
+    I18N_NOOP("An IDE for microcontrollers and electronics");
+
+class KtlTestsMechanicsFixture : public QObject {
+    Q_OBJECT
+
+public:
+    KApplication *app;
+    KTechlab *ktechlab;
+    MechanicsDocument *document;
+
+private:
+    MechanicsItem *addChassis(int x, int y) {
+        Item *item = document->addItem("mech/chassis_circular_2", QPoint(x, y), true);
+        return dynamic_cast<MechanicsItem*>(item);
+    }
+
+private slots:
+    void initTestCase() {
+        int argc = 1;
+        char argv0[] = "tests_mechanics";
+        char *argv[] = { argv0, NULL };
+
+        KAboutData about(QByteArray("ktechlab"), QByteArray("ktechlab"), ki18n("KTechLab"), VERSION, ki18n(description),
+                    KAboutData::License_GPL, ki18n("(C) 2003-2017, The KTechLab developers"),
+                    KLocalizedString(), "https://userbase.kde.org/KTechlab", "ktechlab-devel@kde.org" );
+        KCmdLineArgs::init(argc, argv, &about);
+        app = new KApplication;
+        ktechlab = new KTechlab;
+
+        // The tests step the bodies themselves
+        Simulator::self()->slotSetSimulating(false);
+    }
+    void cleanupTestCase() {
+        delete ktechlab;
+        ktechlab = NULL;
+        //delete app; // this crashes apparently
+        app = NULL;
+    }
+
+    void init() {
+        DocManager::self()->closeAll();
+        document = DocManager::self()->createMechanicsDocument();
+        QVERIFY(document != NULL);
+    }
+    void cleanup() {
+        DocManager::self()->closeAll();
+        document = NULL;
+    }
+
+    /**
+     * A constant force on a body damped by friction with the floor, which
+     * has the solution v(t) = (a/c)(1 - e^-ct), x(t) = (a/c)(t - (1 - e^-ct)/c)
+     * for an acceleration a and damping rate c.
+     */
+    void testConstantForce() {
+        MechanicsItem *chassis = addChassis(100, 100);
+        QVERIFY(chassis != NULL);
+
+        RigidBody body(document);
+        QVERIFY(body.addMechanicsItem(chassis));
+        body.updateRigidBodyInfo();
+        QVERIFY(body.mass() > 0.);
+
+        const double force = 1000.;
+        const double a = force / body.mass();
+        const double c = RigidBody::linearDamping;
+        const double x0 = chassis->absolutePosition().x();
+        const double y0 = chassis->absolutePosition().y();
+
+        for (int i = 0; i < MECHANICS_UPDATE_RATE; ++i) {
+            body.applyForce(Vector2D(force, 0.), Vector2D());
+            body.integrate(MECHANICS_UPDATE_PERIOD);
+        }
+        QVERIFY(body.isAwake());
+
+        const double t = 1.;
+        const double decay = 1. - std::exp(-c * t);
+        const double expectedV = (a / c) * decay;
+        const double expectedX = (a / c) * (t - decay / c);
+
+        QVERIFY(std::abs(body.velocity().x - expectedV) < 0.01 * expectedV);
+        QVERIFY(std::abs(chassis->absolutePosition().x() - x0 - expectedX) < 0.01 * expectedX);
+        QCOMPARE(chassis->absolutePosition().y(), y0);
+        QCOMPARE(body.angularVelocity(), 0.);
+    }
+
+    /** Without forces, a body comes to rest and falls asleep. */
+    void testSleep() {
+        MechanicsItem *chassis = addChassis(100, 100);
+        RigidBody body(document);
+        body.addMechanicsItem(chassis);
+        body.updateRigidBodyInfo();
+
+        body.setVelocity(Vector2D(10., 0.));
+        for (int i = 0; i < 10 * MECHANICS_UPDATE_RATE && body.isAwake(); ++i) {
+            body.integrate(MECHANICS_UPDATE_PERIOD);
+        }
+        QVERIFY(!body.isAwake());
+        QCOMPARE(body.velocity().x, 0.);
+    }
+
+    /** A chassis whose wheels are not driven applies nothing, so it sleeps. */
+    void testIdleChassisSleeps() {
+        MechanicsItem *chassis = addChassis(100, 100);
+        RigidBody body(document);
+        body.addMechanicsItem(chassis);
+        body.updateRigidBodyInfo();
+
+        body.setVelocity(Vector2D(10., 0.));
+        for (int i = 0; i < 10 * MECHANICS_UPDATE_RATE && body.isAwake(); ++i) {
+            body.applyForces(MECHANICS_UPDATE_PERIOD);
+            body.integrate(MECHANICS_UPDATE_PERIOD);
+        }
+        QVERIFY(!body.isAwake());
+    }
+
+    /** Two bodies approaching each other head on. */
+    void testCollision() {
+        MechanicsItem *chassisA = addChassis(100, 100);
+        MechanicsItem *chassisB = addChassis(250, 100);
+
+        RigidBody a(document);
+        a.addMechanicsItem(chassisA);
+        a.updateRigidBodyInfo();
+        RigidBody b(document);
+        b.addMechanicsItem(chassisB);
+        b.updateRigidBodyInfo();
+
+        const QRect rectA = a.boundingRect();
+        const QRect rectB = b.boundingRect();
+        QVERIFY(rectA.intersects(rectB));
+
+        a.setVelocity(Vector2D(100., 0.));
+        b.setVelocity(Vector2D(-100., 0.));
+        const double momentum = a.mass() * a.velocity().x + b.mass() * b.velocity().x;
+        const double approach = a.velocity().x - b.velocity().x;
+
+        MechanicsSimulation::collide(&a, rectA, &b, rectB);
+
+        // Momentum is conserved, and the bodies separate at the approach speed
+        // scaled by the restitution
+        const double momentumAfter = a.mass() * a.velocity().x + b.mass() * b.velocity().x;
+        QVERIFY(std::abs(momentumAfter - momentum) < 1e-9 * a.mass() * 100.);
+        const double separation = b.velocity().x - a.velocity().x;
+        QVERIFY(std::abs(separation - RigidBody::restitution * approach) < 1e-9 * approach);
+        QCOMPARE(a.velocity().y, 0.);
+        QCOMPARE(b.velocity().y, 0.);
+
+        // Bodies that are already moving apart are left alone
+        const Vector2D va = a.velocity();
+        MechanicsSimulation::collide(&a, rectA, &b, rectB);
+        QCOMPARE(a.velocity().x, va.x);
+
+        // As are bodies that do not touch
+        a.setVelocity(Vector2D(100., 0.));
+        b.setVelocity(Vector2D(-100., 0.));
+        MechanicsSimulation::collide(&a, rectA, &b, rectB.translated(1000, 0));
+        QCOMPARE(a.velocity().x, 100.);
+    }
+
+    /** Falling more than a quarter of a second behind skips the excess. */
+    void testDroppedTime() {
+        addChassis(100, 100);
+        MechanicsSimulation *simulation = document->mechanicsSimulation();
+        QVERIFY(simulation != NULL);
+
+        const long long start = simulation->time();
+        simulation->advanceTo(start + LOGIC_UPDATE_RATE);
+
+        QCOMPARE(simulation->time(), start + LOGIC_UPDATE_RATE);
+        QCOMPARE(simulation->droppedTime(), (long long)(LOGIC_UPDATE_RATE * 3 / 4));
+    }
+};
+
+QTEST_MAIN(KtlTestsMechanicsFixture)
+#include "tests_mechanics.moc"